@@ -116,6 +116,14 @@ SOURCE=..\..\src\audio\SDL_audio_c.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\audio\SDL_audiomatrix_c.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\audio\SDL_audioqueue_c.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\audio\SDL_audiocvt.c
 # End Source File
 # Begin Source File
@@ -380,6 +388,10 @@ SOURCE=..\..\src\file\SDL_rwops.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\file\SDL_asyncload.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\SDL_stretch.c
 # End Source File
 # Begin Source File
@@ -416,6 +428,10 @@ SOURCE=..\..\src\thread\generic\SDL_syscond.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\thread\generic\SDL_sysrwlock.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\video\wincommon\SDL_sysevents.c
 # End Source File
 # Begin Source File
@@ -484,6 +500,14 @@ SOURCE=..\..\src\thread\SDL_thread.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\thread\SDL_jobs.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\thread\SDL_atomic.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\thread\SDL_thread_c.h
 # End Source File
 # Begin Source File
@@ -508,6 +532,14 @@ SOURCE=..\..\src\audio\SDL_wave.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\audio\SDL_audiomatrix.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\src\audio\SDL_audioqueue.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\audio\SDL_wave.h
 # End Source File
 # Begin Source File
@@ -29,12 +29,15 @@
 
 #include "SDL_main.h"
 #include "SDL_stdinc.h"
+#include "SDL_asyncload.h"
+#include "SDL_atomic.h"
 #include "SDL_audio.h"
 #include "SDL_cdrom.h"
 #include "SDL_cpuinfo.h"
 #include "SDL_endian.h"
 #include "SDL_error.h"
 #include "SDL_events.h"
+#include "SDL_jobs.h"
 #include "SDL_loadso.h"
 #include "SDL_mutex.h"
 #include "SDL_rwops.h"
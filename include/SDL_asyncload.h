@@ -0,0 +1,141 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/** @file SDL_asyncload.h
+ *  Load and convert bitmaps, sounds and raw data on background threads
+ */
+
+#ifndef _SDL_asyncload_h
+#define _SDL_asyncload_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+#include "SDL_rwops.h"
+#include "SDL_audio.h"
+#include "SDL_video.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The SDL asynchronous load structure, defined in SDL_asyncload.c */
+struct SDL_AsyncLoad;
+typedef struct SDL_AsyncLoad SDL_AsyncLoad;
+
+/** Function called from the loading thread when a request completes */
+typedef void (SDLCALL *SDL_AsyncCallback)(SDL_AsyncLoad *load, void *userdata);
+
+/** @name Asynchronous load status */
+/*@{*/
+#define SDL_ASYNC_QUEUED	0	/**< Waiting for a loading thread */
+#define SDL_ASYNC_RUNNING	1	/**< Being loaded */
+#define SDL_ASYNC_DONE		2	/**< Loaded, the result can be taken */
+#define SDL_ASYNC_FAILED	3	/**< Failed, see SDL_GetAsyncError() */
+#define SDL_ASYNC_CANCELED	4	/**< Canceled before it was started */
+/*@}*/
+
+/** Description of what to load and how to report completion */
+typedef struct SDL_AsyncRequest {
+	/** The data to load, either a file name or an SDL_RWops.
+	 *  The SDL_RWops is used from the loading thread.
+	 */
+	const char *file;
+	SDL_RWops *src;
+	int freesrc;
+
+	/** Requests with a higher priority are started first */
+	int priority;
+
+	/** If not NULL, loaded bitmaps are converted with
+	 *  SDL_ConvertSurface(surface, format, flags).  The format is
+	 *  copied, so it doesn't need to stay valid after the request.
+	 */
+	const SDL_PixelFormat *format;
+	Uint32 flags;
+
+	/** If not NULL, loaded sounds are converted to the format,
+	 *  channels and freq of this audio spec.
+	 */
+	const SDL_AudioSpec *spec;
+
+	/** If not NULL, called from the loading thread on completion.
+	 *  The request must not be freed from the callback.
+	 */
+	SDL_AsyncCallback callback;
+	void *userdata;
+
+	/** If not zero, an SDL_UserEvent of this type is pushed on
+	 *  completion, with data1 set to the SDL_AsyncLoad and data2
+	 *  set to userdata.
+	 */
+	Uint8 event;
+} SDL_AsyncRequest;
+
+/** @name Queue a load request
+ *  Returns a handle to free with SDL_FreeAsync(), or NULL on error.
+ */
+/*@{*/
+extern DECLSPEC SDL_AsyncLoad * SDLCALL SDL_LoadBMPAsync(const SDL_AsyncRequest *request);
+extern DECLSPEC SDL_AsyncLoad * SDLCALL SDL_LoadWAVAsync(const SDL_AsyncRequest *request);
+extern DECLSPEC SDL_AsyncLoad * SDLCALL SDL_LoadFileAsync(const SDL_AsyncRequest *request);
+/*@}*/
+
+/** Get the current SDL_ASYNC_* status of a request */
+extern DECLSPEC int SDLCALL SDL_GetAsyncStatus(SDL_AsyncLoad *load);
+
+/** Cancel a request that hasn't been started yet.
+ *  Returns 0 if the request was canceled, or -1 if it was already started.
+ *  The callback isn't called and no event is pushed for canceled requests.
+ */
+extern DECLSPEC int SDLCALL SDL_CancelAsync(SDL_AsyncLoad *load);
+
+/** Wait for a request to complete, returns its final status */
+extern DECLSPEC int SDLCALL SDL_WaitAsync(SDL_AsyncLoad *load);
+
+/** Get the error message of a failed request */
+extern DECLSPEC const char * SDLCALL SDL_GetAsyncError(SDL_AsyncLoad *load);
+
+/** @name Take the result of a completed request
+ *  The caller owns the result afterwards, and frees it as if it had been
+ *  returned by SDL_LoadBMP_RW(), SDL_LoadWAV_RW() or allocated with
+ *  SDL_malloc(), respectively.  The result can only be taken once.
+ */
+/*@{*/
+extern DECLSPEC SDL_Surface * SDLCALL SDL_GetAsyncSurface(SDL_AsyncLoad *load);
+extern DECLSPEC SDL_AudioSpec * SDLCALL SDL_GetAsyncWAV(SDL_AsyncLoad *load, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len);
+extern DECLSPEC void * SDLCALL SDL_GetAsyncData(SDL_AsyncLoad *load, int *size);
+/*@}*/
+
+/** Free a request, canceling or waiting for it as needed.
+ *  Any result that wasn't taken is freed as well.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeAsync(SDL_AsyncLoad *load);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_asyncload_h */
@@ -0,0 +1,130 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/** @file SDL_atomic.h
+ *  Atomic operations, memory barriers and spinlocks
+ *
+ *  @note These use the compiler's atomic builtins when they are available,
+ *  and are emulated with an SDL_mutex otherwise.  Unless you know what
+ *  you're doing, use SDL_mutex, SDL_sem and SDL_cond instead.
+ */
+
+#ifndef _SDL_atomic_h
+#define _SDL_atomic_h
+
+#include "SDL_stdinc.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @name Spinlocks
+ *  A spinlock is an int that is 0 when unlocked.  Spinlocks should only
+ *  be held for a few instructions, since other threads busy wait on them.
+ */
+/*@{*/
+typedef int SDL_SpinLock;
+
+/** Try to lock a spinlock, returns SDL_TRUE if it was locked */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicTryLock(SDL_SpinLock *lock);
+
+/** Lock a spinlock, waiting until it is available */
+extern DECLSPEC void SDLCALL SDL_AtomicLock(SDL_SpinLock *lock);
+
+/** Unlock a spinlock, with release semantics */
+extern DECLSPEC void SDLCALL SDL_AtomicUnlock(SDL_SpinLock *lock);
+/*@}*/
+
+/** @name Memory barriers
+ *  The compiler barrier only keeps the compiler from reordering reads and
+ *  writes across it.  The release barrier makes the writes before it
+ *  visible to another thread before the writes after it, and the acquire
+ *  barrier pairs with it on the reading side.
+ */
+/*@{*/
+#if defined(__GNUC__)
+#define SDL_CompilerBarrier()	__asm__ __volatile__ ("" : : : "memory")
+#else
+#define SDL_CompilerBarrier()	\
+{ SDL_SpinLock _tmp = 0; SDL_AtomicLock(&_tmp); SDL_AtomicUnlock(&_tmp); }
+#endif
+
+extern DECLSPEC void SDLCALL SDL_MemoryBarrierRelease(void);
+extern DECLSPEC void SDLCALL SDL_MemoryBarrierAcquire(void);
+/*@}*/
+
+/** @name Atomic integers
+ *  The atomic operations have full memory barrier semantics, unless
+ *  noted otherwise.
+ */
+/*@{*/
+typedef struct { int value; } SDL_atomic_t;
+
+/** Set an atomic variable to 'newval' if it is currently 'oldval'.
+ *  @return SDL_TRUE if the value was set
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCAS(SDL_atomic_t *a, int oldval, int newval);
+
+/** Set an atomic variable to a value, returns the previous value */
+extern DECLSPEC int SDLCALL SDL_AtomicSet(SDL_atomic_t *a, int value);
+
+/** Get the value of an atomic variable, with acquire semantics */
+extern DECLSPEC int SDLCALL SDL_AtomicGet(SDL_atomic_t *a);
+
+/** Store a value in an atomic variable, with release semantics */
+extern DECLSPEC void SDLCALL SDL_AtomicStore(SDL_atomic_t *a, int value);
+
+/** Add to an atomic variable, returns the previous value */
+extern DECLSPEC int SDLCALL SDL_AtomicAdd(SDL_atomic_t *a, int value);
+
+/** Increment an atomic variable used as a reference count */
+#define SDL_AtomicIncRef(a)	SDL_AtomicAdd(a, 1)
+
+/** Decrement an atomic variable used as a reference count,
+ *  evaluates to SDL_TRUE if the variable reached zero.
+ */
+#define SDL_AtomicDecRef(a)	(SDL_AtomicAdd(a, -1) == 1)
+/*@}*/
+
+/** @name Atomic pointers */
+/*@{*/
+/** Set a pointer to 'newval' if it is currently 'oldval'.
+ *  @return SDL_TRUE if the pointer was set
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AtomicCASPtr(void **a, void *oldval, void *newval);
+
+/** Set a pointer to a value, returns the previous value */
+extern DECLSPEC void * SDLCALL SDL_AtomicSetPtr(void **a, void *value);
+
+/** Get the value of a pointer, with acquire semantics */
+extern DECLSPEC void * SDLCALL SDL_AtomicGetPtr(void **a);
+/*@}*/
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_atomic_h */
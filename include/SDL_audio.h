@@ -67,6 +67,8 @@ extern "C" {
  *     and SDL_UnlockAudio() in your code.
  * - 'desired->userdata' is passed as the first parameter to your callback
  *     function.
+ * - If 'desired->callback' is NULL, the audio is passed with
+ *     SDL_QueueAudio() or SDL_DequeueAudio() instead of a callback.
  *
  * @note The calculated values in this structure are calculated by SDL_OpenAudio()
  *
@@ -74,7 +76,7 @@ extern "C" {
 typedef struct SDL_AudioSpec {
 	int freq;		/**< DSP frequency -- samples per second */
 	Uint16 format;		/**< Audio data format */
-	Uint8  channels;	/**< Number of channels: 1 mono, 2 stereo */
+	Uint8  channels;	/**< Number of channels: 1 mono, 2 stereo, 4, 6 or 8 surround */
 	Uint8  silence;		/**< Audio buffer silence value (calculated) */
 	Uint16 samples;		/**< Audio buffer size in samples (power of 2) */
 	Uint16 padding;		/**< Necessary for some compile environments */
@@ -195,6 +197,16 @@ extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioStatus(void);
  */
 extern DECLSPEC void SDLCALL SDL_PauseAudio(int pause_on);
 
+/**
+ * Get the number of milliseconds of audio the device has been given to
+ * play since it was opened, counted in sample frames rather than read
+ * from a timer.  It doesn't advance while the device is busy, and it is
+ * deterministic with the "disk" audio driver, even in freerun mode where
+ * audio is produced faster than real time and the clock stops while the
+ * device is paused.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetAudioTicks(void);
+
 /**
  * This function loads a WAVE from the data source, automatically freeing
  * that source if 'freesrc' is non-zero.  For example, to load a WAVE file,
@@ -223,12 +235,58 @@ extern DECLSPEC SDL_AudioSpec * SDLCALL SDL_LoadWAV_RW(SDL_RWops *src, int frees
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 *audio_buf);
 
+/** The WAVE stream structure, defined in SDL_wave.c */
+struct SDL_WAVStream;
+typedef struct SDL_WAVStream SDL_WAVStream;
+
+/**
+ * This function opens a WAVE from the data source for decoding a piece at
+ * a time, instead of loading it all into memory with SDL_LoadWAV_RW().
+ * Only one encoded block of the data is kept in memory, so long files can
+ * be streamed from the audio callback.
+ *
+ * If this function succeeds, it fills 'spec' with the audio data format of
+ * the decoded data, and sets 'frames' (if not NULL) to the total number of
+ * sample frames in the stream.  The data source is closed along with the
+ * stream if 'freesrc' is non-zero, even if this function fails.
+ *
+ * @return The stream, or NULL if the data source isn't a supported WAVE.
+ */
+extern DECLSPEC SDL_WAVStream * SDLCALL SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec, Uint32 *frames);
+
+/**
+ * Decode up to 'len' bytes of audio data from the stream into 'buf',
+ * rounded down to a whole number of sample frames.
+ *
+ * @return The number of bytes decoded, 0 at the end of the stream, or -1
+ *         if there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadWAVStream(SDL_WAVStream *stream, void *buf, int len);
+
+/**
+ * Seek to a sample frame of the stream.  Seeking is sample accurate for
+ * ADPCM data, and needs a seekable data source.
+ *
+ * @return This function returns 0, or -1 if there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_SeekWAVStream(SDL_WAVStream *stream, Uint32 frame);
+
+/** Get the sample frame that will be decoded next */
+extern DECLSPEC Uint32 SDLCALL SDL_TellWAVStream(SDL_WAVStream *stream);
+
+/** Close a stream opened with SDL_OpenWAVStream_RW() */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream *stream);
+
 /**
  * This function takes a source format and rate and a destination format
  * and rate, and initializes the 'cvt' structure with information needed
  * by SDL_ConvertAudio() to convert a buffer of audio data from one format
  * to the other.
  *
+ * Multichannel frames are laid out as FL FR RL RR for 4 channels,
+ * FL FR C LFE RL RR for 6, and FL FR C LFE RL RR SL SR for 8.  Speakers
+ * missing from the destination are mixed into the nearest ones.
+ *
  * @return This function returns 0, or -1 if there was an error.
  */
 extern DECLSPEC int SDLCALL SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
@@ -257,6 +315,12 @@ extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT *cvt);
  */
 extern DECLSPEC void SDLCALL SDL_MixAudio(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
 
+/**
+ * This works like SDL_MixAudio(), but the audio format is given, so it
+ * can be used with the devices opened with SDL_OpenAudioDevice().
+ */
+extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 *dst, const Uint8 *src, Uint16 format, Uint32 len, int volume);
+
 /**
  * @name Audio Locks
  * The lock manipulated by these functions protects the callback function.
@@ -274,6 +338,150 @@ extern DECLSPEC void SDLCALL SDL_UnlockAudio(void);
  */
 extern DECLSPEC void SDLCALL SDL_CloseAudio(void);
 
+/**
+ * @name Audio Devices
+ * These functions open more than one audio device at a time, each with
+ * its own audio thread, callback and format conversion.  The device
+ * opened with SDL_OpenAudio() is the device with ID 1, and the functions
+ * without a device ID above work on it.
+ */
+/*@{*/
+typedef Uint32 SDL_AudioDeviceID;
+
+/** Where an audio device is playing or recording, see SDL_GetAudioDevicePosition() */
+typedef struct SDL_AudioPosition {
+	Uint32 frames;		/**< Sample frames handed to or read from the device so far */
+	Uint32 latency;		/**< Frames the device held when the last buffer was handed over */
+	Uint32 buffered;	/**< Frames queued and not played yet, or captured and not dequeued */
+	Uint32 timestamp;	/**< SDL_GetTicks() just after the last buffer was handed over */
+	Uint32 position;	/**< The frame being played or recorded now, estimated */
+} SDL_AudioPosition;
+
+/** The number of buckets in the callback time histogram */
+#define SDL_AUDIO_STATS_BUCKETS	8
+
+/**
+ * How an audio device's buffers have been keeping up, see
+ * SDL_GetAudioDeviceStats().  The times are in microseconds, and the
+ * counts and totals wrap around, so compare two snapshots to see what
+ * happened in between.
+ */
+typedef struct SDL_AudioStats {
+	Uint32 buffers;		/**< Buffers played or captured */
+	Uint32 underruns;	/**< Times the device ran dry, or overflowed when capturing */
+	Uint32 late;		/**< Callbacks that took longer than a buffer lasts */
+	Uint32 budget_us;	/**< How long a buffer lasts */
+	Uint32 callback_us;	/**< Total time spent in the callback, or with the queue */
+	Uint32 callback_max_us;	/**< The longest callback */
+	Uint32 convert_us;	/**< Total time spent converting the audio format */
+	/** Callbacks by the share of 'budget_us' they took, in equal steps,
+	    the last bucket also counts the late ones */
+	Uint32 histogram[SDL_AUDIO_STATS_BUCKETS];
+} SDL_AudioStats;
+
+/**
+ * Open an audio device of the current audio driver, like SDL_OpenAudio().
+ * 'device' is a driver specific name, such as an ALSA PCM name, a dsp
+ * device path, a PulseAudio sink or the output file of the "disk" driver,
+ * or NULL to use the same device as SDL_OpenAudio().  Drivers that can't
+ * run several devices at once only open one, counting SDL_OpenAudio().
+ *
+ * @return The ID of the device, which is at least 2, or 0 if it failed
+ */
+extern DECLSPEC SDL_AudioDeviceID SDLCALL SDL_OpenAudioDevice(const char *device, SDL_AudioSpec *desired, SDL_AudioSpec *obtained);
+
+/**
+ * Open an audio device for recording, like SDL_OpenAudioDevice().  The
+ * callback is passed the captured audio in the 'desired' format, unless
+ * 'obtained' is not NULL, and the device starts out paused.  Audio that
+ * is captured while the device is paused is dropped.
+ *
+ * Capture is supported by the "alsa", "pulse", "dsp" and "disk" drivers.
+ * The "disk" driver reads the file named by SDL_DISKAUDIOFILEIN, or the
+ * 'device' file, as raw audio or as a WAVE file.
+ *
+ * @return The ID of the device, which is at least 2, or 0 if it failed
+ */
+extern DECLSPEC SDL_AudioDeviceID SDLCALL SDL_OpenAudioCaptureDevice(const char *device, SDL_AudioSpec *desired, SDL_AudioSpec *obtained);
+extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioDeviceStatus(SDL_AudioDeviceID dev);
+extern DECLSPEC void SDLCALL SDL_PauseAudioDevice(SDL_AudioDeviceID dev, int pause_on);
+extern DECLSPEC Uint32 SDLCALL SDL_GetAudioDeviceTicks(SDL_AudioDeviceID dev);
+
+/**
+ * Get the hardware latency of a device: the number of sample frames that
+ * have been handed to the device and not played yet, or recorded by the
+ * device and not read yet.  It can be called from any thread.
+ *
+ * The "alsa", "pulse", "dsp", "disk" and "dummy" drivers report this.
+ *
+ * @return The number of frames, or -1 if there was an error
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceDelay(SDL_AudioDeviceID dev);
+
+/**
+ * Get the playback or capture position of a device, for keeping other
+ * things like video in sync with the audio.  It can be called from any
+ * thread, and never waits for the audio thread.
+ *
+ * The frame counts are at the rate the device runs at, which is the rate
+ * in 'obtained' when the device was opened.  Drivers that can't tell their
+ * latency are assumed to hold one buffer.
+ *
+ * @return 0, or -1 if the device isn't open
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDevicePosition(SDL_AudioDeviceID dev, SDL_AudioPosition *pos);
+
+/**
+ * Get the timing statistics the audio thread keeps for a device.  They
+ * are always collected, and cost a few clock reads per buffer.  Underruns
+ * are counted by the "alsa", "pulse" and "dummy" drivers, and by "dsp"
+ * where OSS reports them.
+ *
+ * @return 0, or -1 if the device isn't open
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev, SDL_AudioStats *stats);
+
+extern DECLSPEC void SDLCALL SDL_LockAudioDevice(SDL_AudioDeviceID dev);
+extern DECLSPEC void SDLCALL SDL_UnlockAudioDevice(SDL_AudioDeviceID dev);
+extern DECLSPEC void SDLCALL SDL_CloseAudioDevice(SDL_AudioDeviceID dev);
+/*@}*/
+
+/**
+ * @name Queued Audio
+ * A device opened without a callback plays the audio queued with
+ * SDL_QueueAudio(), and silence when the queue runs dry.  A capture device
+ * opened without a callback queues the audio it records, to be read with
+ * SDL_DequeueAudio().  The queue is lock free, the audio thread never
+ * waits for the application.  The audio is queued in the format asked for
+ * when the device was opened, and converted on the audio thread.
+ *
+ * Each queue is written by one thread and read by another, so only one
+ * application thread at a time should queue or dequeue audio on a device.
+ * The device ID 1 is the device opened with SDL_OpenAudio().
+ */
+/*@{*/
+
+/**
+ * Queue more audio to play on a device.
+ *
+ * @return 0, or -1 if there was an error
+ */
+extern DECLSPEC int SDLCALL SDL_QueueAudio(SDL_AudioDeviceID dev, const void *data, Uint32 len);
+
+/**
+ * Read up to 'len' bytes of recorded audio from a capture device.
+ *
+ * @return The number of bytes read, which is 0 if nothing is queued
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_DequeueAudio(SDL_AudioDeviceID dev, void *data, Uint32 len);
+
+/** Get the number of bytes of audio queued on a device */
+extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(SDL_AudioDeviceID dev);
+
+/** Drop all of the audio queued on a device */
+extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(SDL_AudioDeviceID dev);
+/*@}*/
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
@@ -36,6 +36,44 @@
 extern "C" {
 #endif
 
+/** @name CPU Features
+ *  The CPU feature bits for SDL_SetCPUFeatureMask()
+ */
+/*@{*/
+#define SDL_CPU_RDTSC		0x00000001
+#define SDL_CPU_MMX		0x00000002
+#define SDL_CPU_MMXEXT		0x00000004
+#define SDL_CPU_3DNOW		0x00000010
+#define SDL_CPU_3DNOWEXT	0x00000020
+#define SDL_CPU_SSE		0x00000040
+#define SDL_CPU_SSE2		0x00000080
+#define SDL_CPU_ALTIVEC		0x00000100
+#define SDL_CPU_ARM_SIMD	0x00000200
+#define SDL_CPU_NEON		0x00000400
+#define SDL_CPU_SSE3		0x00000800
+#define SDL_CPU_SSSE3		0x00001000
+#define SDL_CPU_SSE41		0x00002000
+#define SDL_CPU_SSE42		0x00004000
+#define SDL_CPU_AVX		0x00008000
+#define SDL_CPU_AVX2		0x00010000
+#define SDL_CPU_FMA		0x00020000
+#define SDL_CPU_AVX512F		0x00040000
+/*@}*/
+
+/** Restrict the CPU features reported by the SDL_Has*() functions, and
+ *  so the optimized code paths SDL picks, to those set in a mask of the
+ *  SDL_CPU_* bits.  This is useful to test or benchmark the fallbacks.
+ *
+ *  The initial mask can be set with the SDL_CPU_FEATURE_MASK environment
+ *  variable, e.g. SDL_CPU_FEATURE_MASK=0 to use only the C code.
+ *  Surfaces that have already been blitted keep their blit functions
+ *  until they are blitted to a different surface.
+ */
+extern DECLSPEC void SDLCALL SDL_SetCPUFeatureMask(Uint32 mask);
+
+/** Returns the mask set with SDL_SetCPUFeatureMask() */
+extern DECLSPEC Uint32 SDLCALL SDL_GetCPUFeatureMask(void);
+
 /** This function returns true if the CPU has the RDTSC instruction */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasRDTSC(void);
 
@@ -60,6 +98,51 @@ extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE2(void);
 /** This function returns true if the CPU has AltiVec features */
 extern DECLSPEC SDL_bool SDLCALL SDL_HasAltiVec(void);
 
+/** This function returns true if the CPU has SSE3 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE3(void);
+
+/** This function returns true if the CPU has SSSE3 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSSE3(void);
+
+/** This function returns true if the CPU has SSE4.1 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE41(void);
+
+/** This function returns true if the CPU has SSE4.2 features */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasSSE42(void);
+
+/** This function returns true if the CPU has AVX features and the OS
+ *  saves the AVX registers
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX(void);
+
+/** This function returns true if the CPU has AVX2 features and the OS
+ *  saves the AVX registers
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX2(void);
+
+/** This function returns true if the CPU has FMA3 features and the OS
+ *  saves the AVX registers
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasFMA(void);
+
+/** This function returns true if the CPU has AVX-512 Foundation features
+ *  and the OS saves the AVX-512 registers
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_HasAVX512F(void);
+
+/** This function returns the number of logical CPUs available */
+extern DECLSPEC int SDLCALL SDL_GetCPUCount(void);
+
+/** This function returns the L1 cache line size of the CPU in bytes,
+ *  or a safe guess if it can't be queried
+ */
+extern DECLSPEC int SDLCALL SDL_GetCPUCacheLineSize(void);
+
+/** This function returns the amount of RAM in the system in megabytes,
+ *  or 0 if it can't be queried
+ */
+extern DECLSPEC int SDLCALL SDL_GetSystemRAM(void);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
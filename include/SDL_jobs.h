@@ -0,0 +1,107 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+
+/** @file SDL_jobs.h
+ *  A pool of worker threads running small jobs
+ *
+ *  Each worker thread has its own queue of jobs, and takes jobs from the
+ *  queues of the other workers when it runs out.  Jobs queued from inside
+ *  a job go to the queue of the worker running it.
+ */
+
+#ifndef _SDL_jobs_h
+#define _SDL_jobs_h
+
+#include "SDL_stdinc.h"
+#include "SDL_error.h"
+
+#include "begin_code.h"
+/* Set up for C function definitions, even when using C++ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The SDL job pool structure, defined in SDL_jobs.c */
+struct SDL_JobPool;
+typedef struct SDL_JobPool SDL_JobPool;
+
+/** The SDL job structure, defined in SDL_jobs.c */
+struct SDL_Job;
+typedef struct SDL_Job SDL_Job;
+
+/** Function run by a job */
+typedef void (SDLCALL *SDL_JobFunc)(void *data);
+
+/** Function run on a part [start, end) of a range by SDL_ParallelFor() */
+typedef void (SDLCALL *SDL_ParallelForFunc)(void *data, int start, int end);
+
+/** Create a pool of worker threads.
+ *
+ *  @param[in] numthreads The number of workers, or 0 for one per CPU
+ *  @return The new pool, or NULL on error
+ */
+extern DECLSPEC SDL_JobPool * SDLCALL SDL_CreateJobPool(int numthreads);
+
+/** Wait for all the jobs of a pool to complete, and destroy it.
+ *  The default pool can't be destroyed, it goes away with SDL_Quit().
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobPool(SDL_JobPool *pool);
+
+/** Create a job running func(data) on a pool, or on the default pool if
+ *  'pool' is NULL.  The job is run once all of its dependencies have
+ *  completed, or right away if it has none.
+ *
+ *  The returned handle must be released with SDL_ReleaseJob(), which can
+ *  be done right away if the job doesn't need to be waited for.
+ *
+ *  @param[in] dependencies Jobs that must complete before this one runs
+ *  @return The new job, or NULL on error
+ */
+extern DECLSPEC SDL_Job * SDLCALL SDL_CreateJob(SDL_JobPool *pool, SDL_JobFunc func, void *data, SDL_Job **dependencies, int numdependencies);
+
+/** Returns 1 if a job has completed, or 0 if it hasn't */
+extern DECLSPEC int SDLCALL SDL_IsJobDone(SDL_Job *job);
+
+/** Wait for a job to complete.  The calling thread runs other jobs of the
+ *  pool while it waits, so this can be called from inside a job.
+ */
+extern DECLSPEC void SDLCALL SDL_WaitJob(SDL_Job *job);
+
+/** Release a job handle returned by SDL_CreateJob() */
+extern DECLSPEC void SDLCALL SDL_ReleaseJob(SDL_Job *job);
+
+/** Call func(data, start, end) on parts of the range [start, end) from
+ *  the worker threads of a pool and the calling thread, and wait for the
+ *  whole range to be done.
+ *
+ *  @param[in] grain The size of the parts, or 0 to pick one
+ *  @return 0, or -1 if there was an error
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(SDL_JobPool *pool, int start, int end, int grain, SDL_ParallelForFunc func, void *data);
+
+/* Ends C function definitions when using C++ */
+#ifdef __cplusplus
+}
+#endif
+#include "close_code.h"
+
+#endif /* _SDL_jobs_h */
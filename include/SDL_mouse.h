@@ -38,6 +38,7 @@ extern "C" {
 #endif
 
 typedef struct WMcursor WMcursor;	/**< Implementation dependent */
+typedef struct SDL_ColorCursor SDL_ColorCursor;	/**< Internal */
 typedef struct SDL_Cursor {
 	SDL_Rect area;			/**< The area of the mouse cursor */
 	Sint16 hot_x, hot_y;		/**< The "tip" of the cursor */
@@ -45,6 +46,7 @@ typedef struct SDL_Cursor {
 	Uint8 *mask;			/**< B/W cursor mask */
 	Uint8 *save[2];			/**< Place to save cursor area */
 	WMcursor *wm_cursor;		/**< Window-manager cursor */
+	SDL_ColorCursor *color;		/**< Full colour cursor image */
 } SDL_Cursor;
 
 /* Function prototypes */
@@ -85,6 +87,19 @@ extern DECLSPEC void SDLCALL SDL_WarpMouse(Uint16 x, Uint16 y);
 extern DECLSPEC SDL_Cursor * SDLCALL SDL_CreateCursor
 		(Uint8 *data, Uint8 *mask, int w, int h, int hot_x, int hot_y);
 
+/**
+ * Create a full colour cursor from a surface, using its alpha channel
+ * for translucency.  The image is copied, so the surface can be freed
+ * afterwards.
+ *
+ * Colour cursors are always drawn in software, alpha blended over the
+ * screen from a copy of the image kept in the display format.
+ *
+ * Cursors created with this function must be freed with SDL_FreeCursor().
+ */
+extern DECLSPEC SDL_Cursor * SDLCALL SDL_CreateColorCursor
+		(SDL_Surface *surface, int hot_x, int hot_y);
+
 /**
  * Set the currently active cursor to the specified one.
  * If the cursor is currently visible, the change will be immediately 
@@ -98,7 +113,8 @@ extern DECLSPEC void SDLCALL SDL_SetCursor(SDL_Cursor *cursor);
 extern DECLSPEC SDL_Cursor * SDLCALL SDL_GetCursor(void);
 
 /**
- * Deallocates a cursor created with SDL_CreateCursor().
+ * Deallocates a cursor created with SDL_CreateCursor() or
+ * SDL_CreateColorCursor().
  */
 extern DECLSPEC void SDLCALL SDL_FreeCursor(SDL_Cursor *cursor);
 
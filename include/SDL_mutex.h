@@ -73,11 +73,69 @@ extern DECLSPEC int SDLCALL SDL_mutexP(SDL_mutex *mutex);
  */
 extern DECLSPEC int SDLCALL SDL_mutexV(SDL_mutex *mutex);
 
+/** Try to lock the mutex without blocking
+ *  @return 0, SDL_MUTEX_TIMEDOUT if another thread holds the mutex,
+ *  or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockMutex(SDL_mutex *mutex);
+
+/** Variant of SDL_mutexP() with a timeout in milliseconds, returns 0 if
+ *  the mutex was locked, SDL_MUTEX_TIMEDOUT if it could not be locked in
+ *  the allotted time, and -1 on error.
+ *
+ *  On some platforms this function is implemented by looping with a delay
+ *  of 1 ms, and so should be avoided if possible.
+ */
+extern DECLSPEC int SDLCALL SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms);
+
 /** Destroy a mutex */
 extern DECLSPEC void SDLCALL SDL_DestroyMutex(SDL_mutex *mutex);
 
 /*@}*/
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/** @name Reader-writer lock functions                           */ /*@{*/
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/** The SDL reader-writer lock structure, defined in SDL_sysrwlock.c
+ *
+ *  Any number of threads can hold the lock for reading at the same time,
+ *  while a thread holding it for writing excludes all others.  Unlike
+ *  mutexes, reader-writer locks can't be locked recursively.
+ */
+struct SDL_rwlock;
+typedef struct SDL_rwlock SDL_rwlock;
+
+/** Create a reader-writer lock, initialized unlocked */
+extern DECLSPEC SDL_rwlock * SDLCALL SDL_CreateRWLock(void);
+
+/** Lock for reading, waiting while a writer holds the lock
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_rwlock *rwlock);
+
+/** Lock for writing, waiting until no other thread holds the lock
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_rwlock *rwlock);
+
+/** Non-blocking variants of SDL_LockRWLockForReading() and
+ *  SDL_LockRWLockForWriting().
+ *  @return 0, SDL_MUTEX_TIMEDOUT if the lock would block, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_rwlock *rwlock);
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_rwlock *rwlock);
+
+/** Unlock a reader-writer lock held by the current thread
+ *  @return 0, or -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_rwlock *rwlock);
+
+/** Destroy a reader-writer lock */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_rwlock *rwlock);
+
+/*@}*/
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /** @name Semaphore functions                                    */ /*@{*/
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -102,9 +102,39 @@ extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromFile(const char *file, const char
 extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromFP(FILE *fp, int autoclose);
 #endif
 
+/** Open a file read-only by mapping it into memory, when the platform
+ *  supports it.  The mapped pages can be accessed directly through
+ *  SDL_RWGetMemory(), and are shared with other processes mapping the
+ *  same file.  Falls back to SDL_RWFromFile(file, "rb") otherwise.
+ */
+extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromMappedFile(const char *file);
+
 extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromConstMem(const void *mem, int size);
 
+/** Get the memory area backing an SDL_RWops created by SDL_RWFromMem(),
+ *  SDL_RWFromConstMem() or SDL_RWFromMappedFile(), so data can be used
+ *  in place without copying it.  The current position in the area is
+ *  given by SDL_RWtell().  The memory is valid until the SDL_RWops is
+ *  closed, and must not be written to.
+ *
+ *  @param[out] size The total size of the memory area, may be NULL
+ *  @return The start of the memory area, or NULL if the SDL_RWops isn't
+ *          backed by memory.
+ */
+extern DECLSPEC const void * SDLCALL SDL_RWGetMemory(SDL_RWops *context, int *size);
+
+/** Wrap an SDL_RWops in a read buffer, so many small reads don't each
+ *  go through the wrapped source.  Writes go straight to the source.
+ *
+ *  @param[in] freesrc If nonzero, 'src' is closed along with the wrapper
+ *  @param[in] bufsize The size of the read buffer, or 0 for the default
+ *  @param[in] readahead If nonzero, a thread reads the next block of the
+ *             source while the current one is consumed.  Only use this
+ *             if the source can be read from another thread.
+ */
+extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromBuffered(SDL_RWops *src, int freesrc, int bufsize, int readahead);
+
 extern DECLSPEC SDL_RWops * SDLCALL SDL_AllocRW(void);
 extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops *area);
 
@@ -136,6 +166,16 @@ extern DECLSPEC Uint64 SDLCALL SDL_ReadLE64(SDL_RWops *src);
 extern DECLSPEC Uint64 SDLCALL SDL_ReadBE64(SDL_RWops *src);
 /*@}*/
 
+/** @name Read an array of items of the specified endianness in native format
+ *  Returns the number of items read.
+ */
+/*@{*/
+extern DECLSPEC int SDLCALL SDL_ReadLE16Array(SDL_RWops *src, Uint16 *values, int num);
+extern DECLSPEC int SDLCALL SDL_ReadBE16Array(SDL_RWops *src, Uint16 *values, int num);
+extern DECLSPEC int SDLCALL SDL_ReadLE32Array(SDL_RWops *src, Uint32 *values, int num);
+extern DECLSPEC int SDLCALL SDL_ReadBE32Array(SDL_RWops *src, Uint32 *values, int num);
+/*@}*/
+
 /** @name Write an item of native format to the specified endianness */
 /*@{*/
 extern DECLSPEC int SDLCALL SDL_WriteLE16(SDL_RWops *dst, Uint16 value);
@@ -108,6 +108,61 @@ extern DECLSPEC void SDLCALL SDL_WaitThread(SDL_Thread *thread, int *status);
 /** Forcefully kill a thread without worrying about its state */
 extern DECLSPEC void SDLCALL SDL_KillThread(SDL_Thread *thread);
 
+/** Thread scheduling priorities */
+typedef enum {
+	SDL_THREAD_PRIORITY_LOW,
+	SDL_THREAD_PRIORITY_NORMAL,
+	SDL_THREAD_PRIORITY_HIGH,	/**< Used for the audio and timer threads */
+	SDL_THREAD_PRIORITY_TIME_CRITICAL
+} SDL_ThreadPriority;
+
+/** Set the scheduling priority of the current thread.
+ *
+ *  Where the system allows it, the high priorities use real-time
+ *  scheduling (SCHED_RR and SCHED_FIFO on POSIX systems).  Otherwise the
+ *  thread gets the highest priority the process is permitted to use.
+ *
+ *  @return 0 on success, -1 if the priority couldn't be set
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadPriority(SDL_ThreadPriority priority);
+
+/** Set the name of the current thread, as shown by debuggers and system
+ *  tools.  The name may be truncated, to 15 characters on Linux.
+ *
+ *  @return 0 on success, -1 if threads can't be named on this platform
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadName(const char *name);
+
+/** Restrict the current thread to run on a set of CPUs.
+ *
+ *  @param[in] cpumask Bit n is set to allow CPU n, 0 allows all CPUs
+ *  @return 0 on success, -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_SetThreadAffinity(Uint32 cpumask);
+
+/** Thread local storage ID, 0 is the invalid ID */
+typedef unsigned int SDL_TLSID;
+
+/** Create an identifier that is globally visible to all threads but
+ *  refers to data that is thread-specific.
+ *
+ *  @return The newly created thread local storage identifier, or 0 on error
+ */
+extern DECLSPEC SDL_TLSID SDLCALL SDL_TLSCreate(void);
+
+/** Get the value associated with a thread local storage ID for the
+ *  current thread, or NULL if no value has been set.
+ */
+extern DECLSPEC void * SDLCALL SDL_TLSGet(SDL_TLSID id);
+
+/** Set the value associated with a thread local storage ID for the
+ *  current thread.  The destructor, if not NULL, is called with the value
+ *  when the thread exits.
+ *
+ *  @return 0 on success, -1 on error
+ */
+extern DECLSPEC int SDLCALL SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void*));
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
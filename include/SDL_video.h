@@ -592,6 +592,19 @@ extern DECLSPEC SDL_Surface * SDLCALL SDL_LoadBMP_RW(SDL_RWops *src, int freesrc
 /** Convenience macro -- load a surface from a file */
 #define SDL_LoadBMP(file)	SDL_LoadBMP_RW(SDL_RWFromFile(file, "rb"), 1)
 
+/**
+ * Load a surface from a seekable SDL data source and return it in the
+ * given pixel format, as if converted with SDL_ConvertSurface(surface,
+ * fmt, flags).  Uncompressed 1, 4, 8, 24 and 32 bpp images are decoded
+ * straight into 16 and 32 bpp software surfaces, other images are loaded
+ * and then converted.  If 'fmt' is NULL, the surface is returned in the
+ * display format as if converted with SDL_DisplayFormat(), and 'flags'
+ * is ignored.
+ * Returns the new surface, or NULL if there was an error.
+ */
+extern DECLSPEC SDL_Surface * SDLCALL SDL_LoadBMPFormat_RW(SDL_RWops *src,
+		int freesrc, const SDL_PixelFormat *fmt, Uint32 flags);
+
 /**
  * Save a surface to a seekable SDL data source (memory or file.)
  * If 'freedst' is non-zero, the source will be closed after being written.
@@ -756,6 +769,18 @@ extern DECLSPEC int SDLCALL SDL_LowerBlit
 			(SDL_Surface *src, SDL_Rect *srcrect,
 			 SDL_Surface *dst, SDL_Rect *dstrect);
 
+/** Returns the name of the low level function SDL uses to blit 'src' onto
+ *  'dst', e.g. "BlitRGBtoRGBPixelAlphaMMX", or "hardware" for accelerated
+ *  blits.  This is useful to check which of the CPU optimized blitters
+ *  was picked, see SDL_SetCPUFeatureMask().
+ *
+ *  This sets up the blit the same way SDL_BlitSurface() does.
+ *
+ *  @return The name, or NULL if the surfaces can't be blitted
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetBlitName
+			(SDL_Surface *src, SDL_Surface *dst);
+
 /**
  * This function performs a fast fill of the given rectangle with 'color'
  * The given rectangle is clipped to the destination surface clip area
@@ -48,6 +48,9 @@ extern int  SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 #endif
 
+extern void SDL_AsyncLoadQuit(void);
+extern void SDL_JobsQuit(void);
+
 /* The current SDL version */
 static SDL_version version = 
 	{ SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL };
@@ -219,6 +222,8 @@ void SDL_Quit(void)
 #ifdef DEBUG_BUILD
   printf("[SDL_Quit] : Enter! Calling QuitSubSystem()\n"); fflush(stdout);
 #endif
+	SDL_AsyncLoadQuit();
+	SDL_JobsQuit();
 	SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
 #ifdef CHECK_LEAKS
@@ -26,8 +26,19 @@
 #include "SDL.h"
 #include "SDL_audio_c.h"
 #include "SDL_audiomem.h"
+#include "SDL_audioqueue_c.h"
 #include "SDL_sysaudio.h"
 
+#if defined(__WIN32__) && !defined(_WIN32_WCE)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif SDL_TIMER_UNIX
+#include <sys/time.h>
+#if HAVE_CLOCK_GETTIME || HAVE_CLOCK_MONOTONIC
+#include <time.h>
+#endif
+#endif
+
 /* Available audio drivers */
 static AudioBootStrap *bootstrap[] = {
 #if SDL_AUDIO_DRIVER_PULSE
@@ -116,19 +127,110 @@ static AudioBootStrap *bootstrap[] = {
 };
 SDL_AudioDevice *current_audio = NULL;
 
+/* The driver picked by SDL_AudioInit(), used to create more devices */
+static AudioBootStrap *current_bootstrap = NULL;
+
+/* Devices opened with SDL_OpenAudioDevice(), indexed by ID-1.  The first
+   slot is never used, device 1 is always 'current_audio'.
+ */
+#define MAX_AUDIO_DEVICES	16
+static SDL_AudioDevice *open_devices[MAX_AUDIO_DEVICES];
+
+/* Devices can be opened and closed from different threads */
+static SDL_mutex *open_devices_lock = NULL;
+
 /* Various local functions */
 int SDL_AudioInit(const char *driver_name);
 void SDL_AudioQuit(void);
 
+/* A microsecond clock for the audio statistics, only differences count */
+static Uint32 SDL_GetAudioMicroTicks(void)
+{
+#if defined(__WIN32__) && !defined(_WIN32_WCE)
+	LARGE_INTEGER now, freq;
+
+	if ( QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now) ) {
+		/* Split the division so the counter can't overflow */
+		return((Uint32)((now.QuadPart / freq.QuadPart) * 1000000 +
+			((now.QuadPart % freq.QuadPart) * 1000000) / freq.QuadPart));
+	}
+	return(SDL_GetTicks() * 1000);
+#elif SDL_TIMER_UNIX && (HAVE_CLOCK_GETTIME || HAVE_CLOCK_MONOTONIC)
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((Uint32)(now.tv_sec * 1000000 + now.tv_nsec / 1000));
+#elif SDL_TIMER_UNIX
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return((Uint32)(now.tv_sec * 1000000 + now.tv_usec));
+#else
+	return(SDL_GetTicks() * 1000);
+#endif
+}
+
+/* Publish where the device is and how long the last buffer took, right
+   after it was played or read.  'mixed' is 0 if the callback wasn't run.
+ */
+static void SDL_UpdateAudioStatus(SDL_AudioDevice *audio, int mixed,
+				Uint32 callback_us, Uint32 convert_us)
+{
+	SDL_AudioStats *stats = &audio->stats;
+	int latency = -1;
+	Uint32 bucket;
+
+	if ( audio->GetDelay ) {
+		latency = audio->GetDelay(audio);
+	}
+	if ( latency < 0 ) {
+		/* Guess that the device holds the buffer just played */
+		latency = audio->iscapture ? 0 : audio->spec.samples;
+	}
+	bucket = SDL_AUDIO_STATS_BUCKETS-1;
+	if ( callback_us < stats->budget_us ) {
+		bucket = (callback_us * SDL_AUDIO_STATS_BUCKETS) / stats->budget_us;
+	}
+
+	SDL_AtomicLock(&audio->status_lock);
+	audio->position.frames += audio->spec.samples;
+	audio->position.latency = latency;
+	audio->position.timestamp = SDL_GetTicks();
+
+	++stats->buffers;
+	stats->underruns = audio->underruns;
+	stats->convert_us += convert_us;
+	if ( mixed ) {
+		stats->callback_us += callback_us;
+		if ( callback_us > stats->callback_max_us ) {
+			stats->callback_max_us = callback_us;
+		}
+		if ( callback_us > stats->budget_us ) {
+			++stats->late;
+		}
+		++stats->histogram[bucket];
+	}
+	SDL_AtomicUnlock(&audio->status_lock);
+}
+
 /* The general mixing thread function */
 int SDLCALL SDL_RunAudio(void *audiop)
 {
 	SDL_AudioDevice *audio = (SDL_AudioDevice *)audiop;
 	Uint8 *stream;
 	int    stream_len;
+	int    len;
 	void  *udata;
 	void (SDLCALL *fill)(void *userdata,Uint8 *stream, int len);
 	int    silence;
+	int    mixed;
+	int    paused;
+	Uint32 seconds, frames;
+	Uint32 start, callback_us, convert_us;
+
+	/* Raise the priority to avoid underruns, drivers can change it */
+	SDL_SetThreadName("SDLAudio");
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
 
 	/* Perform any thread setup */
 	if ( audio->ThreadInit ) {
@@ -151,10 +253,19 @@ int SDLCALL SDL_RunAudio(void *audiop)
 		silence = audio->spec.silence;
 		stream_len = audio->spec.size;
 	}
+	seconds = frames = 0;
 
 	/* Loop, filling the audio buffers */
 	while ( audio->enabled ) {
 
+		/* A device that isn't paced by real time plays nothing and
+		   keeps its clock still until it is unpaused */
+		paused = audio->paused;
+		if ( paused && audio->waitpaused ) {
+			SDL_Delay(10);
+			continue;
+		}
+
 		/* Fill the current buffer with sound */
 		if ( audio->convert.needed ) {
 			if ( audio->convert.buf ) {
@@ -169,17 +280,31 @@ int SDLCALL SDL_RunAudio(void *audiop)
 			}
 		}
 
-		SDL_memset(stream, silence, stream_len);
-
-		if ( ! audio->paused ) {
-			SDL_mutexP(audio->mixer_lock);
-			(*fill)(udata, stream, stream_len);
-			SDL_mutexV(audio->mixer_lock);
+		mixed = 0;
+		callback_us = convert_us = 0;
+		if ( paused ) {
+			SDL_memset(stream, silence, stream_len);
+		} else {
+			start = SDL_GetAudioMicroTicks();
+			if ( audio->queue ) {
+				/* Queued audio is read without the mixer lock */
+				len = SDL_ReadAudioQueue(audio->queue, stream, stream_len);
+				SDL_memset(stream+len, silence, stream_len-len);
+			} else {
+				SDL_memset(stream, silence, stream_len);
+				SDL_mutexP(audio->mixer_lock);
+				(*fill)(udata, stream, stream_len);
+				SDL_mutexV(audio->mixer_lock);
+			}
+			callback_us = SDL_GetAudioMicroTicks() - start;
+			mixed = 1;
 		}
 
 		/* Convert the audio if necessary */
 		if ( audio->convert.needed ) {
+			start = SDL_GetAudioMicroTicks();
 			SDL_ConvertAudio(&audio->convert);
+			convert_us = SDL_GetAudioMicroTicks() - start;
 			stream = audio->GetAudioBuf(audio);
 			if ( stream == NULL ) {
 				stream = audio->fake_stream;
@@ -191,6 +316,17 @@ int SDLCALL SDL_RunAudio(void *audiop)
 		/* Ready current buffer for play and change current buffer */
 		if ( stream != audio->fake_stream ) {
 			audio->PlayAudio(audio);
+			SDL_UpdateAudioStatus(audio, mixed,
+						callback_us, convert_us);
+
+			/* Advance the sample clock */
+			frames += audio->spec.samples;
+			while ( frames >= (Uint32)audio->spec.freq ) {
+				frames -= audio->spec.freq;
+				++seconds;
+			}
+			audio->ticks = seconds*1000 +
+					(frames*1000)/audio->spec.freq;
 		}
 
 		/* Wait for an audio buffer to become available */
@@ -209,6 +345,104 @@ int SDLCALL SDL_RunAudio(void *audiop)
 	return(0);
 }
 
+/* The general capture thread function */
+static int SDLCALL SDL_RunAudioCapture(void *audiop)
+{
+	SDL_AudioDevice *audio = (SDL_AudioDevice *)audiop;
+	Uint8 *stream;
+	int    stream_len;
+	int    len;
+	void  *udata;
+	void (SDLCALL *fill)(void *userdata,Uint8 *stream, int len);
+	Uint32 seconds, frames;
+	Uint32 start, callback_us, convert_us;
+
+	/* Raise the priority to avoid overruns, drivers can change it */
+	SDL_SetThreadName("SDLAudioCapture");
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+	/* Perform any thread setup */
+	if ( audio->ThreadInit ) {
+		audio->ThreadInit(audio);
+	}
+	audio->threadid = SDL_ThreadID();
+
+	/* Set up the mixing function */
+	fill  = audio->spec.callback;
+	udata = audio->spec.userdata;
+
+	/* Capture straight into the conversion buffer, if there is one */
+	if ( audio->convert.needed ) {
+		stream = audio->convert.buf;
+	} else {
+		stream = audio->fake_stream;
+	}
+	stream_len = audio->spec.size;
+	seconds = frames = 0;
+
+	/* Loop, reading the audio buffers */
+	while ( audio->enabled ) {
+
+		/* A device that isn't paced by real time reads nothing while
+		   it is paused, so no input is lost */
+		if ( audio->paused && audio->waitpaused ) {
+			SDL_Delay(10);
+			continue;
+		}
+
+		/* Wait for a buffer of sound from the device */
+		len = audio->CaptureAudio(audio, stream, stream_len);
+		if ( len < 0 ) {
+			/* The device is gone, stop capturing */
+			audio->enabled = 0;
+			break;
+		}
+		if ( len < stream_len ) {
+			SDL_memset(stream+len, audio->spec.silence, stream_len-len);
+		}
+
+		/* Advance the sample clock */
+		frames += audio->spec.samples;
+		while ( frames >= (Uint32)audio->spec.freq ) {
+			frames -= audio->spec.freq;
+			++seconds;
+		}
+		audio->ticks = seconds*1000 + (frames*1000)/audio->spec.freq;
+
+		/* Convert the audio if necessary */
+		len = stream_len;
+		convert_us = 0;
+		if ( audio->convert.needed ) {
+			audio->convert.len = stream_len;
+			start = SDL_GetAudioMicroTicks();
+			SDL_ConvertAudio(&audio->convert);
+			convert_us = SDL_GetAudioMicroTicks() - start;
+			len = audio->convert.len_cvt;
+		}
+
+		/* The captured audio is dropped while the device is paused */
+		if ( audio->paused ) {
+			SDL_UpdateAudioStatus(audio, 0, 0, convert_us);
+			continue;
+		}
+		start = SDL_GetAudioMicroTicks();
+		if ( audio->queue ) {
+			if ( SDL_WriteAudioQueue(audio->queue, stream, len) < 0 ) {
+				/* Out of memory, the application isn't keeping up */
+				audio->enabled = 0;
+			}
+		} else {
+			SDL_mutexP(audio->mixer_lock);
+			(*fill)(udata, stream, len);
+			SDL_mutexV(audio->mixer_lock);
+		}
+		callback_us = SDL_GetAudioMicroTicks() - start;
+		SDL_UpdateAudioStatus(audio, 1, callback_us, convert_us);
+	}
+
+	return(0);
+}
+
 static void SDL_LockAudio_Default(SDL_AudioDevice *audio)
 {
 	if ( audio->thread && (SDL_ThreadID() == audio->threadid) ) {
@@ -270,6 +504,59 @@ static Uint16 SDL_ParseAudioFormat(const char *string)
 	return format;
 }
 
+static void SDL_SetupAudioDevice(SDL_AudioDevice *audio)
+{
+	audio->name = current_bootstrap->name;
+	if ( !audio->LockAudio && !audio->UnlockAudio ) {
+		audio->LockAudio = SDL_LockAudio_Default;
+		audio->UnlockAudio = SDL_UnlockAudio_Default;
+	}
+}
+
+static void SDL_LockOpenDevices(void)
+{
+	if ( open_devices_lock ) {
+		SDL_mutexP(open_devices_lock);
+	}
+}
+
+static void SDL_UnlockOpenDevices(void)
+{
+	if ( open_devices_lock ) {
+		SDL_mutexV(open_devices_lock);
+	}
+}
+
+/* Check that one more device can be opened with the current driver */
+static int SDL_CanOpenAnotherDevice(void)
+{
+	int i;
+
+	if ( current_audio->multiopen ) {
+		return(1);
+	}
+	if ( current_audio->opened ) {
+		return(0);
+	}
+	for ( i = 1; i < MAX_AUDIO_DEVICES; ++i ) {
+		if ( open_devices[i] ) {
+			return(0);
+		}
+	}
+	return(1);
+}
+
+static SDL_AudioDevice *get_audio_device(SDL_AudioDeviceID devid)
+{
+	if ( devid == 1 ) {
+		return(current_audio);
+	}
+	if ( (devid > 1) && (devid <= MAX_AUDIO_DEVICES) ) {
+		return(open_devices[devid-1]);
+	}
+	return(NULL);
+}
+
 int SDL_AudioInit(const char *driver_name)
 {
 	SDL_AudioDevice *audio;
@@ -279,6 +566,10 @@ int SDL_AudioInit(const char *driver_name)
 	if ( current_audio != NULL ) {
 		SDL_AudioQuit();
 	}
+	open_devices_lock = SDL_CreateMutex();
+	if ( open_devices_lock == NULL ) {
+		return(-1);
+	}
 
 	/* Select the proper audio driver */
 	audio = NULL;
@@ -357,11 +648,8 @@ int SDL_AudioInit(const char *driver_name)
 	}
 	current_audio = audio;
 	if ( current_audio ) {
-		current_audio->name = bootstrap[i]->name;
-		if ( !current_audio->LockAudio && !current_audio->UnlockAudio ) {
-			current_audio->LockAudio = SDL_LockAudio_Default;
-			current_audio->UnlockAudio = SDL_UnlockAudio_Default;
-		}
+		current_bootstrap = bootstrap[i];
+		SDL_SetupAudioDevice(current_audio);
 	}
 	return(0);
 }
@@ -375,26 +663,11 @@ char *SDL_AudioDriverName(char *namebuf, int maxlen)
 	return(NULL);
 }
 
-int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+/* Fill in the defaults of an audio spec, and check that it is usable */
+static int SDL_CheckAudioSpec(SDL_AudioSpec *desired)
 {
-	SDL_AudioDevice *audio;
 	const char *env;
 
-	/* Start up the audio driver, if necessary */
-	if ( ! current_audio ) {
-		if ( (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) ||
-		     (current_audio == NULL) ) {
-			return(-1);
-		}
-	}
-	audio = current_audio;
-
-	if (audio->opened) {
-		SDL_SetError("Audio device is already opened");
-		return(-1);
-	}
-
-	/* Verify some parameters */
 	if ( desired->freq == 0 ) {
 		env = SDL_getenv("SDL_AUDIO_FREQUENCY");
 		if ( env ) {
@@ -430,9 +703,10 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	    case 2:	/* Stereo */
 	    case 4:	/* surround */
 	    case 6:	/* surround with center and lfe */
+	    case 8:	/* 7.1, surround with side speakers */
 		break;
 	    default:
-		SDL_SetError("1 (mono) and 2 (stereo) channels supported");
+		SDL_SetError("Only 1, 2, 4, 6 and 8 channels are supported");
 		return(-1);
 	}
 	if ( desired->samples == 0 ) {
@@ -450,8 +724,14 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		}
 		desired->samples = power2;
 	}
-	if ( desired->callback == NULL ) {
-		SDL_SetError("SDL_OpenAudio() passed a NULL callback");
+	return(0);
+}
+
+/* Open a device with a checked spec, the caller closes it on failure */
+static int SDL_OpenAudioDevice_Internal(SDL_AudioDevice *audio, SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	if ( audio->iscapture && (audio->CaptureAudio == NULL) ) {
+		SDL_SetError("Audio driver doesn't support capture");
 		return(-1);
 	}
 
@@ -462,11 +742,18 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	audio->mixer_lock = SDL_CreateMutex();
 	if ( audio->mixer_lock == NULL ) {
 		SDL_SetError("Couldn't create mixer lock");
-		SDL_CloseAudio();
 		return(-1);
 	}
 #endif /* SDL_THREADS_DISABLED */
 
+	/* Without a callback the audio is queued, see SDL_QueueAudio() */
+	if ( desired->callback == NULL ) {
+		audio->queue = SDL_CreateAudioQueue();
+		if ( audio->queue == NULL ) {
+			return(-1);
+		}
+	}
+
 	/* Calculate the silence and size of the audio specification */
 	SDL_CalculateAudioSpec(desired);
 
@@ -475,11 +762,14 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	audio->convert.needed = 0;
 	audio->enabled = 1;
 	audio->paused  = 1;
+	audio->ticks = 0;
+	SDL_memset(&audio->position, 0, sizeof(audio->position));
+	SDL_memset(&audio->stats, 0, sizeof(audio->stats));
+	audio->underruns = 0;
 
 	audio->opened = audio->OpenAudio(audio, &audio->spec)+1;
 
 	if ( ! audio->opened ) {
-		SDL_CloseAudio();
 		return(-1);
 	}
 
@@ -492,7 +782,6 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	/* Allocate a fake audio memory buffer */
 	audio->fake_stream = SDL_AllocAudioMem(audio->spec.size);
 	if ( audio->fake_stream == NULL ) {
-		SDL_CloseAudio();
 		SDL_OutOfMemory();
 		return(-1);
 	}
@@ -504,39 +793,60 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		    desired->format != audio->spec.format ||
 		    desired->channels != audio->spec.channels ) {
 		/* Build an audio conversion block */
-		if ( SDL_BuildAudioCVT(&audio->convert,
+		if ( audio->iscapture ) {
+			if ( SDL_BuildAudioCVT(&audio->convert,
+				audio->spec.format, audio->spec.channels,
+						audio->spec.freq,
+				desired->format, desired->channels,
+						desired->freq) < 0 ) {
+				return(-1);
+			}
+		} else if ( SDL_BuildAudioCVT(&audio->convert,
 			desired->format, desired->channels,
 					desired->freq,
 			audio->spec.format, audio->spec.channels,
 					audio->spec.freq) < 0 ) {
-			SDL_CloseAudio();
 			return(-1);
 		}
-		if ( audio->convert.needed ) {
+		if ( audio->convert.needed && audio->iscapture ) {
+			/* Captured audio is converted from the hardware size */
+			audio->convert.len = audio->spec.size;
+			audio->convert.buf =(Uint8 *)SDL_AllocAudioMem(
+			   audio->convert.len*audio->convert.len_mult);
+			if ( audio->convert.buf == NULL ) {
+				SDL_OutOfMemory();
+				return(-1);
+			}
+		} else if ( audio->convert.needed ) {
 			audio->convert.len = (int) ( ((double) audio->spec.size) /
                                           audio->convert.len_ratio );
 			audio->convert.buf =(Uint8 *)SDL_AllocAudioMem(
 			   audio->convert.len*audio->convert.len_mult);
 			if ( audio->convert.buf == NULL ) {
-				SDL_CloseAudio();
 				SDL_OutOfMemory();
 				return(-1);
 			}
 		}
 	}
 
+	/* Each buffer has to be mixed in less time than it takes to play */
+	audio->stats.budget_us = (Uint32) (((double) audio->spec.samples * 1000000) / audio->spec.freq);
+
 	/* Start the audio thread if necessary */
 	switch (audio->opened) {
 		case  1:
 			/* Start the audio thread */
 #if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
 #undef SDL_CreateThread
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio, NULL, NULL);
+			audio->thread = SDL_CreateThread(audio->iscapture ?
+					SDL_RunAudioCapture : SDL_RunAudio,
+					audio, NULL, NULL);
 #else
-			audio->thread = SDL_CreateThread(SDL_RunAudio, audio);
+			audio->thread = SDL_CreateThread(audio->iscapture ?
+					SDL_RunAudioCapture : SDL_RunAudio,
+					audio);
 #endif
 			if ( audio->thread == NULL ) {
-				SDL_CloseAudio();
 				SDL_SetError("Couldn't create audio thread");
 				return(-1);
 			}
@@ -550,9 +860,160 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	return(0);
 }
 
-SDL_audiostatus SDL_GetAudioStatus(void)
+/* Stop the audio thread and close a device, so it can be opened again */
+static void SDL_CloseAudioDevice_Internal(SDL_AudioDevice *audio)
+{
+	audio->enabled = 0;
+	if ( audio->thread != NULL ) {
+		SDL_WaitThread(audio->thread, NULL);
+		audio->thread = NULL;
+	}
+	if ( audio->mixer_lock != NULL ) {
+		SDL_DestroyMutex(audio->mixer_lock);
+		audio->mixer_lock = NULL;
+	}
+	if ( audio->fake_stream != NULL ) {
+		SDL_FreeAudioMem(audio->fake_stream);
+		audio->fake_stream = NULL;
+	}
+	if ( audio->convert.needed ) {
+		SDL_FreeAudioMem(audio->convert.buf);
+		audio->convert.buf = NULL;
+		audio->convert.needed = 0;
+	}
+	if ( audio->opened ) {
+		audio->CloseAudio(audio);
+		audio->opened = 0;
+	}
+	if ( audio->queue != NULL ) {
+		SDL_FreeAudioQueue(audio->queue);
+		audio->queue = NULL;
+	}
+}
+
+static void SDL_FreeAudioDevice(SDL_AudioDevice *audio)
+{
+	SDL_CloseAudioDevice_Internal(audio);
+	if ( audio->devname ) {
+		SDL_free(audio->devname);
+	}
+	/* Free the driver data */
+	audio->free(audio);
+}
+
+int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 {
-	SDL_AudioDevice *audio = current_audio;
+	SDL_AudioDevice *audio;
+
+	/* Start up the audio driver, if necessary */
+	if ( ! current_audio ) {
+		if ( (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) ||
+		     (current_audio == NULL) ) {
+			return(-1);
+		}
+	}
+	audio = current_audio;
+
+	if (audio->opened) {
+		SDL_SetError("Audio device is already opened");
+		return(-1);
+	}
+	if ( SDL_CheckAudioSpec(desired) < 0 ) {
+		return(-1);
+	}
+	SDL_LockOpenDevices();
+	if ( ! SDL_CanOpenAnotherDevice() ) {
+		SDL_UnlockOpenDevices();
+		SDL_SetError("The %s audio driver can only open one device",
+							audio->name);
+		return(-1);
+	}
+	if ( SDL_OpenAudioDevice_Internal(audio, desired, obtained) < 0 ) {
+		SDL_UnlockOpenDevices();
+		SDL_CloseAudio();
+		return(-1);
+	}
+	SDL_UnlockOpenDevices();
+	return(0);
+}
+
+static SDL_AudioDeviceID SDL_OpenAudioDevice_ID(const char *device, int iscapture, SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	SDL_AudioDevice *audio;
+	SDL_AudioDeviceID devid;
+
+	/* Start up the audio driver, if necessary */
+	if ( ! current_bootstrap ) {
+		if ( (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) ||
+		     (current_bootstrap == NULL) ) {
+			return(0);
+		}
+	}
+
+	SDL_LockOpenDevices();
+
+	/* Drivers that keep their state in globals get a single device */
+	if ( ! SDL_CanOpenAnotherDevice() ) {
+		SDL_SetError("The %s audio driver can only open one device",
+							current_audio->name);
+		goto error;
+	}
+
+	/* Find a free device ID */
+	for ( devid = 2; devid <= MAX_AUDIO_DEVICES; ++devid ) {
+		if ( open_devices[devid-1] == NULL ) {
+			break;
+		}
+	}
+	if ( devid > MAX_AUDIO_DEVICES ) {
+		SDL_SetError("Too many audio devices opened");
+		goto error;
+	}
+	if ( SDL_CheckAudioSpec(desired) < 0 ) {
+		goto error;
+	}
+
+	/* Each device gets its own driver instance, thread and converter */
+	audio = current_bootstrap->create(0);
+	if ( audio == NULL ) {
+		goto error;
+	}
+	SDL_SetupAudioDevice(audio);
+	audio->iscapture = iscapture;
+	if ( device != NULL ) {
+		audio->devname = SDL_strdup(device);
+		if ( audio->devname == NULL ) {
+			SDL_FreeAudioDevice(audio);
+			SDL_OutOfMemory();
+			goto error;
+		}
+	}
+	if ( SDL_OpenAudioDevice_Internal(audio, desired, obtained) < 0 ) {
+		SDL_FreeAudioDevice(audio);
+		goto error;
+	}
+	open_devices[devid-1] = audio;
+	SDL_UnlockOpenDevices();
+	return(devid);
+
+error:
+	SDL_UnlockOpenDevices();
+	return(0);
+}
+
+SDL_AudioDeviceID SDL_OpenAudioDevice(const char *device, SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	return(SDL_OpenAudioDevice_ID(device, 0, desired, obtained));
+}
+
+SDL_AudioDeviceID SDL_OpenAudioCaptureDevice(const char *device, SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
+{
+	return(SDL_OpenAudioDevice_ID(device, 1, desired, obtained));
+}
+
+SDL_audiostatus SDL_GetAudioDeviceStatus(SDL_AudioDeviceID devid)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
 	SDL_audiostatus status;
 
 	status = SDL_AUDIO_STOPPED;
@@ -566,18 +1027,119 @@ SDL_audiostatus SDL_GetAudioStatus(void)
 	return(status);
 }
 
-void SDL_PauseAudio (int pause_on)
+SDL_audiostatus SDL_GetAudioStatus(void)
+{
+	return(SDL_GetAudioDeviceStatus(1));
+}
+
+Uint32 SDL_GetAudioDeviceTicks(SDL_AudioDeviceID devid)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( audio && audio->opened ) {
+		return(audio->ticks);
+	}
+	return(0);
+}
+
+Uint32 SDL_GetAudioTicks(void)
+{
+	return(SDL_GetAudioDeviceTicks(1));
+}
+
+int SDL_GetAudioDevicePosition(SDL_AudioDeviceID devid, SDL_AudioPosition *pos)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+	Uint32 elapsed, moved;
+	double app_len;
+
+	if ( !audio || !audio->opened ) {
+		SDL_SetError("Audio device hasn't been opened");
+		return(-1);
+	}
+	SDL_AtomicLock(&audio->status_lock);
+	SDL_memcpy(pos, &audio->position, sizeof(*pos));
+	SDL_AtomicUnlock(&audio->status_lock);
+
+	/* The queue holds audio in the application's format */
+	if ( audio->queue ) {
+		if ( !audio->convert.needed ) {
+			app_len = audio->spec.size;
+		} else if ( audio->iscapture ) {
+			app_len = audio->spec.size * audio->convert.len_ratio;
+		} else {
+			app_len = audio->convert.len;
+		}
+		pos->buffered = (Uint32) (((double) SDL_GetAudioQueueSize(audio->queue) * audio->spec.samples) / app_len);
+	}
+
+	/* The device has moved on since the last buffer */
+	if ( pos->frames > 0 ) {
+		elapsed = SDL_GetTicks() - pos->timestamp;
+		moved = (elapsed / 1000) * audio->spec.freq +
+		        ((elapsed % 1000) * audio->spec.freq) / 1000;
+		if ( audio->iscapture ) {
+			pos->position = pos->frames + pos->latency + moved;
+		} else {
+			/* Without more audio the device stops at the end */
+			if ( moved > pos->latency ) {
+				moved = pos->latency;
+			}
+			pos->position = pos->frames - pos->latency + moved;
+		}
+	}
+	return(0);
+}
+
+int SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioStats *stats)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( !audio || !audio->opened ) {
+		SDL_SetError("Audio device hasn't been opened");
+		return(-1);
+	}
+	SDL_AtomicLock(&audio->status_lock);
+	SDL_memcpy(stats, &audio->stats, sizeof(*stats));
+	SDL_AtomicUnlock(&audio->status_lock);
+	return(0);
+}
+
+int SDL_GetAudioDeviceDelay(SDL_AudioDeviceID devid)
 {
-	SDL_AudioDevice *audio = current_audio;
+	SDL_AudioDevice *audio = get_audio_device(devid);
+	SDL_AudioPosition pos;
+
+	if ( SDL_GetAudioDevicePosition(devid, &pos) < 0 ) {
+		return(-1);
+	}
+	if ( !audio->GetDelay ) {
+		SDL_SetError("Audio driver doesn't report its delay");
+		return(-1);
+	}
+	if ( audio->iscapture ) {
+		return((int) (pos.position - pos.frames));
+	}
+	return((int) (pos.frames - pos.position));
+}
+
+void SDL_PauseAudioDevice(SDL_AudioDeviceID devid, int pause_on)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
 
 	if ( audio ) {
 		audio->paused = pause_on;
 	}
 }
 
-void SDL_LockAudio (void)
+void SDL_PauseAudio (int pause_on)
+{
+	SDL_PauseAudioDevice(1, pause_on);
+}
+
+void SDL_LockAudioDevice(SDL_AudioDeviceID devid)
 {
-	SDL_AudioDevice *audio = current_audio;
+	SDL_AudioDevice *audio = get_audio_device(devid);
 
 	/* Obtain a lock on the mixing buffers */
 	if ( audio && audio->LockAudio ) {
@@ -585,9 +1147,14 @@ void SDL_LockAudio (void)
 	}
 }
 
-void SDL_UnlockAudio (void)
+void SDL_LockAudio (void)
 {
-	SDL_AudioDevice *audio = current_audio;
+	SDL_LockAudioDevice(1);
+}
+
+void SDL_UnlockAudioDevice(SDL_AudioDeviceID devid)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
 
 	/* Release lock on the mixing buffers */
 	if ( audio && audio->UnlockAudio ) {
@@ -595,38 +1162,110 @@ void SDL_UnlockAudio (void)
 	}
 }
 
+void SDL_UnlockAudio (void)
+{
+	SDL_UnlockAudioDevice(1);
+}
+
+int SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( !audio || !audio->queue || audio->iscapture ) {
+		SDL_SetError("Audio device doesn't queue audio for playback");
+		return(-1);
+	}
+	return(SDL_WriteAudioQueue(audio->queue, (const Uint8 *)data, len));
+}
+
+Uint32 SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( !audio || !audio->queue || !audio->iscapture ) {
+		return(0);
+	}
+	return(SDL_ReadAudioQueue(audio->queue, (Uint8 *)data, len));
+}
+
+Uint32 SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( !audio || !audio->queue ) {
+		return(0);
+	}
+	return(SDL_GetAudioQueueSize(audio->queue));
+}
+
+void SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
+{
+	SDL_AudioDevice *audio = get_audio_device(devid);
+
+	if ( audio && audio->queue ) {
+		SDL_ClearAudioQueue(audio->queue);
+	}
+}
+
 void SDL_CloseAudio (void)
 {
+	int i;
+
+	/* Keep the driver around while other devices are open */
+	SDL_LockOpenDevices();
+	for ( i = 1; i < MAX_AUDIO_DEVICES; ++i ) {
+		if ( open_devices[i] ) {
+			if ( current_audio ) {
+				SDL_CloseAudioDevice_Internal(current_audio);
+			}
+			SDL_UnlockOpenDevices();
+			return;
+		}
+	}
+	SDL_UnlockOpenDevices();
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
 }
 
-void SDL_AudioQuit(void)
+void SDL_CloseAudioDevice(SDL_AudioDeviceID devid)
 {
-	SDL_AudioDevice *audio = current_audio;
+	SDL_AudioDevice *audio;
 
+	if ( devid == 1 ) {
+		SDL_CloseAudio();
+		return;
+	}
+	SDL_LockOpenDevices();
+	audio = get_audio_device(devid);
 	if ( audio ) {
-		audio->enabled = 0;
-		if ( audio->thread != NULL ) {
-			SDL_WaitThread(audio->thread, NULL);
-		}
-		if ( audio->mixer_lock != NULL ) {
-			SDL_DestroyMutex(audio->mixer_lock);
-		}
-		if ( audio->fake_stream != NULL ) {
-			SDL_FreeAudioMem(audio->fake_stream);
-		}
-		if ( audio->convert.needed ) {
-			SDL_FreeAudioMem(audio->convert.buf);
+		open_devices[devid-1] = NULL;
+	}
+	SDL_UnlockOpenDevices();
+	if ( audio ) {
+		SDL_FreeAudioDevice(audio);
+	}
+}
 
+void SDL_AudioQuit(void)
+{
+	int i;
+
+	SDL_LockOpenDevices();
+	for ( i = 1; i < MAX_AUDIO_DEVICES; ++i ) {
+		if ( open_devices[i] ) {
+			SDL_FreeAudioDevice(open_devices[i]);
+			open_devices[i] = NULL;
 		}
-		if ( audio->opened ) {
-			audio->CloseAudio(audio);
-			audio->opened = 0;
-		}
-		/* Free the driver data */
-		audio->free(audio);
+	}
+	if ( current_audio ) {
+		SDL_FreeAudioDevice(current_audio);
 		current_audio = NULL;
 	}
+	current_bootstrap = NULL;
+	SDL_UnlockOpenDevices();
+	if ( open_devices_lock ) {
+		SDL_DestroyMutex(open_devices_lock);
+		open_devices_lock = NULL;
+	}
 }
 
 #define NUM_FORMATS	6
@@ -677,7 +1316,16 @@ void SDL_CalculateAudioSpec(SDL_AudioSpec *spec)
 
 void SDL_Audio_SetCaption(const char *caption)
 {
+	int i;
+
 	if ((current_audio) && (current_audio->SetCaption)) {
 		current_audio->SetCaption(current_audio, caption);
 	}
+	SDL_LockOpenDevices();
+	for ( i = 1; i < MAX_AUDIO_DEVICES; ++i ) {
+		if ((open_devices[i]) && (open_devices[i]->SetCaption)) {
+			open_devices[i]->SetCaption(open_devices[i], caption);
+		}
+	}
+	SDL_UnlockOpenDevices();
 }
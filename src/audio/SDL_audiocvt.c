@@ -24,6 +24,7 @@
 /* Functions for audio drivers to perform runtime conversion of audio format */
 
 #include "SDL_audio.h"
+#include "SDL_audiomatrix_c.h"
 
 
 /* Effectively mix right and left channels into a single channel */
@@ -1319,6 +1320,43 @@ int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 	return(0);
 }
 
+/* The number of times the rate doubles (or halves, if negative) to get
+   within 1% of dst_rate, as done by the SDL_RateMUL2() and SDL_RateDIV2()
+   filters.  Anything left over isn't converted.
+ */
+static int SDL_GetRateShift(int src_rate, int dst_rate)
+{
+	Uint32 hi_rate, lo_rate;
+	int shift;
+
+	if ( (src_rate/100) == (dst_rate/100) ) {
+		return(0);
+	}
+	if ( src_rate > dst_rate ) {
+		hi_rate = src_rate;
+		lo_rate = dst_rate;
+	} else {
+		hi_rate = dst_rate;
+		lo_rate = src_rate;
+	}
+	shift = 0;
+	while ( ((lo_rate*2)/100) <= (hi_rate/100) ) {
+		lo_rate *= 2;
+		++shift;
+	}
+	return (src_rate > dst_rate) ? -shift : shift;
+}
+
+/* Whether the channel filters below drop 'src_channels' to 'dst_channels'
+   with a single strip or mono pass
+ */
+static int SDL_IsStripChannels(int src_channels, int dst_channels)
+{
+	return( ((src_channels == 6) && (dst_channels == 4)) ||
+		((src_channels == 6) && (dst_channels == 2)) ||
+		((src_channels == 4) && (dst_channels == 2)) );
+}
+
 /* Creates a set of audio filters to convert from one format to another. 
    Returns -1 if the format conversion is not supported, or 1 if the
    audio filter is set up.
@@ -1328,6 +1366,9 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 	Uint16 src_format, Uint8 src_channels, int src_rate,
 	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
 {
+	SDL_AudioFilter matrix_cvt;
+	int rate_shift, format_passes;
+
 /*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
 		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
 	/* Start off with no conversion necessary */
@@ -1337,19 +1378,70 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 	cvt->len_mult = 1;
 	cvt->len_ratio = 1.0;
 
+	/* Count the passes the format filters below would make */
+	format_passes = 0;
+	if ( (src_format & 0x1000) != (dst_format & 0x1000) ) {
+		++format_passes;
+	}
+	if ( (src_format & 0x8000) != (dst_format & 0x8000) ) {
+		++format_passes;
+	}
+	if ( (src_format & 0xFF) != (dst_format & 0xFF) ) {
+		++format_passes;
+	}
+
+	/* A channel change, or more than one format pass, is done with a
+	   single matrix filter that converts everything at once, along with
+	   a rate change if there is one that it can do.  Otherwise the rate
+	   filters below change the rate, so rate changes on their own still
+	   use them.  Dropping 6 channels to 4 or 2, or 4 to 2, in the same
+	   format is a single pass of the strip and mono filters below, which
+	   is faster than mixing, so those stay on them.
+	 */
+	rate_shift = SDL_GetRateShift(src_rate, dst_rate);
+	matrix_cvt = NULL;
+	if ( (format_passes > 1) || ((src_channels != dst_channels) &&
+	     ((format_passes > 0) || !SDL_IsStripChannels(src_channels,
+							  dst_channels))) ) {
+		matrix_cvt = SDL_GetMatrixFilter(src_channels, dst_channels,
+								rate_shift);
+		if ( matrix_cvt == NULL ) {
+			rate_shift = 0;
+			matrix_cvt = SDL_GetMatrixFilter(src_channels,
+							dst_channels, 0);
+		}
+	}
+	if ( matrix_cvt ) {
+		int src_size = ((src_format & 0xFF) / 8) * src_channels;
+		int dst_size = ((dst_format & 0xFF) / 8) * dst_channels;
+
+		if ( rate_shift > 0 ) {
+			dst_size <<= rate_shift;
+		} else if ( rate_shift < 0 ) {
+			src_size <<= -rate_shift;
+		}
+		cvt->filters[cvt->filter_index++] = matrix_cvt;
+		cvt->len_mult *= (dst_size + src_size - 1) / src_size;
+		cvt->len_ratio *= (double)dst_size / src_size;
+		src_channels = dst_channels;
+		if ( rate_shift != 0 ) {
+			src_rate = dst_rate;
+		}
+	}
+
 	/* First filter:  Endian conversion from src to dst */
-	if ( (src_format & 0x1000) != (dst_format & 0x1000)
+	if ( !matrix_cvt && (src_format & 0x1000) != (dst_format & 0x1000)
 	     && ((src_format & 0xff) == 16) && ((dst_format & 0xff) == 16)) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertEndian;
 	}
 	
 	/* Second filter: Sign conversion -- signed/unsigned */
-	if ( (src_format & 0x8000) != (dst_format & 0x8000) ) {
+	if ( !matrix_cvt && (src_format & 0x8000) != (dst_format & 0x8000) ) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertSign;
 	}
 
 	/* Next filter:  Convert 16 bit <--> 8 bit PCM */
-	if ( (src_format & 0xFF) != (dst_format & 0xFF) ) {
+	if ( !matrix_cvt && (src_format & 0xFF) != (dst_format & 0xFF) ) {
 		switch (dst_format&0x10FF) {
 			case AUDIO_U8:
 				cvt->filters[cvt->filter_index++] =
@@ -0,0 +1,961 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A single pass audio converter, mixing channels through a matrix and
+   converting the sample format and rate as it goes.
+ */
+
+#include "SDL_audio.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_endian.h"
+#include "SDL_audiomatrix_c.h"
+
+#if SDL_ASSEMBLY_ROUTINES && (defined(__SSE2__) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || \
+			  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+#define SSE2_AUDIOMATRIX
+#endif
+
+#ifdef SSE2_AUDIOMATRIX
+#include <emmintrin.h>
+#endif
+
+#define MAX_CHANNELS	8
+
+/* The number of frames converted at a time, small enough for the stack */
+#define MATRIX_BLOCK	128
+
+/* The largest rate change done in the same pass is 2^3 */
+#define MAX_RATE_SHIFT	3
+
+/* Swap the bytes of a 16 bit word in plain C, unlike SDL_Swap16() the
+   compiler can vectorize the sample loops with it */
+#define SWAP16(x)	((Uint16)(((x) << 8) | ((x) >> 8)))
+
+/* Speaker positions, in the order SDL puts them in a frame */
+enum {
+	SPEAKER_FL,
+	SPEAKER_FR,
+	SPEAKER_C,
+	SPEAKER_LFE,
+	SPEAKER_RL,
+	SPEAKER_RR,
+	SPEAKER_SL,
+	SPEAKER_SR
+};
+
+/* -3 dB, for a speaker folded into the ones next to it */
+#define FOLD_GAIN	0.70710678f
+
+static const int layout_2[] = {
+	SPEAKER_FL, SPEAKER_FR
+};
+static const int layout_4[] = {
+	SPEAKER_FL, SPEAKER_FR, SPEAKER_RL, SPEAKER_RR
+};
+static const int layout_6[] = {
+	SPEAKER_FL, SPEAKER_FR, SPEAKER_C, SPEAKER_LFE, SPEAKER_RL, SPEAKER_RR
+};
+static const int layout_8[] = {
+	SPEAKER_FL, SPEAKER_FR, SPEAKER_C, SPEAKER_LFE, SPEAKER_RL, SPEAKER_RR,
+	SPEAKER_SL, SPEAKER_SR
+};
+
+static const int *SDL_GetChannelLayout(int channels)
+{
+	switch (channels) {
+		case 2: return(layout_2);
+		case 4: return(layout_4);
+		case 6: return(layout_6);
+		case 8: return(layout_8);
+	}
+	return(NULL);
+}
+
+static int SDL_FindSpeaker(const int *layout, int channels, int speaker)
+{
+	int i;
+
+	for ( i = 0; i < channels; ++i ) {
+		if ( layout[i] == speaker ) {
+			return(i);
+		}
+	}
+	return(-1);
+}
+
+/* Fill in matrix[out][in], the gain of each input channel in each output.
+   Speakers missing from the output are folded into their neighbours, the
+   LFE channel is dropped, and the whole matrix is scaled down if any
+   output could clip.
+ */
+static void SDL_BuildChannelMatrix(float matrix[MAX_CHANNELS][MAX_CHANNELS],
+				   int src_channels, int dst_channels)
+{
+	const int *src_layout, *dst_layout;
+	float sum, peak;
+	int i, o;
+
+	SDL_memset(matrix, 0, sizeof(float)*MAX_CHANNELS*MAX_CHANNELS);
+
+	/* Mono is the average of the stereo downmix */
+	if ( dst_channels == 1 ) {
+		float stereo[MAX_CHANNELS][MAX_CHANNELS];
+
+		SDL_BuildChannelMatrix(stereo, src_channels, 2);
+		for ( i = 0; i < src_channels; ++i ) {
+			matrix[0][i] = (stereo[0][i] + stereo[1][i]) * 0.5f;
+		}
+		return;
+	}
+
+	/* ... and plays on both front speakers */
+	if ( src_channels == 1 ) {
+		matrix[0][0] = 1.0f;
+		matrix[1][0] = 1.0f;
+		return;
+	}
+
+	src_layout = SDL_GetChannelLayout(src_channels);
+	dst_layout = SDL_GetChannelLayout(dst_channels);
+	for ( i = 0; i < src_channels; ++i ) {
+		int speaker = src_layout[i];
+
+		o = SDL_FindSpeaker(dst_layout, dst_channels, speaker);
+		if ( o >= 0 ) {
+			matrix[o][i] += 1.0f;
+			continue;
+		}
+		switch (speaker) {
+			case SPEAKER_C:
+				matrix[0][i] += FOLD_GAIN;
+				matrix[1][i] += FOLD_GAIN;
+				break;
+			case SPEAKER_RL:
+				matrix[0][i] += FOLD_GAIN;
+				break;
+			case SPEAKER_RR:
+				matrix[1][i] += FOLD_GAIN;
+				break;
+			case SPEAKER_SL:
+			case SPEAKER_SR:
+				/* Sides go to the rear if there is one */
+				o = SDL_FindSpeaker(dst_layout, dst_channels,
+					(speaker == SPEAKER_SL) ?
+						SPEAKER_RL : SPEAKER_RR);
+				if ( o < 0 ) {
+					o = (speaker == SPEAKER_SL) ? 0 : 1;
+				}
+				matrix[o][i] += FOLD_GAIN;
+				break;
+			default:
+				break;
+		}
+	}
+
+	peak = 1.0f;
+	for ( o = 0; o < dst_channels; ++o ) {
+		sum = 0.0f;
+		for ( i = 0; i < src_channels; ++i ) {
+			sum += matrix[o][i];
+		}
+		if ( sum > peak ) {
+			peak = sum;
+		}
+	}
+	if ( peak > 1.0f ) {
+		for ( o = 0; o < dst_channels; ++o ) {
+			for ( i = 0; i < src_channels; ++i ) {
+				matrix[o][i] /= peak;
+			}
+		}
+	}
+}
+
+/* Unpack interleaved samples into one signed 16 bit plane per channel,
+   reading one frame out of every 'step' to halve the rate on the way.
+   Each plane is filled in turn, which keeps the writes sequential.
+   Samples are read as whole words, byte swapped if they're the other
+   endian, and unsigned ones are flipped to signed.
+ */
+#define DECODE_PLANES(type, sample) \
+	for ( c = 0; c < channels; ++c ) { \
+		const type *src = (const type *)data + c; \
+		Sint16 *plane = planes[c]; \
+		for ( i = 0; i < frames; ++i ) { \
+			plane[i] = (Sint16)(sample); \
+			src += stride; \
+		} \
+	}
+
+static void SDL_DecodeFrames(const Uint8 *data, Uint16 format, int channels,
+			     int step, int frames,
+			     Sint16 planes[MAX_CHANNELS][MATRIX_BLOCK])
+{
+	Uint16 flip;
+	int i, c, stride;
+
+	stride = step * channels;
+	if ( (format & 0xFF) == 8 ) {
+		flip = (format & 0x8000) ? 0 : 0x80;
+		DECODE_PLANES(Uint8, (src[0] ^ flip) << 8);
+	} else if ( (format & 0x1000) == (AUDIO_U16SYS & 0x1000) ) {
+		flip = (format & 0x8000) ? 0 : 0x8000;
+		DECODE_PLANES(Uint16, src[0] ^ flip);
+	} else {
+		flip = (format & 0x8000) ? 0 : 0x8000;
+		DECODE_PLANES(Uint16, SWAP16(src[0]) ^ flip);
+	}
+}
+
+#undef DECODE_PLANES
+
+/* Interleave the channel planes into the output format, writing every
+   frame 'repeat' times to double the rate on the way.  Like decoding,
+   each plane is done in turn.
+ */
+#define ENCODE_PLANES(type, sample) \
+	for ( c = 0; c < channels; ++c ) { \
+		type *dst = (type *)data + c; \
+		const Sint16 *plane = planes[c]; \
+		type value; \
+		if ( repeat == 1 ) { \
+			for ( i = 0; i < frames; ++i ) { \
+				*dst = (type)(sample); \
+				dst += channels; \
+			} \
+		} else { \
+			for ( i = 0; i < frames; ++i ) { \
+				value = (type)(sample); \
+				for ( r = 0; r < repeat; ++r ) { \
+					*dst = value; \
+					dst += channels; \
+				} \
+			} \
+		} \
+	}
+
+static void SDL_EncodeFrames(Uint8 *data, Uint16 format, int channels,
+			     int repeat, int frames,
+			     const Sint16 *planes[MAX_CHANNELS])
+{
+	Uint16 flip;
+	int i, r, c;
+
+	if ( (format & 0xFF) == 8 ) {
+		flip = (format & 0x8000) ? 0 : 0x80;
+		ENCODE_PLANES(Uint8, ((Uint16)plane[i] >> 8) ^ flip);
+	} else if ( (format & 0x1000) == (AUDIO_U16SYS & 0x1000) ) {
+		flip = (format & 0x8000) ? 0 : 0x8000;
+		ENCODE_PLANES(Uint16, (Uint16)plane[i] ^ flip);
+	} else {
+		flip = (format & 0x8000) ? 0 : 0x8000;
+		ENCODE_PLANES(Uint16, SWAP16((Uint16)(plane[i] ^ flip)));
+	}
+}
+
+#undef ENCODE_PLANES
+
+/* Convert samples straight from one format to another, when no channels
+   are mixed.  Each sample is read as a 16 bit word with the signedness
+   of the output, so a single exclusive or takes care of the sign.  The
+   buffer is walked backwards when the samples get wider.
+ */
+#define CONVERT_SAMPLES(stype, read, dtype, write) \
+	{ \
+		const stype *src = (const stype *)data; \
+		dtype *dst = (dtype *)data; \
+		if ( sizeof(dtype) > sizeof(stype) ) { \
+			for ( i = count-1; i >= 0; --i ) { \
+				v = (Uint16)((read) ^ flip); \
+				dst[i] = (dtype)(write); \
+			} \
+		} else { \
+			for ( i = 0; i < count; ++i ) { \
+				v = (Uint16)((read) ^ flip); \
+				dst[i] = (dtype)(write); \
+			} \
+		} \
+	}
+
+#define CONVERT_SAMPLES_TO(stype, read) \
+	if ( (dst_format & 0xFF) == 8 ) { \
+		CONVERT_SAMPLES(stype, read, Uint8, v >> 8); \
+	} else if ( (dst_format & 0x1000) == (AUDIO_U16SYS & 0x1000) ) { \
+		CONVERT_SAMPLES(stype, read, Uint16, v); \
+	} else { \
+		CONVERT_SAMPLES(stype, read, Uint16, SWAP16(v)); \
+	}
+
+static void SDL_ConvertSamples(Uint8 *data, Uint16 format,
+			       Uint16 dst_format, int count)
+{
+	Uint16 flip, v;
+	int i;
+
+	flip = ((format ^ dst_format) & 0x8000) ? 0x8000 : 0;
+	if ( (format & 0xFF) == 8 ) {
+		CONVERT_SAMPLES_TO(Uint8, src[i] << 8);
+	} else if ( (format & 0x1000) == (AUDIO_U16SYS & 0x1000) ) {
+		CONVERT_SAMPLES_TO(Uint16, src[i]);
+	} else {
+		CONVERT_SAMPLES_TO(Uint16, SWAP16(src[i]));
+	}
+}
+
+#undef CONVERT_SAMPLES_TO
+#undef CONVERT_SAMPLES
+
+#ifdef SSE2_AUDIOMATRIX
+
+/* The SSE2 versions of the frame packing only cover mono and stereo
+   without a rate change on the input side, which are the usual cases.
+   x86 is little endian, so 16 bit LSB samples load directly.
+ */
+
+static void SDL_Decode8SSE2(const Uint8 *src, Uint8 flip, int channels,
+			    int frames, Sint16 planes[MAX_CHANNELS][MATRIX_BLOCK])
+{
+	__m128i f = _mm_set1_epi8((char)flip);
+	__m128i zero = _mm_setzero_si128();
+	__m128i high = _mm_set1_epi16((short)0xFF00);
+	int i, c;
+
+	i = 0;
+	if ( channels == 1 ) {
+		for ( ; i + 16 <= frames; i += 16 ) {
+			__m128i x = _mm_xor_si128(f,
+				_mm_loadu_si128((const __m128i *)(src + i)));
+			/* the byte goes in the top half of each 16 bit lane */
+			_mm_storeu_si128((__m128i *)(planes[0] + i),
+						_mm_unpacklo_epi8(zero, x));
+			_mm_storeu_si128((__m128i *)(planes[0] + i + 8),
+						_mm_unpackhi_epi8(zero, x));
+		}
+	} else {
+		for ( ; i + 8 <= frames; i += 8 ) {
+			__m128i x = _mm_xor_si128(f,
+				_mm_loadu_si128((const __m128i *)(src + i*2)));
+			/* each 16 bit lane is a frame, with right on top */
+			_mm_storeu_si128((__m128i *)(planes[0] + i),
+						_mm_slli_epi16(x, 8));
+			_mm_storeu_si128((__m128i *)(planes[1] + i),
+						_mm_and_si128(x, high));
+		}
+	}
+	for ( ; i < frames; ++i ) {
+		for ( c = 0; c < channels; ++c ) {
+			planes[c][i] = (Sint16)((src[i*channels + c] ^ flip) << 8);
+		}
+	}
+}
+
+static void SDL_Decode16SSE2(const Uint8 *src, Uint16 flip, int channels,
+			     int frames, Sint16 planes[MAX_CHANNELS][MATRIX_BLOCK])
+{
+	__m128i f = _mm_set1_epi16((short)flip);
+	int i, c;
+
+	i = 0;
+	if ( channels == 1 ) {
+		for ( ; i + 8 <= frames; i += 8 ) {
+			__m128i x = _mm_loadu_si128((const __m128i *)(src + i*2));
+			_mm_storeu_si128((__m128i *)(planes[0] + i),
+						_mm_xor_si128(x, f));
+		}
+	} else {
+		for ( ; i + 8 <= frames; i += 8 ) {
+			__m128i a = _mm_xor_si128(f,
+				_mm_loadu_si128((const __m128i *)(src + i*4)));
+			__m128i b = _mm_xor_si128(f,
+				_mm_loadu_si128((const __m128i *)(src + i*4 + 16)));
+			/* left is the low half of each frame, right the high */
+			__m128i la = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+			__m128i lb = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+			__m128i ra = _mm_srai_epi32(a, 16);
+			__m128i rb = _mm_srai_epi32(b, 16);
+			_mm_storeu_si128((__m128i *)(planes[0] + i),
+						_mm_packs_epi32(la, lb));
+			_mm_storeu_si128((__m128i *)(planes[1] + i),
+						_mm_packs_epi32(ra, rb));
+		}
+	}
+	for ( ; i < frames; ++i ) {
+		for ( c = 0; c < channels; ++c ) {
+			const Uint8 *s = src + (i*channels + c)*2;
+			planes[c][i] = (Sint16)((s[0] | (s[1] << 8)) ^ flip);
+		}
+	}
+}
+
+/* Store a vector of frames 'frame_bits' wide, each one 'repeat' times */
+static __inline__ __m128i *SDL_StoreRepeatedSSE2(__m128i *out, __m128i v,
+						 int frame_bits, int repeat)
+{
+	__m128i q[8];
+	int count, i;
+
+	/* Double the frames until they fill whole vectors.  Going down
+	   keeps q[i] from being overwritten before it's read.
+	 */
+	q[0] = v;
+	count = 1;
+	while ( (repeat > 1) && (frame_bits < 128) ) {
+		for ( i = count - 1; i >= 0; --i ) {
+			v = q[i];
+			if ( frame_bits == 16 ) {
+				q[i*2] = _mm_unpacklo_epi16(v, v);
+				q[i*2+1] = _mm_unpackhi_epi16(v, v);
+			} else if ( frame_bits == 32 ) {
+				q[i*2] = _mm_unpacklo_epi32(v, v);
+				q[i*2+1] = _mm_unpackhi_epi32(v, v);
+			} else {
+				q[i*2] = _mm_unpacklo_epi64(v, v);
+				q[i*2+1] = _mm_unpackhi_epi64(v, v);
+			}
+		}
+		count *= 2;
+		frame_bits *= 2;
+		repeat /= 2;
+	}
+	for ( i = 0; i < count*repeat; ++i ) {
+		_mm_storeu_si128(out++, q[i/repeat]);
+	}
+	return(out);
+}
+
+/* Expanded for each repeat count, so the stores above are unrolled */
+#define ENCODE16_SSE2(repeat) \
+	if ( channels == 1 ) { \
+		for ( ; i + 8 <= frames; i += 8 ) { \
+			__m128i m = _mm_xor_si128(f, \
+				_mm_loadu_si128((const __m128i *)(planes[0] + i))); \
+			out = SDL_StoreRepeatedSSE2(out, m, 16, repeat); \
+		} \
+	} else { \
+		for ( ; i + 8 <= frames; i += 8 ) { \
+			__m128i l = _mm_xor_si128(f, \
+				_mm_loadu_si128((const __m128i *)(planes[0] + i))); \
+			__m128i rt = _mm_xor_si128(f, \
+				_mm_loadu_si128((const __m128i *)(planes[1] + i))); \
+			out = SDL_StoreRepeatedSSE2(out, \
+				_mm_unpacklo_epi16(l, rt), 32, repeat); \
+			out = SDL_StoreRepeatedSSE2(out, \
+				_mm_unpackhi_epi16(l, rt), 32, repeat); \
+		} \
+	}
+
+static void SDL_Encode16SSE2(Uint8 *dst, Uint16 flip, int channels,
+			     int repeat, int frames,
+			     const Sint16 *planes[MAX_CHANNELS])
+{
+	__m128i f = _mm_set1_epi16((short)flip);
+	__m128i *out = (__m128i *)dst;
+	int i, r, c;
+
+	i = 0;
+	switch (repeat) {
+		case 1: ENCODE16_SSE2(1); break;
+		case 2: ENCODE16_SSE2(2); break;
+		case 4: ENCODE16_SSE2(4); break;
+		case 8: ENCODE16_SSE2(8); break;
+	}
+	dst = (Uint8 *)out;
+	for ( ; i < frames; ++i ) {
+		for ( r = 0; r < repeat; ++r ) {
+			for ( c = 0; c < channels; ++c ) {
+				Uint16 sample = (Uint16)planes[c][i] ^ flip;
+				dst[0] = (Uint8)(sample & 0xFF);
+				dst[1] = (Uint8)(sample >> 8);
+				dst += 2;
+			}
+		}
+	}
+}
+
+#undef ENCODE16_SSE2
+
+/* The same sums as SDL_MixPlanes(), two inputs at a time */
+static void SDL_MixPlanesSSE2(Sint16 *out, const Sint16 *in[MAX_CHANNELS],
+			      const Sint32 *gains, int count, int n)
+{
+	__m128i g[MAX_CHANNELS/2];
+	__m128i half = _mm_set1_epi32(0x4000);
+	__m128i zero = _mm_setzero_si128();
+	int i, k;
+
+	/* Each 32 bit lane holds the gains of a pair of inputs */
+	for ( k = 0; k < count; k += 2 ) {
+		Sint32 next = (k+1 < count) ? gains[k+1] : 0;
+		g[k/2] = _mm_set1_epi32((next << 16) | (gains[k] & 0xFFFF));
+	}
+	for ( i = 0; i + 8 <= n; i += 8 ) {
+		__m128i lo = half;
+		__m128i hi = half;
+
+		for ( k = 0; k < count; k += 2 ) {
+			__m128i a = _mm_loadu_si128((const __m128i *)(in[k] + i));
+			__m128i b = (k+1 < count) ?
+				_mm_loadu_si128((const __m128i *)(in[k+1] + i)) : zero;
+			lo = _mm_add_epi32(lo,
+				_mm_madd_epi16(_mm_unpacklo_epi16(a, b), g[k/2]));
+			hi = _mm_add_epi32(hi,
+				_mm_madd_epi16(_mm_unpackhi_epi16(a, b), g[k/2]));
+		}
+		/* The pack saturates, which is the clamp */
+		_mm_storeu_si128((__m128i *)(out + i),
+			_mm_packs_epi32(_mm_srai_epi32(lo, 15),
+					_mm_srai_epi32(hi, 15)));
+	}
+	for ( ; i < n; ++i ) {
+		Sint32 acc = 0x4000;
+
+		for ( k = 0; k < count; ++k ) {
+			acc += in[k][i] * gains[k];
+		}
+		acc >>= 15;
+		out[i] = (Sint16)((acc > 32767) ? 32767 :
+				  (acc < -32768) ? -32768 : acc);
+	}
+}
+
+#endif /* SSE2_AUDIOMATRIX */
+
+/* Mix 'count' input planes into one output plane.  The gains are 1.15
+   fixed point, and the sum is rounded half up and clamped.  Integer sums
+   give the same samples with and without SSE2.
+ */
+#define MIX_SAMPLE(sum) \
+	acc = (sum) >> 15; \
+	out[i] = (Sint16)((acc > 32767) ? 32767 : (acc < -32768) ? -32768 : acc)
+
+static void SDL_MixPlanes(Sint16 *out, const Sint16 *in[MAX_CHANNELS],
+			  const Sint32 *gains, int count, int n)
+{
+	const Sint16 *a, *b, *c;
+	Sint32 ga, gb, gc;
+	Sint32 acc;
+	int i, k;
+
+	if ( (count == 2) && (gains[0] == 0x4000) && (gains[1] == 0x4000) ) {
+		/* An average, like the mono downmix of stereo */
+		a = in[0];
+		b = in[1];
+		for ( i = 0; i < n; ++i ) {
+			out[i] = (Sint16)((a[i] + b[i] + 1) >> 1);
+		}
+	} else if ( count == 2 ) {
+		/* A speaker folded into another at -3 dB, and scaled */
+		a = in[0];
+		b = in[1];
+		ga = gains[0];
+		gb = gains[1];
+		for ( i = 0; i < n; ++i ) {
+			MIX_SAMPLE(a[i] * ga + b[i] * gb + 0x4000);
+		}
+	} else if ( count == 3 ) {
+		/* A front speaker with the center and a rear folded in */
+		a = in[0];
+		b = in[1];
+		c = in[2];
+		ga = gains[0];
+		gb = gains[1];
+		gc = gains[2];
+		for ( i = 0; i < n; ++i ) {
+			MIX_SAMPLE(a[i] * ga + b[i] * gb + c[i] * gc + 0x4000);
+		}
+	} else {
+		for ( i = 0; i < n; ++i ) {
+			acc = 0x4000;
+			for ( k = 0; k < count; ++k ) {
+				acc += in[k][i] * gains[k];
+			}
+			MIX_SAMPLE(acc);
+		}
+	}
+}
+
+#undef MIX_SAMPLE
+
+/* Mix native signed 16 bit frames straight from the input to the output,
+   the usual case, with the same sums as SDL_MixPlanes().  Each frame is
+   read before it is written, and the frames are walked backwards when
+   they grow, so the conversion can be done in place.
+ */
+static void SDL_MixFrames16(Sint16 *buf, int src_channels, int dst_channels,
+			    int frames, int grow, const int copy[MAX_CHANNELS],
+			    const int sources[MAX_CHANNELS][MAX_CHANNELS],
+			    const Sint32 gains[MAX_CHANNELS][MAX_CHANNELS],
+			    const int counts[MAX_CHANNELS])
+{
+	Sint16 frame[MAX_CHANNELS];
+	const Sint16 *src;
+	Sint16 *dst;
+	Sint32 acc, l, r;
+	int f, i, o, k;
+
+	if ( (src_channels == 2) && (dst_channels == 1) &&
+	     (gains[0][0] == 0x4000) && (gains[0][1] == 0x4000) ) {
+		/* The average of left and right */
+		for ( f = 0; f < frames; ++f ) {
+			buf[f] = (Sint16)((buf[f*2] + buf[f*2+1] + 1) >> 1);
+		}
+		return;
+	}
+	if ( (src_channels == 1) && (dst_channels == 2) &&
+	     (copy[0] == 0) && (copy[1] == 0) ) {
+		/* Mono played on both front speakers */
+		for ( f = frames-1; f >= 0; --f ) {
+			buf[f*2] = buf[f*2+1] = buf[f];
+		}
+		return;
+	}
+	if ( (dst_channels == 2) && (counts[0] == counts[1]) &&
+	     (counts[0] >= 2) && (counts[0] <= 4) ) {
+		/* Surround folded down to stereo, unrolled for each count
+		   with the inputs and gains kept in locals */
+		int ls[4], rs[4];
+		Sint32 lg[4], rg[4];
+
+		for ( k = 0; k < 4; ++k ) {
+			ls[k] = (k < counts[0]) ? sources[0][k] : 0;
+			rs[k] = (k < counts[0]) ? sources[1][k] : 0;
+			lg[k] = (k < counts[0]) ? gains[0][k] : 0;
+			rg[k] = (k < counts[0]) ? gains[1][k] : 0;
+		}
+#define FOLD_STEREO(count) \
+		for ( f = 0; f < frames; ++f ) { \
+			src = buf + f*src_channels; \
+			l = 0x4000; \
+			r = 0x4000; \
+			for ( k = 0; k < count; ++k ) { \
+				l += src[ls[k]] * lg[k]; \
+				r += src[rs[k]] * rg[k]; \
+			} \
+			l >>= 15; \
+			r >>= 15; \
+			buf[f*2] = (Sint16)((l > 32767) ? 32767 : \
+					(l < -32768) ? -32768 : l); \
+			buf[f*2+1] = (Sint16)((r > 32767) ? 32767 : \
+					(r < -32768) ? -32768 : r); \
+		}
+		switch (counts[0]) {
+			case 2: FOLD_STEREO(2); break;
+			case 3: FOLD_STEREO(3); break;
+			case 4: FOLD_STEREO(4); break;
+		}
+#undef FOLD_STEREO
+		return;
+	}
+	for ( f = 0; f < frames; ++f ) {
+		i = grow ? (frames-1-f) : f;
+		src = buf + i*src_channels;
+		dst = buf + i*dst_channels;
+		for ( i = 0; i < src_channels; ++i ) {
+			frame[i] = src[i];
+		}
+		for ( o = 0; o < dst_channels; ++o ) {
+			if ( counts[o] ) {
+				acc = 0x4000;
+				for ( k = 0; k < counts[o]; ++k ) {
+					acc += frame[sources[o][k]] * gains[o][k];
+				}
+				acc >>= 15;
+				dst[o] = (Sint16)((acc > 32767) ? 32767 :
+					(acc < -32768) ? -32768 : acc);
+			} else {
+				dst[o] = (copy[o] < 0) ? 0 : frame[copy[o]];
+			}
+		}
+	}
+}
+
+/* Convert the whole buffer, a block of frames at a time.  The rate is
+   changed the way SDL_RateMUL2() and SDL_RateDIV2() do it, by repeating
+   or dropping frames, so the channels are mixed at the lower rate.
+   Every block is read completely before it is written, and the blocks
+   are walked in the direction that keeps the output from overwriting
+   unread input, so the conversion can be done in place.
+ */
+static void SDL_ConvertMatrix(SDL_AudioCVT *cvt, Uint16 format,
+			      int src_channels, int dst_channels, int shift)
+{
+	float matrix[MAX_CHANNELS][MAX_CHANNELS];
+	Sint16 in[MAX_CHANNELS][MATRIX_BLOCK];
+	Sint16 out[MAX_CHANNELS][MATRIX_BLOCK];
+	const Sint16 *planes[MAX_CHANNELS];
+	const Sint16 *inputs[MAX_CHANNELS][MAX_CHANNELS];
+	Sint32 gains[MAX_CHANNELS][MAX_CHANNELS];
+	int sources[MAX_CHANNELS][MAX_CHANNELS];
+	int counts[MAX_CHANNELS];
+	int copy[MAX_CHANNELS];
+	Uint16 tail[MAX_CHANNELS];
+	int src_size, dst_size, step, repeat;
+	int frames, pos, n, tail_pos, tail_len;
+	int i, o, grow, sse2;
+	Uint16 dst_format;
+	void (*mix)(Sint16 *out, const Sint16 *in[MAX_CHANNELS],
+		    const Sint32 *gains, int count, int n);
+
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting %d channels to %d, rate shift %d\n",
+					src_channels, dst_channels, shift);
+#endif
+	/* Without mixing or a rate change, every sample is converted on its
+	   own, so the frames are handled as runs of mono samples.
+	 */
+	if ( (src_channels == dst_channels) && (shift == 0) ) {
+		src_channels = 1;
+		dst_channels = 1;
+	}
+	SDL_BuildChannelMatrix(matrix, src_channels, dst_channels);
+
+	/* Outputs that are a plain copy of one input, or silent, are not
+	   mixed, they point straight at the input plane or a silent one.
+	   The others keep a list of their inputs, with 1.15 fixed point
+	   gains that fit the 16 bit multiplies.
+	 */
+	for ( o = 0; o < dst_channels; ++o ) {
+		int count = 0, which = 0;
+
+		for ( i = 0; i < src_channels; ++i ) {
+			if ( matrix[o][i] != 0.0f ) {
+				inputs[o][count] = in[i];
+				sources[o][count] = i;
+				gains[o][count] = (Sint32)(matrix[o][i] * 32768.0f + 0.5f);
+				if ( gains[o][count] > 32767 ) {
+					gains[o][count] = 32767;
+				}
+				++count;
+				which = i;
+			}
+		}
+		counts[o] = 0;
+		copy[o] = -1;
+		if ( count == 0 ) {
+			SDL_memset(out[o], 0, sizeof(out[o]));
+			planes[o] = out[o];
+		} else if ( (count == 1) && (matrix[o][which] == 1.0f) ) {
+			copy[o] = which;
+			planes[o] = in[which];
+		} else {
+			counts[o] = count;
+			planes[o] = out[o];
+		}
+	}
+
+	mix = SDL_MixPlanes;
+	sse2 = 0;
+#ifdef SSE2_AUDIOMATRIX
+	if ( SDL_HasSSE2() ) {
+		mix = SDL_MixPlanesSSE2;
+		sse2 = 1;
+	}
+#endif
+
+	/* 'step' input frames make 'repeat' output frames */
+	step = (shift < 0) ? (1 << -shift) : 1;
+	repeat = (shift > 0) ? (1 << shift) : 1;
+	dst_format = cvt->dst_format;
+	src_size = ((format & 0xFF) / 8) * src_channels;
+	dst_size = ((dst_format & 0xFF) / 8) * dst_channels;
+	grow = (dst_size * repeat > src_size * step);
+	frames = cvt->len_cvt / (src_size * step);
+
+	/* The rate filters halve the length in bytes, so when the frames
+	   don't divide evenly they leave part of a frame at the end, from
+	   the last pass that still had a frame there.  That input frame is
+	   saved before it can be overwritten, to end the output the same way.
+	 */
+	tail_pos = frames * repeat * dst_size;
+	tail_len = 0;
+	if ( shift < 0 ) {
+		int whole = cvt->len_cvt / src_size;
+
+		tail_len = ((whole * dst_size) >> -shift) - tail_pos;
+		if ( tail_len > 0 ) {
+			i = -shift - 1;
+			while ( (whole >> i) <= frames ) {
+				--i;
+			}
+			SDL_memcpy(tail, cvt->buf + (frames << i) * src_size,
+								src_size);
+		}
+	}
+	cvt->len_cvt = tail_pos + tail_len;
+
+	if ( (src_channels == dst_channels) && (shift == 0) &&
+	     !(sse2 && ((format & 0xFF) == 8)) ) {
+		SDL_ConvertSamples(cvt->buf, format, dst_format, frames);
+		frames = 0;
+	} else if ( (shift == 0) && (src_channels != dst_channels) &&
+		    (format == AUDIO_S16SYS) && (dst_format == AUDIO_S16SYS) ) {
+		SDL_MixFrames16((Sint16 *)cvt->buf, src_channels, dst_channels,
+				frames, grow, copy, sources, gains, counts);
+		frames = 0;
+	}
+
+	pos = grow ? frames : 0;
+	while ( frames > 0 ) {
+		n = (frames < MATRIX_BLOCK) ? frames : MATRIX_BLOCK;
+		if ( grow ) {
+			pos -= n;
+		}
+
+		if ( sse2 && (step == 1) && (src_channels <= 2) &&
+		     ((format & 0x10FF) == AUDIO_U16LSB) ) {
+#ifdef SSE2_AUDIOMATRIX
+			SDL_Decode16SSE2(cvt->buf + pos * src_size,
+				(format & 0x8000) ? 0 : 0x8000,
+				src_channels, n, in);
+#endif
+		} else if ( sse2 && (step == 1) && (src_channels <= 2) &&
+			    ((format & 0xFF) == 8) ) {
+#ifdef SSE2_AUDIOMATRIX
+			SDL_Decode8SSE2(cvt->buf + pos * src_size,
+				(format & 0x8000) ? 0 : 0x80,
+				src_channels, n, in);
+#endif
+		} else {
+			SDL_DecodeFrames(cvt->buf + pos * src_size * step,
+				format, src_channels, step, n, in);
+		}
+
+		for ( o = 0; o < dst_channels; ++o ) {
+			if ( counts[o] ) {
+				mix(out[o], inputs[o], gains[o], counts[o], n);
+			}
+		}
+
+		if ( sse2 && (dst_channels <= 2) &&
+		     ((dst_format & 0x10FF) == AUDIO_U16LSB) ) {
+#ifdef SSE2_AUDIOMATRIX
+			SDL_Encode16SSE2(cvt->buf + pos * repeat * dst_size,
+				(dst_format & 0x8000) ? 0 : 0x8000,
+				dst_channels, repeat, n, planes);
+#endif
+		} else {
+			SDL_EncodeFrames(cvt->buf + pos * repeat * dst_size,
+				dst_format, dst_channels, repeat, n, planes);
+		}
+
+		if ( !grow ) {
+			pos += n;
+		}
+		frames -= n;
+	}
+
+	if ( tail_len > 0 ) {
+		Uint16 last[MAX_CHANNELS];
+
+		SDL_DecodeFrames((Uint8 *)tail, format, src_channels, 1, 1, in);
+		for ( o = 0; o < dst_channels; ++o ) {
+			if ( counts[o] ) {
+				mix(out[o], inputs[o], gains[o], counts[o], 1);
+			}
+		}
+		SDL_EncodeFrames((Uint8 *)last, dst_format, dst_channels, 1, 1,
+								planes);
+		SDL_memcpy(cvt->buf + tail_pos, last, tail_len);
+	}
+
+	format = dst_format;
+	if ( cvt->filters[++cvt->filter_index] ) {
+		cvt->filters[cvt->filter_index](cvt, format);
+	}
+}
+
+/* Filters only get the format, so there's one for each pair of layouts
+   and each rate change, from dividing by 8 (d8) to multiplying by 8 (m8).
+ */
+#define MATRIX_FILTER(src, dst, name, shift) \
+static void SDLCALL SDL_ConvertMatrix_##src##_##dst##_##name(SDL_AudioCVT *cvt, Uint16 format) \
+{ \
+	SDL_ConvertMatrix(cvt, format, src, dst, shift); \
+}
+
+#define MATRIX_FILTERS(src, dst) \
+	MATRIX_FILTER(src, dst, d8, -3) \
+	MATRIX_FILTER(src, dst, d4, -2) \
+	MATRIX_FILTER(src, dst, d2, -1) \
+	MATRIX_FILTER(src, dst, x1, 0) \
+	MATRIX_FILTER(src, dst, m2, 1) \
+	MATRIX_FILTER(src, dst, m4, 2) \
+	MATRIX_FILTER(src, dst, m8, 3)
+
+#define MATRIX_FILTER_ROW(src, dst) { \
+	SDL_ConvertMatrix_##src##_##dst##_d8, \
+	SDL_ConvertMatrix_##src##_##dst##_d4, \
+	SDL_ConvertMatrix_##src##_##dst##_d2, \
+	SDL_ConvertMatrix_##src##_##dst##_x1, \
+	SDL_ConvertMatrix_##src##_##dst##_m2, \
+	SDL_ConvertMatrix_##src##_##dst##_m4, \
+	SDL_ConvertMatrix_##src##_##dst##_m8 }
+
+#define MATRIX_FILTERS_FROM(src) \
+	MATRIX_FILTERS(src, 1) \
+	MATRIX_FILTERS(src, 2) \
+	MATRIX_FILTERS(src, 4) \
+	MATRIX_FILTERS(src, 6) \
+	MATRIX_FILTERS(src, 8)
+
+#define MATRIX_FILTER_ROWS_FROM(src) { \
+	MATRIX_FILTER_ROW(src, 1), \
+	MATRIX_FILTER_ROW(src, 2), \
+	MATRIX_FILTER_ROW(src, 4), \
+	MATRIX_FILTER_ROW(src, 6), \
+	MATRIX_FILTER_ROW(src, 8) }
+
+MATRIX_FILTERS_FROM(1)
+MATRIX_FILTERS_FROM(2)
+MATRIX_FILTERS_FROM(4)
+MATRIX_FILTERS_FROM(6)
+MATRIX_FILTERS_FROM(8)
+
+/* Indexed by channels/2, so 1 -> 0, 2 -> 1, 4 -> 2, 6 -> 3 and 8 -> 4,
+   then by the rate shift plus 3.
+ */
+static const SDL_AudioFilter matrix_filters[5][5][7] = {
+	MATRIX_FILTER_ROWS_FROM(1),
+	MATRIX_FILTER_ROWS_FROM(2),
+	MATRIX_FILTER_ROWS_FROM(4),
+	MATRIX_FILTER_ROWS_FROM(6),
+	MATRIX_FILTER_ROWS_FROM(8)
+};
+
+#undef MATRIX_FILTER
+#undef MATRIX_FILTERS
+#undef MATRIX_FILTER_ROW
+#undef MATRIX_FILTERS_FROM
+#undef MATRIX_FILTER_ROWS_FROM
+
+SDL_AudioFilter SDL_GetMatrixFilter(int src_channels, int dst_channels,
+				    int rate_shift)
+{
+	if ( (src_channels != 1 && !SDL_GetChannelLayout(src_channels)) ||
+	     (dst_channels != 1 && !SDL_GetChannelLayout(dst_channels)) ||
+	     (rate_shift < -MAX_RATE_SHIFT) || (rate_shift > MAX_RATE_SHIFT) ) {
+		return(NULL);
+	}
+	return(matrix_filters[src_channels/2][dst_channels/2][rate_shift+MAX_RATE_SHIFT]);
+}
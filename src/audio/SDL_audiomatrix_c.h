@@ -0,0 +1,41 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Audio conversion done as one pass over the audio, mixing every output
+   channel from the input channels through a matrix, and converting the
+   sample format and a power of two rate change on the way.  The channel
+   layouts are the ones used by the rest of SDL:
+	1: mono
+	2: FL FR
+	4: FL FR RL RR
+	6: FL FR C LFE RL RR
+	8: FL FR C LFE RL RR SL SR
+ */
+
+typedef void (SDLCALL *SDL_AudioFilter)(SDL_AudioCVT *cvt, Uint16 format);
+
+/* Returns a filter converting from cvt->src_format with src_channels to
+   cvt->dst_format with dst_channels, and multiplying the rate by
+   2^rate_shift, or NULL if the layouts or the rate shift aren't supported.
+ */
+extern SDL_AudioFilter SDL_GetMatrixFilter(int src_channels, int dst_channels, int rate_shift);
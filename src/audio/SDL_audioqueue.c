@@ -0,0 +1,226 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A lock free queue of audio data, for SDL_QueueAudio() and friends */
+
+#include "SDL_audio.h"
+#include "SDL_atomic.h"
+#include "SDL_audioqueue_c.h"
+
+#define AUDIO_CHUNK_SIZE	(8*1024)
+
+typedef struct SDL_AudioChunk {
+	struct SDL_AudioChunk *next;
+	Uint8 data[AUDIO_CHUNK_SIZE];
+} SDL_AudioChunk;
+
+/* The byte counts only ever grow, and are compared with wrap around, so
+   the queue can hold up to 2 GB.  All chunks but the last one are full.
+ */
+struct SDL_AudioQueue {
+	/* Owned by the writing thread */
+	SDL_AudioChunk *tail;
+	Uint32 tail_pos;
+
+	/* Owned by the reading thread */
+	SDL_AudioChunk *head;
+	Uint32 head_pos;
+
+	/* Bytes written, bytes read, and where the last clear was */
+	SDL_atomic_t written;
+	SDL_atomic_t read;
+	SDL_atomic_t cleared;
+
+	/* Chunks that have been read.  Only the reader pushes chunks, and
+	   only the writer pops them, so the stack doesn't suffer from ABA.
+	 */
+	void *pool;
+};
+
+static void SDL_PushAudioChunk(SDL_AudioQueue *queue, SDL_AudioChunk *chunk)
+{
+	void *top;
+
+	do {
+		top = SDL_AtomicGetPtr(&queue->pool);
+		chunk->next = (SDL_AudioChunk *)top;
+	} while ( !SDL_AtomicCASPtr(&queue->pool, top, chunk) );
+}
+
+static SDL_AudioChunk *SDL_PopAudioChunk(SDL_AudioQueue *queue)
+{
+	SDL_AudioChunk *chunk;
+
+	do {
+		chunk = (SDL_AudioChunk *)SDL_AtomicGetPtr(&queue->pool);
+		if ( chunk == NULL ) {
+			return (SDL_AudioChunk *)SDL_malloc(sizeof(*chunk));
+		}
+	} while ( !SDL_AtomicCASPtr(&queue->pool, chunk, chunk->next) );
+	return chunk;
+}
+
+SDL_AudioQueue *SDL_CreateAudioQueue(void)
+{
+	SDL_AudioQueue *queue;
+
+	queue = (SDL_AudioQueue *)SDL_malloc(sizeof(*queue));
+	if ( queue == NULL ) {
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	SDL_memset(queue, 0, sizeof(*queue));
+	queue->head = (SDL_AudioChunk *)SDL_malloc(sizeof(*queue->head));
+	if ( queue->head == NULL ) {
+		SDL_free(queue);
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	queue->head->next = NULL;
+	queue->tail = queue->head;
+	return queue;
+}
+
+void SDL_FreeAudioQueue(SDL_AudioQueue *queue)
+{
+	SDL_AudioChunk *chunk, *next;
+
+	for ( chunk = queue->head; chunk; chunk = next ) {
+		next = chunk->next;
+		SDL_free(chunk);
+	}
+	for ( chunk = (SDL_AudioChunk *)queue->pool; chunk; chunk = next ) {
+		next = chunk->next;
+		SDL_free(chunk);
+	}
+	SDL_free(queue);
+}
+
+int SDL_WriteAudioQueue(SDL_AudioQueue *queue, const Uint8 *data, Uint32 len)
+{
+	SDL_AudioChunk *chunk;
+	Uint32 amount;
+
+	while ( len > 0 ) {
+		if ( queue->tail_pos == AUDIO_CHUNK_SIZE ) {
+			chunk = SDL_PopAudioChunk(queue);
+			if ( chunk == NULL ) {
+				SDL_OutOfMemory();
+				return -1;
+			}
+			chunk->next = NULL;
+			queue->tail->next = chunk;
+			queue->tail = chunk;
+			queue->tail_pos = 0;
+		}
+		amount = AUDIO_CHUNK_SIZE - queue->tail_pos;
+		if ( amount > len ) {
+			amount = len;
+		}
+		SDL_memcpy(queue->tail->data + queue->tail_pos, data, amount);
+		queue->tail_pos += amount;
+		data += amount;
+		len -= amount;
+
+		/* Hand the data, and the chunk it is in, over to the reader */
+		SDL_AtomicAdd(&queue->written, (int)amount);
+	}
+	return 0;
+}
+
+/* Copy data out of the queue, or skip over it if 'data' is NULL */
+static void SDL_TakeAudioQueue(SDL_AudioQueue *queue, Uint8 *data, Uint32 len)
+{
+	SDL_AudioChunk *chunk;
+	Uint32 amount;
+
+	while ( len > 0 ) {
+		if ( queue->head_pos == AUDIO_CHUNK_SIZE ) {
+			/* The writer has moved on to the next chunk */
+			chunk = queue->head;
+			queue->head = chunk->next;
+			queue->head_pos = 0;
+			SDL_PushAudioChunk(queue, chunk);
+		}
+		amount = AUDIO_CHUNK_SIZE - queue->head_pos;
+		if ( amount > len ) {
+			amount = len;
+		}
+		if ( data ) {
+			SDL_memcpy(data, queue->head->data + queue->head_pos, amount);
+			data += amount;
+		}
+		queue->head_pos += amount;
+		len -= amount;
+	}
+}
+
+Uint32 SDL_ReadAudioQueue(SDL_AudioQueue *queue, Uint8 *data, Uint32 len)
+{
+	Uint32 start, avail, skip;
+
+	start = (Uint32)SDL_AtomicGet(&queue->read);
+	skip = (Uint32)SDL_AtomicGet(&queue->cleared) - start;
+	avail = (Uint32)SDL_AtomicGet(&queue->written) - start;
+
+	/* Drop the data that was queued before the last clear */
+	if ( (Sint32)skip > 0 ) {
+		SDL_TakeAudioQueue(queue, NULL, skip);
+		start += skip;
+		avail -= skip;
+	}
+	if ( len > avail ) {
+		len = avail;
+	}
+	SDL_TakeAudioQueue(queue, data, len);
+	SDL_AtomicStore(&queue->read, (int)(start + len));
+	return len;
+}
+
+Uint32 SDL_GetAudioQueueSize(SDL_AudioQueue *queue)
+{
+	Uint32 start, cleared;
+
+	/* Read the counts in this order, so 'written' is the newest */
+	start = (Uint32)SDL_AtomicGet(&queue->read);
+	cleared = (Uint32)SDL_AtomicGet(&queue->cleared);
+	if ( (Sint32)(cleared - start) > 0 ) {
+		start = cleared;
+	}
+	return (Uint32)SDL_AtomicGet(&queue->written) - start;
+}
+
+void SDL_ClearAudioQueue(SDL_AudioQueue *queue)
+{
+	int cleared, written;
+
+	/* The reader skips everything written so far, the clear point
+	   only moves forward if several threads clear at once */
+	do {
+		cleared = SDL_AtomicGet(&queue->cleared);
+		written = SDL_AtomicGet(&queue->written);
+		if ( (Sint32)((Uint32)written - (Uint32)cleared) <= 0 ) {
+			break;
+		}
+	} while ( !SDL_AtomicCAS(&queue->cleared, cleared, written) );
+}
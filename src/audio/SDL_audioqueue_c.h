@@ -0,0 +1,43 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A queue of audio data passed from one writing thread to one reading
+   thread, without locks.  The data is kept in a chain of fixed size
+   chunks, and chunks that have been read are pooled for the writer.
+ */
+typedef struct SDL_AudioQueue SDL_AudioQueue;
+
+extern SDL_AudioQueue *SDL_CreateAudioQueue(void);
+
+/* Free a queue, once neither thread is using it */
+extern void SDL_FreeAudioQueue(SDL_AudioQueue *queue);
+
+/* Called by the writing thread, returns 0 or -1 if out of memory */
+extern int SDL_WriteAudioQueue(SDL_AudioQueue *queue, const Uint8 *data, Uint32 len);
+
+/* Called by the reading thread, returns the number of bytes read */
+extern Uint32 SDL_ReadAudioQueue(SDL_AudioQueue *queue, Uint8 *data, Uint32 len);
+
+/* These can be called from any thread */
+extern Uint32 SDL_GetAudioQueueSize(SDL_AudioQueue *queue);
+extern void SDL_ClearAudioQueue(SDL_AudioQueue *queue);
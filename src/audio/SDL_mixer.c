@@ -94,9 +94,6 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 {
 	Uint16 format;
 
-	if ( volume == 0 ) {
-		return;
-	}
 	/* Mix the user-level audio format */
 	if ( current_audio ) {
 		if ( current_audio->convert.needed ) {
@@ -108,6 +105,14 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
   		/* HACK HACK HACK */
 		format = AUDIO_S16;
 	}
+	SDL_MixAudioFormat(dst, src, format, len, volume);
+}
+
+void SDL_MixAudioFormat (Uint8 *dst, const Uint8 *src, Uint16 format, Uint32 len, int volume)
+{
+	if ( volume == 0 ) {
+		return;
+	}
 	switch (format) {
 
 		case AUDIO_U8: {
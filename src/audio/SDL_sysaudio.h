@@ -26,6 +26,7 @@
 
 #include "SDL_mutex.h"
 #include "SDL_thread.h"
+#include "SDL_atomic.h"
 
 /* The SDL audio driver */
 typedef struct SDL_AudioDevice SDL_AudioDevice;
@@ -54,6 +55,18 @@ struct SDL_AudioDevice {
 	void (*WaitDone)(_THIS);
 	void (*CloseAudio)(_THIS);
 
+	/* Read up to 'len' bytes of captured audio, waiting for it to be
+	   available, and return the number of bytes read, or -1 on error.
+	   Only drivers that support capture devices set this.
+	 */
+	int (*CaptureAudio)(_THIS, Uint8 *buf, int len);
+
+	/* Return the number of sample frames written to the device and not
+	   yet played, or recorded and not yet read, or -1 if it can't tell.
+	   This is called by the audio thread after each buffer.
+	 */
+	int (*GetDelay)(_THIS);
+
 	/* * * */
 	/* Lock / Unlock functions added for the Mac port */
 	void (*LockAudio)(_THIS);
@@ -70,14 +83,44 @@ struct SDL_AudioDevice {
 	/* An audio conversion block for audio format emulation */
 	SDL_AudioCVT convert;
 
+	/* The device name passed to SDL_OpenAudioDevice(), or NULL */
+	char *devname;
+
+	/* Set if this device records audio instead of playing it */
+	int iscapture;
+
 	/* Current state flags */
 	int enabled;
 	int paused;
 	int opened;
 
+	/* Set by drivers that aren't paced by real time, so the audio thread
+	   waits while the device is paused instead of playing silence */
+	int waitpaused;
+
+	/* Set by drivers that keep all their state in 'hidden', so several
+	   instances can be open at once.  Others are limited to one. */
+	int multiopen;
+
 	/* Fake audio buffer for when the audio hardware is busy */
 	Uint8 *fake_stream;
 
+	/* The audio queue used when the device has no callback */
+	struct SDL_AudioQueue *queue;
+
+	/* Milliseconds of audio played, by the sample clock */
+	volatile Uint32 ticks;
+
+	/* Where the device was after the last buffer, and how the buffers
+	   have been keeping up, for the application
+	 */
+	SDL_SpinLock status_lock;
+	SDL_AudioPosition position;
+	SDL_AudioStats stats;
+
+	/* Underruns or overruns seen by the driver, on the audio thread */
+	Uint32 underruns;
+
 	/* A semaphore for locking the mixing buffers */
 	SDL_mutex *mixer_lock;
 
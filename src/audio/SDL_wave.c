@@ -35,28 +35,28 @@ struct MS_ADPCM_decodestate {
 	Sint16 iSamp1;
 	Sint16 iSamp2;
 };
-static struct MS_ADPCM_decoder {
+struct MS_ADPCM_decoder {
 	WaveFMT wavefmt;
 	Uint16 wSamplesPerBlock;
 	Uint16 wNumCoef;
 	Sint16 aCoeff[7][2];
 	/* * * */
 	struct MS_ADPCM_decodestate state[2];
-} MS_ADPCM_state;
+};
 
-static int InitMS_ADPCM(WaveFMT *format, int length)
+static int InitMS_ADPCM(struct MS_ADPCM_decoder *dec, WaveFMT *format, int length)
 {
 	Uint8 *rogue_feel, *rogue_feel_end;
 	int i;
 
 	/* Set the rogue pointer to the MS_ADPCM specific data */
 	if (length < sizeof(*format)) goto too_short;
-	MS_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-	MS_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-	MS_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-	MS_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-	MS_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-	MS_ADPCM_state.wavefmt.bitspersample =
+	dec->wavefmt.encoding = SDL_SwapLE16(format->encoding);
+	dec->wavefmt.channels = SDL_SwapLE16(format->channels);
+	dec->wavefmt.frequency = SDL_SwapLE32(format->frequency);
+	dec->wavefmt.byterate = SDL_SwapLE32(format->byterate);
+	dec->wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
+	dec->wavefmt.bitspersample =
 					 SDL_SwapLE16(format->bitspersample);
 	rogue_feel = (Uint8 *)format+sizeof(*format);
 	rogue_feel_end = (Uint8 *)format + length;
@@ -64,21 +64,34 @@ static int InitMS_ADPCM(WaveFMT *format, int length)
 		rogue_feel += sizeof(Uint16);
 	}
 	if (rogue_feel + 4 > rogue_feel_end) goto too_short;
-	MS_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	dec->wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
 	rogue_feel += sizeof(Uint16);
-	MS_ADPCM_state.wNumCoef = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	dec->wNumCoef = ((rogue_feel[1]<<8)|rogue_feel[0]);
 	rogue_feel += sizeof(Uint16);
-	if ( MS_ADPCM_state.wNumCoef != 7 ) {
+	if ( dec->wNumCoef != 7 ) {
 		SDL_SetError("Unknown set of MS_ADPCM coefficients");
 		return(-1);
 	}
-	for ( i=0; i<MS_ADPCM_state.wNumCoef; ++i ) {
+	for ( i=0; i<dec->wNumCoef; ++i ) {
 		if (rogue_feel + 4 > rogue_feel_end) goto too_short;
-		MS_ADPCM_state.aCoeff[i][0] = ((rogue_feel[1]<<8)|rogue_feel[0]);
+		dec->aCoeff[i][0] = ((rogue_feel[1]<<8)|rogue_feel[0]);
 		rogue_feel += sizeof(Uint16);
-		MS_ADPCM_state.aCoeff[i][1] = ((rogue_feel[1]<<8)|rogue_feel[0]);
+		dec->aCoeff[i][1] = ((rogue_feel[1]<<8)|rogue_feel[0]);
 		rogue_feel += sizeof(Uint16);
 	}
+
+	/* Every block must hold its header and all of its samples */
+	if ( (dec->wavefmt.channels < 1) || (dec->wavefmt.channels > 2) ) {
+		SDL_SetError("MS ADPCM decoder can only handle 1 or 2 channels");
+		return(-1);
+	}
+	if ( (dec->wSamplesPerBlock < 2) ||
+	     ((7 * dec->wavefmt.channels) +
+	      ((dec->wSamplesPerBlock-2) * dec->wavefmt.channels + 1) / 2
+				> dec->wavefmt.blockalign) ) {
+		SDL_SetError("Invalid block size for a MS ADPCM decoder");
+		return(-1);
+	}
 	return(0);
 too_short:
 	SDL_SetError("Unexpected length of a chunk with a MS ADPCM format");
@@ -119,146 +132,151 @@ static Sint32 MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
 	return(new_sample);
 }
 
-static int MS_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
+/* Decode one block of 'blockalign' bytes into wSamplesPerBlock frames */
+static int MS_ADPCM_decodeblock(struct MS_ADPCM_decoder *dec,
+				const Uint8 *encoded, Uint8 *decoded)
 {
 	struct MS_ADPCM_decodestate *state[2];
-	Uint8 *freeable, *encoded, *encoded_end, *decoded, *decoded_end;
-	Sint32 encoded_len, samplesleft;
+	Sint32 samplesleft;
 	Sint8 nybble, stereo;
 	Sint16 *coeff[2];
 	Sint32 new_sample;
 
+	stereo = (dec->wavefmt.channels == 2);
+	state[0] = &dec->state[0];
+	state[1] = &dec->state[stereo];
+
+	/* Grab the initial information for this block */
+	state[0]->hPredictor = *encoded++;
+	if ( stereo ) {
+		state[1]->hPredictor = *encoded++;
+	}
+	if (state[0]->hPredictor >= 7 || state[1]->hPredictor >= 7) {
+		SDL_SetError("Invalid predictor value for a MS ADPCM decoder");
+		return(-1);
+	}
+	state[0]->iDelta = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iDelta = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	state[0]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	state[0]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	coeff[0] = dec->aCoeff[state[0]->hPredictor];
+	coeff[1] = dec->aCoeff[state[1]->hPredictor];
+
+	/* Store the two initial samples we start with */
+	decoded[0] = state[0]->iSamp2&0xFF;
+	decoded[1] = state[0]->iSamp2>>8;
+	decoded += 2;
+	if ( stereo ) {
+		decoded[0] = state[1]->iSamp2&0xFF;
+		decoded[1] = state[1]->iSamp2>>8;
+		decoded += 2;
+	}
+	decoded[0] = state[0]->iSamp1&0xFF;
+	decoded[1] = state[0]->iSamp1>>8;
+	decoded += 2;
+	if ( stereo ) {
+		decoded[0] = state[1]->iSamp1&0xFF;
+		decoded[1] = state[1]->iSamp1>>8;
+		decoded += 2;
+	}
+
+	/* Decode and store the other samples in this block */
+	samplesleft = (dec->wSamplesPerBlock-2)*dec->wavefmt.channels;
+	while ( samplesleft > 0 ) {
+		nybble = (*encoded)>>4;
+		new_sample = MS_ADPCM_nibble(state[0],nybble,coeff[0]);
+		decoded[0] = new_sample&0xFF;
+		new_sample >>= 8;
+		decoded[1] = new_sample&0xFF;
+		decoded += 2;
+		if ( --samplesleft == 0 ) {
+			break;
+		}
+
+		nybble = (*encoded)&0x0F;
+		new_sample = MS_ADPCM_nibble(state[1],nybble,coeff[1]);
+		decoded[0] = new_sample&0xFF;
+		new_sample >>= 8;
+		decoded[1] = new_sample&0xFF;
+		decoded += 2;
+
+		++encoded;
+		--samplesleft;
+	}
+	return(0);
+}
+
+static int MS_ADPCM_decode(struct MS_ADPCM_decoder *dec,
+				Uint8 **audio_buf, Uint32 *audio_len)
+{
+	Uint8 *freeable, *encoded, *decoded;
+	Sint32 encoded_len, decoded_blocklen;
+
 	/* Allocate the proper sized output buffer */
 	encoded_len = *audio_len;
 	encoded = *audio_buf;
-	encoded_end = encoded + encoded_len;
 	freeable = *audio_buf;
-	*audio_len = (encoded_len/MS_ADPCM_state.wavefmt.blockalign) * 
-				MS_ADPCM_state.wSamplesPerBlock*
-				MS_ADPCM_state.wavefmt.channels*sizeof(Sint16);
+	decoded_blocklen = dec->wSamplesPerBlock*
+				dec->wavefmt.channels*sizeof(Sint16);
+	*audio_len = (encoded_len/dec->wavefmt.blockalign) * decoded_blocklen;
 	*audio_buf = (Uint8 *)SDL_malloc(*audio_len);
 	if ( *audio_buf == NULL ) {
 		SDL_Error(SDL_ENOMEM);
 		return(-1);
 	}
 	decoded = *audio_buf;
-	decoded_end = decoded + *audio_len;
 
 	/* Get ready... Go! */
-	stereo = (MS_ADPCM_state.wavefmt.channels == 2);
-	state[0] = &MS_ADPCM_state.state[0];
-	state[1] = &MS_ADPCM_state.state[stereo];
-	while ( encoded_len >= MS_ADPCM_state.wavefmt.blockalign ) {
-		/* Grab the initial information for this block */
-		if (encoded + 7 + (stereo ? 7 : 0) > encoded_end) goto invalid_size;
-		state[0]->hPredictor = *encoded++;
-		if ( stereo ) {
-			state[1]->hPredictor = *encoded++;
-		}
-		if (state[0]->hPredictor >= 7 || state[1]->hPredictor >= 7) {
-			goto invalid_predictor;
-		}
-		state[0]->iDelta = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iDelta = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
-		}
-		state[0]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
-		}
-		state[0]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
+	while ( encoded_len >= dec->wavefmt.blockalign ) {
+		if ( MS_ADPCM_decodeblock(dec, encoded, decoded) < 0 ) {
+			SDL_free(freeable);
+			return(-1);
 		}
-		coeff[0] = MS_ADPCM_state.aCoeff[state[0]->hPredictor];
-		coeff[1] = MS_ADPCM_state.aCoeff[state[1]->hPredictor];
-
-		/* Store the two initial samples we start with */
-		if (decoded + 4 + (stereo ? 4 : 0) > decoded_end) goto invalid_size;
-		decoded[0] = state[0]->iSamp2&0xFF;
-		decoded[1] = state[0]->iSamp2>>8;
-		decoded += 2;
-		if ( stereo ) {
-			decoded[0] = state[1]->iSamp2&0xFF;
-			decoded[1] = state[1]->iSamp2>>8;
-			decoded += 2;
-		}
-		decoded[0] = state[0]->iSamp1&0xFF;
-		decoded[1] = state[0]->iSamp1>>8;
-		decoded += 2;
-		if ( stereo ) {
-			decoded[0] = state[1]->iSamp1&0xFF;
-			decoded[1] = state[1]->iSamp1>>8;
-			decoded += 2;
-		}
-
-		/* Decode and store the other samples in this block */
-		samplesleft = (MS_ADPCM_state.wSamplesPerBlock-2)*
-					MS_ADPCM_state.wavefmt.channels;
-		while ( samplesleft > 0 ) {
-			if (encoded + 1 > encoded_end) goto invalid_size;
-			if (decoded + 4 > decoded_end) goto invalid_size;
-
-			nybble = (*encoded)>>4;
-			new_sample = MS_ADPCM_nibble(state[0],nybble,coeff[0]);
-			decoded[0] = new_sample&0xFF;
-			new_sample >>= 8;
-			decoded[1] = new_sample&0xFF;
-			decoded += 2;
-
-			nybble = (*encoded)&0x0F;
-			new_sample = MS_ADPCM_nibble(state[1],nybble,coeff[1]);
-			decoded[0] = new_sample&0xFF;
-			new_sample >>= 8;
-			decoded[1] = new_sample&0xFF;
-			decoded += 2;
-
-			++encoded;
-			samplesleft -= 2;
-		}
-		encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
+		encoded += dec->wavefmt.blockalign;
+		encoded_len -= dec->wavefmt.blockalign;
+		decoded += decoded_blocklen;
 	}
 	SDL_free(freeable);
 	return(0);
-invalid_size:
-	SDL_SetError("Unexpected chunk length for a MS ADPCM decoder");
-	SDL_free(freeable);
-	return(-1);
-invalid_predictor:
-	SDL_SetError("Invalid predictor value for a MS ADPCM decoder");
-	SDL_free(freeable);
-	return(-1);
 }
 
 struct IMA_ADPCM_decodestate {
 	Sint32 sample;
 	Sint8 index;
 };
-static struct IMA_ADPCM_decoder {
+struct IMA_ADPCM_decoder {
 	WaveFMT wavefmt;
 	Uint16 wSamplesPerBlock;
 	/* * * */
 	struct IMA_ADPCM_decodestate state[2];
-} IMA_ADPCM_state;
+};
 
-static int InitIMA_ADPCM(WaveFMT *format, int length)
+static int InitIMA_ADPCM(struct IMA_ADPCM_decoder *dec, WaveFMT *format, int length)
 {
 	Uint8 *rogue_feel, *rogue_feel_end;
 
 	/* Set the rogue pointer to the IMA_ADPCM specific data */
 	if (length < sizeof(*format)) goto too_short;
-	IMA_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-	IMA_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-	IMA_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-	IMA_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-	IMA_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-	IMA_ADPCM_state.wavefmt.bitspersample =
+	dec->wavefmt.encoding = SDL_SwapLE16(format->encoding);
+	dec->wavefmt.channels = SDL_SwapLE16(format->channels);
+	dec->wavefmt.frequency = SDL_SwapLE32(format->frequency);
+	dec->wavefmt.byterate = SDL_SwapLE32(format->byterate);
+	dec->wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
+	dec->wavefmt.bitspersample =
 					 SDL_SwapLE16(format->bitspersample);
 	rogue_feel = (Uint8 *)format+sizeof(*format);
 	rogue_feel_end = (Uint8 *)format + length;
@@ -266,7 +284,24 @@ static int InitIMA_ADPCM(WaveFMT *format, int length)
 		rogue_feel += sizeof(Uint16);
 	}
 	if (rogue_feel + 2 > rogue_feel_end) goto too_short;
-	IMA_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	dec->wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+
+	/* Check to make sure we have enough variables in the state array */
+	if ( (dec->wavefmt.channels < 1) ||
+	     (dec->wavefmt.channels > SDL_arraysize(dec->state)) ) {
+		SDL_SetError("IMA ADPCM decoder can only handle %d channels",
+					SDL_arraysize(dec->state));
+		return(-1);
+	}
+	/* Every block must hold its header and whole groups of 8 samples */
+	if ( (dec->wSamplesPerBlock < 1) ||
+	     (((dec->wSamplesPerBlock-1) % 8) != 0) ||
+	     ((4 * dec->wavefmt.channels) +
+	      ((dec->wSamplesPerBlock-1) * dec->wavefmt.channels) / 2
+				> dec->wavefmt.blockalign) ) {
+		SDL_SetError("Invalid block size for an IMA ADPCM decoder");
+		return(-1);
+	}
 	return(0);
 too_short:
 	SDL_SetError("Unexpected length of a chunk with an IMA ADPCM format");
@@ -326,7 +361,7 @@ static Sint32 IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state,Uint8 nybble)
 }
 
 /* Fill the decode buffer with a channel block of data (8 samples) */
-static void Fill_IMA_ADPCM_block(Uint8 *decoded, Uint8 *encoded,
+static void Fill_IMA_ADPCM_block(Uint8 *decoded, const Uint8 *encoded,
 	int channel, int numchannels, struct IMA_ADPCM_decodestate *state)
 {
 	int i;
@@ -353,84 +388,150 @@ static void Fill_IMA_ADPCM_block(Uint8 *decoded, Uint8 *encoded,
 	}
 }
 
-static int IMA_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
+/* Decode one block of 'blockalign' bytes into wSamplesPerBlock frames */
+static int IMA_ADPCM_decodeblock(struct IMA_ADPCM_decoder *dec,
+				const Uint8 *encoded, Uint8 *decoded)
 {
 	struct IMA_ADPCM_decodestate *state;
-	Uint8 *freeable, *encoded, *encoded_end, *decoded, *decoded_end;
-	Sint32 encoded_len, samplesleft;
+	Sint32 samplesleft;
 	unsigned int c, channels;
 
-	/* Check to make sure we have enough variables in the state array */
-	channels = IMA_ADPCM_state.wavefmt.channels;
-	if ( channels > SDL_arraysize(IMA_ADPCM_state.state) ) {
-		SDL_SetError("IMA ADPCM decoder can only handle %d channels",
-					SDL_arraysize(IMA_ADPCM_state.state));
-		return(-1);
+	channels = dec->wavefmt.channels;
+	state = dec->state;
+
+	/* Grab the initial information for this block */
+	for ( c=0; c<channels; ++c ) {
+		/* Fill the state information for this block */
+		state[c].sample = ((encoded[1]<<8)|encoded[0]);
+		encoded += 2;
+		if ( state[c].sample & 0x8000 ) {
+			state[c].sample -= 0x10000;
+		}
+		state[c].index = *encoded++;
+		/* Reserved byte in buffer header, should be 0 */
+		if ( *encoded++ != 0 ) {
+			/* Uh oh, corrupt data?  Buggy code? */;
+		}
+
+		/* Store the initial sample we start with */
+		decoded[0] = (Uint8)(state[c].sample&0xFF);
+		decoded[1] = (Uint8)(state[c].sample>>8);
+		decoded += 2;
+	}
+
+	/* Decode and store the other samples in this block */
+	samplesleft = (dec->wSamplesPerBlock-1)*channels;
+	while ( samplesleft > 0 ) {
+		for ( c=0; c<channels; ++c ) {
+			Fill_IMA_ADPCM_block(decoded, encoded,
+					c, channels, &state[c]);
+			encoded += 4;
+			samplesleft -= 8;
+		}
+		decoded += (channels * 8 * 2);
 	}
-	state = IMA_ADPCM_state.state;
+	return(0);
+}
+
+static int IMA_ADPCM_decode(struct IMA_ADPCM_decoder *dec,
+				Uint8 **audio_buf, Uint32 *audio_len)
+{
+	Uint8 *freeable, *encoded, *decoded;
+	Sint32 encoded_len, decoded_blocklen;
 
 	/* Allocate the proper sized output buffer */
 	encoded_len = *audio_len;
 	encoded = *audio_buf;
-	encoded_end = encoded + encoded_len;
 	freeable = *audio_buf;
-	*audio_len = (encoded_len/IMA_ADPCM_state.wavefmt.blockalign) * 
-				IMA_ADPCM_state.wSamplesPerBlock*
-				IMA_ADPCM_state.wavefmt.channels*sizeof(Sint16);
+	decoded_blocklen = dec->wSamplesPerBlock*
+				dec->wavefmt.channels*sizeof(Sint16);
+	*audio_len = (encoded_len/dec->wavefmt.blockalign) * decoded_blocklen;
 	*audio_buf = (Uint8 *)SDL_malloc(*audio_len);
 	if ( *audio_buf == NULL ) {
 		SDL_Error(SDL_ENOMEM);
 		return(-1);
 	}
 	decoded = *audio_buf;
-	decoded_end = decoded + *audio_len;
 
 	/* Get ready... Go! */
-	while ( encoded_len >= IMA_ADPCM_state.wavefmt.blockalign ) {
-		/* Grab the initial information for this block */
-		for ( c=0; c<channels; ++c ) {
-			if (encoded + 4 > encoded_end) goto invalid_size;
-			/* Fill the state information for this block */
-			state[c].sample = ((encoded[1]<<8)|encoded[0]);
-			encoded += 2;
-			if ( state[c].sample & 0x8000 ) {
-				state[c].sample -= 0x10000;
-			}
-			state[c].index = *encoded++;
-			/* Reserved byte in buffer header, should be 0 */
-			if ( *encoded++ != 0 ) {
-				/* Uh oh, corrupt data?  Buggy code? */;
-			}
+	while ( encoded_len >= dec->wavefmt.blockalign ) {
+		IMA_ADPCM_decodeblock(dec, encoded, decoded);
+		encoded += dec->wavefmt.blockalign;
+		encoded_len -= dec->wavefmt.blockalign;
+		decoded += decoded_blocklen;
+	}
+	SDL_free(freeable);
+	return(0);
+}
 
-			/* Store the initial sample we start with */
-			if (decoded + 2 > decoded_end) goto invalid_size;
-			decoded[0] = (Uint8)(state[c].sample&0xFF);
-			decoded[1] = (Uint8)(state[c].sample>>8);
-			decoded += 2;
-		}
+/* Decode the audio data format chunk into 'spec', setting up the ADPCM
+   decoder if needed.  Returns the format encoding, or -1 on error.
+ */
+static int ReadFormat(WaveFMT *format, int lenread, SDL_AudioSpec *spec,
+	struct MS_ADPCM_decoder *MS_ADPCM_state,
+	struct IMA_ADPCM_decoder *IMA_ADPCM_state)
+{
+	int encoding;
+	int was_error;
 
-		/* Decode and store the other samples in this block */
-		samplesleft = (IMA_ADPCM_state.wSamplesPerBlock-1)*channels;
-		while ( samplesleft > 0 ) {
-			for ( c=0; c<channels; ++c ) {
-				if (encoded + 4 > encoded_end) goto invalid_size;
-				if (decoded + 4 * 4 * channels > decoded_end)
-					goto invalid_size;
-				Fill_IMA_ADPCM_block(decoded, encoded,
-						c, channels, &state[c]);
-				encoded += 4;
-				samplesleft -= 8;
+	if ( lenread < sizeof(*format) ) {
+		SDL_SetError("Unexpected length of a WAVE format chunk");
+		return(-1);
+	}
+	encoding = SDL_SwapLE16(format->encoding);
+	switch (encoding) {
+		case PCM_CODE:
+			/* We can understand this */
+			break;
+		case MS_ADPCM_CODE:
+			/* Try to understand this */
+			if ( InitMS_ADPCM(MS_ADPCM_state, format, lenread) < 0 ) {
+				return(-1);
 			}
-			decoded += (channels * 8 * 2);
-		}
-		encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
+			break;
+		case IMA_ADPCM_CODE:
+			/* Try to understand this */
+			if ( InitIMA_ADPCM(IMA_ADPCM_state, format, lenread) < 0 ) {
+				return(-1);
+			}
+			break;
+		case MP3_CODE:
+			SDL_SetError("MPEG Layer 3 data not supported",
+					SDL_SwapLE16(format->encoding));
+			return(-1);
+		default:
+			SDL_SetError("Unknown WAVE data format: 0x%.4x",
+					SDL_SwapLE16(format->encoding));
+			return(-1);
 	}
-	SDL_free(freeable);
-	return(0);
-invalid_size:
-	SDL_SetError("Unexpected chunk length for an IMA ADPCM decoder");
-	SDL_free(freeable);
-	return(-1);
+	was_error = 0;
+	SDL_memset(spec, 0, (sizeof *spec));
+	spec->freq = SDL_SwapLE32(format->frequency);
+	switch (SDL_SwapLE16(format->bitspersample)) {
+		case 4:
+			if ( encoding != PCM_CODE ) {
+				spec->format = AUDIO_S16;
+			} else {
+				was_error = 1;
+			}
+			break;
+		case 8:
+			spec->format = AUDIO_U8;
+			break;
+		case 16:
+			spec->format = AUDIO_S16;
+			break;
+		default:
+			was_error = 1;
+			break;
+	}
+	if ( was_error ) {
+		SDL_SetError("Unknown %d-bit PCM data format",
+			SDL_SwapLE16(format->bitspersample));
+		return(-1);
+	}
+	spec->channels = (Uint8)SDL_SwapLE16(format->channels);
+	return(encoding);
 }
 
 SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
@@ -440,6 +541,8 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 	Chunk chunk;
 	int lenread;
 	int MS_ADPCM_encoded, IMA_ADPCM_encoded;
+	struct MS_ADPCM_decoder MS_ADPCM_state;
+	struct IMA_ADPCM_decoder IMA_ADPCM_state;
 	int samplesize;
 
 	/* WAV magic header */
@@ -499,63 +602,20 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 		goto done;
 	}
 	MS_ADPCM_encoded = IMA_ADPCM_encoded = 0;
-	switch (SDL_SwapLE16(format->encoding)) {
+	switch (ReadFormat(format, lenread, spec,
+				&MS_ADPCM_state, &IMA_ADPCM_state)) {
 		case PCM_CODE:
-			/* We can understand this */
 			break;
 		case MS_ADPCM_CODE:
-			/* Try to understand this */
-			if ( InitMS_ADPCM(format, lenread) < 0 ) {
-				was_error = 1;
-				goto done;
-			}
 			MS_ADPCM_encoded = 1;
 			break;
 		case IMA_ADPCM_CODE:
-			/* Try to understand this */
-			if ( InitIMA_ADPCM(format, lenread) < 0 ) {
-				was_error = 1;
-				goto done;
-			}
 			IMA_ADPCM_encoded = 1;
 			break;
-		case MP3_CODE:
-			SDL_SetError("MPEG Layer 3 data not supported",
-					SDL_SwapLE16(format->encoding));
-			was_error = 1;
-			goto done;
 		default:
-			SDL_SetError("Unknown WAVE data format: 0x%.4x",
-					SDL_SwapLE16(format->encoding));
 			was_error = 1;
 			goto done;
 	}
-	SDL_memset(spec, 0, (sizeof *spec));
-	spec->freq = SDL_SwapLE32(format->frequency);
-	switch (SDL_SwapLE16(format->bitspersample)) {
-		case 4:
-			if ( MS_ADPCM_encoded || IMA_ADPCM_encoded ) {
-				spec->format = AUDIO_S16;
-			} else {
-				was_error = 1;
-			}
-			break;
-		case 8:
-			spec->format = AUDIO_U8;
-			break;
-		case 16:
-			spec->format = AUDIO_S16;
-			break;
-		default:
-			was_error = 1;
-			break;
-	}
-	if ( was_error ) {
-		SDL_SetError("Unknown %d-bit PCM data format",
-			SDL_SwapLE16(format->bitspersample));
-		goto done;
-	}
-	spec->channels = (Uint8)SDL_SwapLE16(format->channels);
 	spec->samples = 4096;		/* Good default buffer size */
 
 	/* Read the audio data chunk */
@@ -577,13 +637,13 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 	headerDiff += 2 * sizeof(Uint32); /* for the data chunk and len */
 
 	if ( MS_ADPCM_encoded ) {
-		if ( MS_ADPCM_decode(audio_buf, audio_len) < 0 ) {
+		if ( MS_ADPCM_decode(&MS_ADPCM_state, audio_buf, audio_len) < 0 ) {
 			was_error = 1;
 			goto done;
 		}
 	}
 	if ( IMA_ADPCM_encoded ) {
-		if ( IMA_ADPCM_decode(audio_buf, audio_len) < 0 ) {
+		if ( IMA_ADPCM_decode(&IMA_ADPCM_state, audio_buf, audio_len) < 0 ) {
 			was_error = 1;
 			goto done;
 		}
@@ -621,10 +681,283 @@ void SDL_FreeWAV(Uint8 *audio_buf)
 	}
 }
 
+/* The state of a WAVE file being decoded block by block */
+struct SDL_WAVStream {
+	SDL_RWops *src;
+	int freesrc;
+	int encoding;
+	struct MS_ADPCM_decoder MS_ADPCM_state;
+	struct IMA_ADPCM_decoder IMA_ADPCM_state;
+
+	int data_start;		/* Offset of the audio data in the source */
+	Uint32 frames;		/* Number of sample frames in the stream */
+	Uint32 position;	/* The next frame to be read */
+	int framesize;		/* Bytes per decoded sample frame */
+
+	/* ADPCM streams are decoded one block at a time */
+	int blockalign;
+	Uint32 blockframes;
+	Uint8 *encoded;
+	Uint8 *decoded;
+	int decoded_pos;
+	int decoded_len;
+};
+
+SDL_WAVStream * SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc,
+				SDL_AudioSpec *spec, Uint32 *frames)
+{
+	SDL_WAVStream *stream;
+	Uint32 header[3];
+	Uint32 datalen;
+	Chunk chunk;
+	int lenread;
+	int has_format;
+
+	/* Make sure we are passed a valid data source */
+	if ( src == NULL ) {
+		return(NULL);
+	}
+	stream = (SDL_WAVStream *)SDL_malloc(sizeof(*stream));
+	if ( stream == NULL ) {
+		SDL_OutOfMemory();
+		goto error;
+	}
+	SDL_memset(stream, 0, (sizeof *stream));
+
+	/* Check the magic header */
+	if ( SDL_ReadLE32Array(src, header, 3) != 3 ) {
+		SDL_Error(SDL_EFREAD);
+		goto error;
+	}
+	if ( header[1] == WAVE ) { /* The RIFFchunk has already been read */
+		SDL_RWseek(src, -(int)sizeof(Uint32), RW_SEEK_CUR);
+	} else if ( (header[0] != RIFF) || (header[2] != WAVE) ) {
+		SDL_SetError("Unrecognized file type (not WAVE)");
+		goto error;
+	}
+
+	/* Find the audio data format chunk, skipping over anything else */
+	has_format = 0;
+	for ( ; ; ) {
+		if ( SDL_ReadLE32Array(src, header, 2) != 2 ) {
+			SDL_Error(SDL_EFREAD);
+			goto error;
+		}
+		if ( header[0] == DATA ) {
+			break;
+		}
+		if ( (header[0] == FMT) && !has_format ) {
+			SDL_RWseek(src, -2*(int)sizeof(Uint32), RW_SEEK_CUR);
+			lenread = ReadChunk(src, &chunk);
+			if ( lenread < 0 ) {
+				goto error;
+			}
+			stream->encoding = ReadFormat((WaveFMT *)chunk.data,
+						lenread, spec,
+						&stream->MS_ADPCM_state,
+						&stream->IMA_ADPCM_state);
+			SDL_free(chunk.data);
+			if ( stream->encoding < 0 ) {
+				goto error;
+			}
+			has_format = 1;
+		} else if ( SDL_RWseek(src, header[1], RW_SEEK_CUR) < 0 ) {
+			goto error;
+		}
+	}
+	if ( !has_format ) {
+		SDL_SetError("Complex WAVE files not supported");
+		goto error;
+	}
+	if ( spec->channels == 0 ) {
+		SDL_SetError("Invalid number of channels in a WAVE file");
+		goto error;
+	}
+	spec->samples = 4096;		/* Good default buffer size */
+	datalen = header[1];
+	stream->data_start = SDL_RWtell(src);
+
+	/* Work out the size of the stream, counting whole blocks only */
+	stream->framesize = ((spec->format & 0xFF)/8)*spec->channels;
+	switch (stream->encoding) {
+		case MS_ADPCM_CODE:
+			stream->blockalign = stream->MS_ADPCM_state.wavefmt.blockalign;
+			stream->blockframes = stream->MS_ADPCM_state.wSamplesPerBlock;
+			break;
+		case IMA_ADPCM_CODE:
+			stream->blockalign = stream->IMA_ADPCM_state.wavefmt.blockalign;
+			stream->blockframes = stream->IMA_ADPCM_state.wSamplesPerBlock;
+			break;
+		default:
+			stream->blockalign = stream->framesize;
+			stream->blockframes = 1;
+			break;
+	}
+	stream->frames = (datalen / stream->blockalign) * stream->blockframes;
+	if ( stream->encoding != PCM_CODE ) {
+		stream->encoded = (Uint8 *)SDL_malloc(stream->blockalign);
+		stream->decoded = (Uint8 *)SDL_malloc(
+				stream->blockframes * stream->framesize);
+		if ( !stream->encoded || !stream->decoded ) {
+			SDL_OutOfMemory();
+			goto error;
+		}
+	}
+	stream->src = src;
+	stream->freesrc = freesrc;
+	if ( frames ) {
+		*frames = stream->frames;
+	}
+	return(stream);
+
+error:
+	if ( stream ) {
+		SDL_free(stream->encoded);
+		SDL_free(stream->decoded);
+		SDL_free(stream);
+	}
+	if ( freesrc ) {
+		SDL_RWclose(src);
+	}
+	return(NULL);
+}
+
+/* Read and decode the ADPCM block holding the current stream position */
+static int DecodeStreamBlock(SDL_WAVStream *stream)
+{
+	int retval;
+
+	if ( SDL_RWread(stream->src, stream->encoded, stream->blockalign, 1) != 1 ) {
+		SDL_Error(SDL_EFREAD);
+		return(-1);
+	}
+	if ( stream->encoding == MS_ADPCM_CODE ) {
+		retval = MS_ADPCM_decodeblock(&stream->MS_ADPCM_state,
+				stream->encoded, stream->decoded);
+	} else {
+		retval = IMA_ADPCM_decodeblock(&stream->IMA_ADPCM_state,
+				stream->encoded, stream->decoded);
+	}
+	if ( retval < 0 ) {
+		return(-1);
+	}
+	stream->decoded_pos = (stream->position % stream->blockframes) *
+							stream->framesize;
+	stream->decoded_len = stream->blockframes * stream->framesize;
+	return(0);
+}
+
+int SDL_ReadWAVStream(SDL_WAVStream *stream, void *buf, int len)
+{
+	Uint8 *dst;
+	Uint32 frames;
+	int amount, total;
+
+	dst = (Uint8 *)buf;
+	total = 0;
+	frames = len / stream->framesize;
+	if ( frames > (stream->frames - stream->position) ) {
+		frames = (stream->frames - stream->position);
+	}
+	if ( stream->encoding == PCM_CODE ) {
+		/* Raw samples go straight into the caller's buffer */
+		if ( frames > 0 ) {
+			amount = SDL_RWread(stream->src, dst,
+					stream->framesize, frames);
+			if ( amount <= 0 ) {
+				SDL_Error(SDL_EFREAD);
+				return(-1);
+			}
+			stream->position += amount;
+			total = amount * stream->framesize;
+		}
+		return(total);
+	}
+	len = frames * stream->framesize;
+	while ( len > 0 ) {
+		if ( stream->decoded_pos == stream->decoded_len ) {
+			if ( DecodeStreamBlock(stream) < 0 ) {
+				return(total > 0 ? total : -1);
+			}
+		}
+		amount = stream->decoded_len - stream->decoded_pos;
+		if ( amount > len ) {
+			amount = len;
+		}
+		SDL_memcpy(dst, stream->decoded + stream->decoded_pos, amount);
+		stream->decoded_pos += amount;
+		stream->position += amount / stream->framesize;
+		dst += amount;
+		len -= amount;
+		total += amount;
+	}
+	return(total);
+}
+
+int SDL_SeekWAVStream(SDL_WAVStream *stream, Uint32 frame)
+{
+	Uint32 block;
+
+	if ( frame > stream->frames ) {
+		SDL_SetError("Seek past the end of the WAVE stream");
+		return(-1);
+	}
+	block = frame / stream->blockframes;
+	if ( SDL_RWseek(stream->src, stream->data_start +
+			block * stream->blockalign, RW_SEEK_SET) < 0 ) {
+		return(-1);
+	}
+	stream->position = frame;
+	stream->decoded_pos = stream->decoded_len = 0;
+
+	/* Decode the block holding the frame, and skip up to the frame */
+	if ( (stream->encoding != PCM_CODE) && (frame < stream->frames) ) {
+		if ( DecodeStreamBlock(stream) < 0 ) {
+			return(-1);
+		}
+	}
+	return(0);
+}
+
+Uint32 SDL_TellWAVStream(SDL_WAVStream *stream)
+{
+	return(stream->position);
+}
+
+void SDL_CloseWAVStream(SDL_WAVStream *stream)
+{
+	if ( stream ) {
+		if ( stream->freesrc ) {
+			SDL_RWclose(stream->src);
+		}
+		SDL_free(stream->encoded);
+		SDL_free(stream->decoded);
+		SDL_free(stream);
+	}
+}
+
 static int ReadChunk(SDL_RWops *src, Chunk *chunk)
 {
-	chunk->magic	= SDL_ReadLE32(src);
-	chunk->length	= SDL_ReadLE32(src);
+	Uint32 header[2];
+	int memsize;
+
+	if ( SDL_ReadLE32Array(src, header, 2) != 2 ) {
+		SDL_Error(SDL_EFREAD);
+		chunk->data = NULL;
+		return(-1);
+	}
+	chunk->magic	= header[0];
+	chunk->length	= header[1];
+
+	/* Memory and mapped file sources know how much data is left,
+	   so don't allocate a buffer for a chunk that can't be read. */
+	if ( SDL_RWGetMemory(src, &memsize) != NULL ) {
+		if ( chunk->length > (Uint32)(memsize - SDL_RWtell(src)) ) {
+			SDL_Error(SDL_EFREAD);
+			chunk->data = NULL;
+			return(-1);
+		}
+	}
 	chunk->data = (Uint8 *)SDL_malloc(chunk->length);
 	if ( chunk->data == NULL ) {
 		SDL_Error(SDL_ENOMEM);
@@ -25,6 +25,7 @@
 
 #include <sys/types.h>
 #include <signal.h>	/* For kill() */
+#include <poll.h>
 
 #include "SDL_timer.h"
 #include "SDL_audio.h"
@@ -49,6 +50,8 @@ static void ALSA_WaitAudio(_THIS);
 static void ALSA_PlayAudio(_THIS);
 static Uint8 *ALSA_GetAudioBuf(_THIS);
 static void ALSA_CloseAudio(_THIS);
+static int ALSA_CaptureAudio(_THIS, Uint8 *buf, int len);
+static int ALSA_GetDelay(_THIS);
 
 #ifdef SDL_AUDIO_DRIVER_ALSA_DYNAMIC
 
@@ -59,6 +62,7 @@ static int alsa_loaded = 0;
 static int (*SDL_NAME(snd_pcm_open))(snd_pcm_t **pcm, const char *name, snd_pcm_stream_t stream, int mode);
 static int (*SDL_NAME(snd_pcm_close))(snd_pcm_t *pcm);
 static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_writei))(snd_pcm_t *pcm, const void *buffer, snd_pcm_uframes_t size);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_readi))(snd_pcm_t *pcm, void *buffer, snd_pcm_uframes_t size);
 static int (*SDL_NAME(snd_pcm_resume))(snd_pcm_t *pcm);
 static int (*SDL_NAME(snd_pcm_prepare))(snd_pcm_t *pcm);
 static const char *(*SDL_NAME(snd_strerror))(int errnum);
@@ -85,6 +89,16 @@ static int (*SDL_NAME(snd_pcm_sw_params_current))(snd_pcm_t *pcm, snd_pcm_sw_par
 static int (*SDL_NAME(snd_pcm_sw_params_set_start_threshold))(snd_pcm_t *pcm, snd_pcm_sw_params_t *params, snd_pcm_uframes_t val);
 static int (*SDL_NAME(snd_pcm_sw_params))(snd_pcm_t *pcm, snd_pcm_sw_params_t *params);
 static int (*SDL_NAME(snd_pcm_nonblock))(snd_pcm_t *pcm, int nonblock);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_avail_update))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_mmap_begin))(snd_pcm_t *pcm, const snd_pcm_channel_area_t **areas, snd_pcm_uframes_t *offset, snd_pcm_uframes_t *frames);
+static snd_pcm_sframes_t (*SDL_NAME(snd_pcm_mmap_commit))(snd_pcm_t *pcm, snd_pcm_uframes_t offset, snd_pcm_uframes_t frames);
+static int (*SDL_NAME(snd_pcm_poll_descriptors_count))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_poll_descriptors))(snd_pcm_t *pcm, struct pollfd *pfds, unsigned int space);
+static int (*SDL_NAME(snd_pcm_poll_descriptors_revents))(snd_pcm_t *pcm, struct pollfd *pfds, unsigned int nfds, unsigned short *revents);
+static snd_pcm_state_t (*SDL_NAME(snd_pcm_state))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_start))(snd_pcm_t *pcm);
+static int (*SDL_NAME(snd_pcm_delay))(snd_pcm_t *pcm, snd_pcm_sframes_t *delayp);
+static int (*SDL_NAME(snd_pcm_wait))(snd_pcm_t *pcm, int timeout);
 #define snd_pcm_hw_params_sizeof SDL_NAME(snd_pcm_hw_params_sizeof)
 #define snd_pcm_sw_params_sizeof SDL_NAME(snd_pcm_sw_params_sizeof)
 
@@ -97,6 +111,7 @@ static struct {
 	{ "snd_pcm_open",	(void**)(char*)&SDL_NAME(snd_pcm_open)		},
 	{ "snd_pcm_close",	(void**)(char*)&SDL_NAME(snd_pcm_close)	},
 	{ "snd_pcm_writei",	(void**)(char*)&SDL_NAME(snd_pcm_writei)	},
+	{ "snd_pcm_readi",	(void**)(char*)&SDL_NAME(snd_pcm_readi)	},
 	{ "snd_pcm_resume",	(void**)(char*)&SDL_NAME(snd_pcm_resume)	},
 	{ "snd_pcm_prepare",	(void**)(char*)&SDL_NAME(snd_pcm_prepare)	},
 	{ "snd_strerror",	(void**)(char*)&SDL_NAME(snd_strerror)		},
@@ -121,19 +136,35 @@ static struct {
 	{ "snd_pcm_sw_params_set_start_threshold",	(void**)(char*)&SDL_NAME(snd_pcm_sw_params_set_start_threshold)	},
 	{ "snd_pcm_sw_params",	(void**)(char*)&SDL_NAME(snd_pcm_sw_params)	},
 	{ "snd_pcm_nonblock",	(void**)(char*)&SDL_NAME(snd_pcm_nonblock)	},
+	{ "snd_pcm_avail_update",	(void**)(char*)&SDL_NAME(snd_pcm_avail_update)	},
+	{ "snd_pcm_mmap_begin",	(void**)(char*)&SDL_NAME(snd_pcm_mmap_begin)	},
+	{ "snd_pcm_mmap_commit",	(void**)(char*)&SDL_NAME(snd_pcm_mmap_commit)	},
+	{ "snd_pcm_poll_descriptors_count",	(void**)(char*)&SDL_NAME(snd_pcm_poll_descriptors_count)	},
+	{ "snd_pcm_poll_descriptors",	(void**)(char*)&SDL_NAME(snd_pcm_poll_descriptors)	},
+	{ "snd_pcm_poll_descriptors_revents",	(void**)(char*)&SDL_NAME(snd_pcm_poll_descriptors_revents)	},
+	{ "snd_pcm_state",	(void**)(char*)&SDL_NAME(snd_pcm_state)	},
+	{ "snd_pcm_start",	(void**)(char*)&SDL_NAME(snd_pcm_start)	},
+	{ "snd_pcm_delay",	(void**)(char*)&SDL_NAME(snd_pcm_delay)	},
+	{ "snd_pcm_wait",	(void**)(char*)&SDL_NAME(snd_pcm_wait)	},
 };
 
+/* The library is loaded once for each device, and unloaded with the last */
 static void UnloadALSALibrary(void) {
 	if (alsa_loaded) {
-		SDL_UnloadObject(alsa_handle);
-		alsa_handle = NULL;
-		alsa_loaded = 0;
+		if (--alsa_loaded == 0) {
+			SDL_UnloadObject(alsa_handle);
+			alsa_handle = NULL;
+		}
 	}
 }
 
 static int LoadALSALibrary(void) {
 	int i, retval = -1;
 
+	if (alsa_loaded) {
+		++alsa_loaded;
+		return 0;
+	}
 	alsa_handle = SDL_LoadObject(alsa_library);
 	if (alsa_handle) {
 		alsa_loaded = 1;
@@ -162,13 +193,19 @@ static int LoadALSALibrary(void) {
 
 #endif /* SDL_AUDIO_DRIVER_ALSA_DYNAMIC */
 
-static const char *get_audio_device(int channels)
+static const char *get_audio_device(const char *devname, int channels)
 {
 	const char *device;
 	
+	if ( devname != NULL ) {
+		return devname;
+	}
 	device = SDL_getenv("AUDIODEV");	/* Is there a standard variable name? */
 	if ( device == NULL ) {
 		switch (channels) {
+		case 8:
+			device = "plug:surround71";
+			break;
 		case 6:
 			device = "plug:surround51";
 			break;
@@ -195,7 +232,7 @@ static int Audio_Available(void)
 	if (LoadALSALibrary() < 0) {
 		return available;
 	}
-	status = SDL_NAME(snd_pcm_open)(&handle, get_audio_device(2), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
+	status = SDL_NAME(snd_pcm_open)(&handle, get_audio_device(NULL, 2), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
 	if ( status >= 0 ) {
 		available = 1;
         	SDL_NAME(snd_pcm_close)(handle);
@@ -228,6 +265,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		UnloadALSALibrary();
 		return(0);
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
@@ -238,6 +276,10 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->PlayAudio = ALSA_PlayAudio;
 	this->GetAudioBuf = ALSA_GetAudioBuf;
 	this->CloseAudio = ALSA_CloseAudio;
+	this->CaptureAudio = ALSA_CaptureAudio;
+	this->GetDelay = ALSA_GetDelay;
+
+	this->multiopen = 1;
 
 	this->free = Audio_DeleteDevice;
 
@@ -249,63 +291,58 @@ AudioBootStrap ALSA_bootstrap = {
 	Audio_Available, Audio_CreateDevice
 };
 
-/* This function waits until it is possible to write a full sound buffer */
-static void ALSA_WaitAudio(_THIS)
-{
-	/* We're in blocking mode, so there's nothing to do here */
-}
-
-
 /*
  * http://bugzilla.libsdl.org/show_bug.cgi?id=110
  * "For Linux ALSA, this is FL-FR-RL-RR-C-LFE
  *  and for Windows DirectX [and CoreAudio], this is FL-FR-C-LFE-RL-RR"
  */
 #define SWIZ6(T) \
-    T *ptr = (T *) mixbuf; \
+    T *ptr = (T *) buf; \
+    const int channels = this->spec.channels; \
     Uint32 i; \
-    for (i = 0; i < this->spec.samples; i++, ptr += 6) { \
+    for (i = 0; i < this->spec.samples; i++, ptr += channels) { \
         T tmp; \
         tmp = ptr[2]; ptr[2] = ptr[4]; ptr[4] = tmp; \
         tmp = ptr[3]; ptr[3] = ptr[5]; ptr[5] = tmp; \
     }
 
-static __inline__ void swizzle_alsa_channels_6_64bit(_THIS) { SWIZ6(Uint64); }
-static __inline__ void swizzle_alsa_channels_6_32bit(_THIS) { SWIZ6(Uint32); }
-static __inline__ void swizzle_alsa_channels_6_16bit(_THIS) { SWIZ6(Uint16); }
-static __inline__ void swizzle_alsa_channels_6_8bit(_THIS) { SWIZ6(Uint8); }
+static __inline__ void swizzle_alsa_channels_6_64bit(_THIS, Uint8 *buf) { SWIZ6(Uint64); }
+static __inline__ void swizzle_alsa_channels_6_32bit(_THIS, Uint8 *buf) { SWIZ6(Uint32); }
+static __inline__ void swizzle_alsa_channels_6_16bit(_THIS, Uint8 *buf) { SWIZ6(Uint16); }
+static __inline__ void swizzle_alsa_channels_6_8bit(_THIS, Uint8 *buf) { SWIZ6(Uint8); }
 
 #undef SWIZ6
 
 
 /*
  * Called right before feeding this->mixbuf to the hardware. Swizzle channels
- *  from Windows/Mac order to the format alsalib will want.
+ *  from Windows/Mac order to the format alsalib will want.  The swap goes
+ *  both ways, so it also puts captured audio back in SDL order.  7.1 has
+ *  the same front and rear swap, and the side speakers last in both.
  */
-static __inline__ void swizzle_alsa_channels(_THIS)
+static __inline__ void swizzle_alsa_channels(_THIS, Uint8 *buf)
 {
-    if (this->spec.channels == 6) {
+    if (this->spec.channels == 6 || this->spec.channels == 8) {
         const Uint16 fmtsize = (this->spec.format & 0xFF); /* bits/channel. */
         if (fmtsize == 16)
-            swizzle_alsa_channels_6_16bit(this);
+            swizzle_alsa_channels_6_16bit(this, buf);
         else if (fmtsize == 8)
-            swizzle_alsa_channels_6_8bit(this);
+            swizzle_alsa_channels_6_8bit(this, buf);
         else if (fmtsize == 32)
-            swizzle_alsa_channels_6_32bit(this);
+            swizzle_alsa_channels_6_32bit(this, buf);
         else if (fmtsize == 64)
-            swizzle_alsa_channels_6_64bit(this);
+            swizzle_alsa_channels_6_64bit(this, buf);
     }
-
-    /* !!! FIXME: update this for 7.1 if needed, later. */
 }
 
 
 /* snd_pcm_recover() is available in alsa-lib >= 1.0.11 */
-static int ALSA_pcm_recover(snd_pcm_t *handle, int err, int silent)
+static int ALSA_pcm_recover(_THIS, snd_pcm_t *handle, int err, int silent)
 {
 	(void) silent;
 	if (err == -EINTR) return 0;
 	if (err == -EPIPE) {		/* under-run */
+		++this->underruns;
 		err = SDL_NAME(snd_pcm_prepare)(handle);
 		return (err < 0)? err : 0;
 	}
@@ -319,6 +356,99 @@ static int ALSA_pcm_recover(snd_pcm_t *handle, int err, int silent)
 	return err;
 }
 
+/* Wait on the poll descriptors until 'frames' frames of the ring buffer
+   are free, returning 0, or a negative error code if the device is gone.
+ */
+static int ALSA_poll_wait(_THIS, snd_pcm_sframes_t frames)
+{
+	snd_pcm_sframes_t avail;
+	unsigned short revents;
+	int timeout;
+	int status;
+
+	/* Wake up now and then, so closing the device never hangs */
+	timeout = ((this->spec.samples * 1000) / this->spec.freq) * 2 + 10;
+
+	while ( this->enabled ) {
+		avail = SDL_NAME(snd_pcm_avail_update)(pcm_handle);
+		if ( avail < 0 ) {
+			status = ALSA_pcm_recover(this, pcm_handle, (int) avail, 0);
+			if ( status < 0 ) {
+				return(status);
+			}
+			continue;
+		}
+		if ( avail >= frames ) {
+			break;
+		}
+
+		status = poll(pollfds, pollcount, timeout);
+		if ( status < 0 ) {
+			if ( errno == EINTR ) {
+				continue;
+			}
+			return(-errno);
+		}
+		if ( status > 0 ) {
+			/* Plugins need to see and clear their own wakeup events */
+			SDL_NAME(snd_pcm_poll_descriptors_revents)(pcm_handle, pollfds, pollcount, &revents);
+		}
+	}
+	return(0);
+}
+
+/* This function waits until it is possible to write a full sound buffer */
+static void ALSA_WaitAudio(_THIS)
+{
+	int status;
+
+	/* Blocking writes do the waiting, unless we write to mmapped memory */
+	if ( mmap_mode ) {
+		status = ALSA_poll_wait(this, this->spec.samples);
+		if ( status < 0 ) {
+			fprintf(stderr, "ALSA wait failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+			this->enabled = 0;
+		}
+	}
+}
+
+/* Commit mmapped frames, starting the stream with the first ones */
+static snd_pcm_sframes_t ALSA_mmap_commit(_THIS, snd_pcm_uframes_t offset, snd_pcm_uframes_t frames)
+{
+	snd_pcm_sframes_t status;
+	int err;
+
+	status = SDL_NAME(snd_pcm_mmap_commit)(pcm_handle, offset, frames);
+	if ( status > 0 && SDL_NAME(snd_pcm_state)(pcm_handle) == SND_PCM_STATE_PREPARED ) {
+		err = SDL_NAME(snd_pcm_start)(pcm_handle);
+		if ( err < 0 ) {
+			status = err;
+		}
+	}
+	return(status);
+}
+
+/* Copy as much audio as fits in one piece of the ring buffer */
+static snd_pcm_sframes_t ALSA_mmap_write(_THIS, const Uint8 *buf, snd_pcm_uframes_t frames)
+{
+	const snd_pcm_channel_area_t *areas;
+	snd_pcm_uframes_t offset;
+	Uint8 *dst;
+	int status;
+
+	status = ALSA_poll_wait(this, 1);
+	if ( status < 0 ) {
+		return(status);
+	}
+	status = SDL_NAME(snd_pcm_mmap_begin)(pcm_handle, &areas, &offset, &frames);
+	if ( status < 0 ) {
+		return(status);
+	}
+	dst = (Uint8 *) areas[0].addr + ((areas[0].first + offset * areas[0].step) / 8);
+	SDL_memcpy(dst, buf, frames * (areas[0].step / 8));
+	return(ALSA_mmap_commit(this, offset, frames));
+}
+
 static void ALSA_PlayAudio(_THIS)
 {
 	int status;
@@ -326,19 +456,38 @@ static void ALSA_PlayAudio(_THIS)
 	const Uint8 *sample_buf = (const Uint8 *) mixbuf;
 	const int frame_size = (((int) (this->spec.format & 0xFF)) / 8) * this->spec.channels;
 
-	swizzle_alsa_channels(this);
+	/* The callback rendered straight into the ring buffer */
+	if ( mmapbuf != NULL ) {
+		swizzle_alsa_channels(this, mmapbuf);
+		mmapbuf = NULL;
+		status = (int) ALSA_mmap_commit(this, mmap_offset, this->spec.samples);
+		if ( status < 0 ) {
+			status = ALSA_pcm_recover(this, pcm_handle, status, 0);
+			if ( status < 0 ) {
+				fprintf(stderr, "ALSA write failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+				this->enabled = 0;
+			}
+		}
+		return;
+	}
+
+	swizzle_alsa_channels(this, mixbuf);
 
 	frames_left = ((snd_pcm_uframes_t) this->spec.samples);
 
 	while ( frames_left > 0 && this->enabled ) {
-		status = SDL_NAME(snd_pcm_writei)(pcm_handle, sample_buf, frames_left);
+		if ( mmap_mode ) {
+			status = ALSA_mmap_write(this, sample_buf, frames_left);
+		} else {
+			status = SDL_NAME(snd_pcm_writei)(pcm_handle, sample_buf, frames_left);
+		}
 		if ( status < 0 ) {
 			if ( status == -EAGAIN ) {
 				/* Apparently snd_pcm_recover() doesn't handle this case. Foo. */
-				SDL_Delay(1);
+				SDL_NAME(snd_pcm_wait)(pcm_handle, 10);
 				continue;
 			}
-			status = ALSA_pcm_recover(pcm_handle, status, 0);
+			status = ALSA_pcm_recover(this, pcm_handle, status, 0);
 			if ( status < 0 ) {
 				/* Hmm, not much we can do - abort */
 				fprintf(stderr, "ALSA write failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
@@ -354,21 +503,96 @@ static void ALSA_PlayAudio(_THIS)
 
 static Uint8 *ALSA_GetAudioBuf(_THIS)
 {
+	const snd_pcm_channel_area_t *areas;
+	snd_pcm_uframes_t offset, frames;
+
+	/* Hand out the ring buffer itself when a whole period fits in one piece */
+	mmapbuf = NULL;
+	if ( mmap_mode &&
+	     SDL_NAME(snd_pcm_avail_update)(pcm_handle) >= (snd_pcm_sframes_t) this->spec.samples ) {
+		frames = this->spec.samples;
+		if ( SDL_NAME(snd_pcm_mmap_begin)(pcm_handle, &areas, &offset, &frames) >= 0 ) {
+			if ( frames == this->spec.samples ) {
+				mmap_offset = offset;
+				mmapbuf = (Uint8 *) areas[0].addr + ((areas[0].first + offset * areas[0].step) / 8);
+				return(mmapbuf);
+			}
+			/* The period wraps around the end, it's copied in pieces */
+			SDL_NAME(snd_pcm_mmap_commit)(pcm_handle, offset, 0);
+		}
+	}
 	return(mixbuf);
 }
 
+static int ALSA_CaptureAudio(_THIS, Uint8 *buf, int len)
+{
+	int status;
+	snd_pcm_uframes_t frames_left;
+	Uint8 *sample_buf = buf;
+	const int frame_size = (((int) (this->spec.format & 0xFF)) / 8) * this->spec.channels;
+
+	frames_left = ((snd_pcm_uframes_t) (len / frame_size));
+
+	while ( frames_left > 0 && this->enabled ) {
+		status = SDL_NAME(snd_pcm_readi)(pcm_handle, sample_buf, frames_left);
+		if ( status < 0 ) {
+			if ( status == -EAGAIN ) {
+				SDL_NAME(snd_pcm_wait)(pcm_handle, 10);
+				continue;
+			}
+			/* Overruns are recovered from like underruns */
+			status = ALSA_pcm_recover(this, pcm_handle, status, 0);
+			if ( status < 0 ) {
+				fprintf(stderr, "ALSA read failed (unrecoverable): %s\n", SDL_NAME(snd_strerror)(status));
+				return(-1);
+			}
+			continue;
+		}
+		sample_buf += status * frame_size;
+		frames_left -= status;
+	}
+
+	len = (int) (sample_buf - buf);
+	swizzle_alsa_channels(this, buf);
+	return(len);
+}
+
+static int ALSA_GetDelay(_THIS)
+{
+	snd_pcm_sframes_t delay;
+	int status;
+
+	status = SDL_NAME(snd_pcm_delay)(pcm_handle, &delay);
+	if ( status == -EPIPE ) {
+		/* An underrun or overrun empties the buffer */
+		return(0);
+	}
+	if ( status < 0 ) {
+		return(-1);
+	}
+	return((delay > 0) ? (int) delay : 0);
+}
+
 static void ALSA_CloseAudio(_THIS)
 {
+	snd_pcm_sframes_t delay;
+
 	if ( mixbuf != NULL ) {
 		SDL_FreeAudioMem(mixbuf);
 		mixbuf = NULL;
 	}
+	if ( pollfds != NULL ) {
+		SDL_free(pollfds);
+		pollfds = NULL;
+	}
 	if ( pcm_handle ) {
 		/* Wait for the submitted audio to drain
 		   snd_pcm_drop() can hang, so don't use that.
 		 */
-		Uint32 delay = ((this->spec.samples * 1000) / this->spec.freq) * 2;
-		SDL_Delay(delay);
+		if ( ! this->iscapture && this->spec.freq > 0 &&
+		     SDL_NAME(snd_pcm_delay)(pcm_handle, &delay) == 0 && delay > 0 ) {
+			SDL_Delay((Uint32) ((delay * 1000) / this->spec.freq));
+		}
 		SDL_NAME(snd_pcm_close)(pcm_handle);
 		pcm_handle = NULL;
 	}
@@ -489,14 +713,14 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 
 	/* Open the audio device */
 	/* Name of device should depend on # channels in spec */
-	status = SDL_NAME(snd_pcm_open)(&pcm_handle, get_audio_device(spec->channels), SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
+	status = SDL_NAME(snd_pcm_open)(&pcm_handle, get_audio_device(this->devname, spec->channels), this->iscapture ? SND_PCM_STREAM_CAPTURE : SND_PCM_STREAM_PLAYBACK, SND_PCM_NONBLOCK);
 
 	if ( status < 0 ) {
 		SDL_SetError("Couldn't open audio device: %s", SDL_NAME(snd_strerror)(status));
 		return(-1);
 	}
 
-	/* Switch to blocking mode for playback */
+	/* Switch to blocking mode for playback and capture */
 	/* Note: this must happen before hw/sw params are set. */
 	SDL_NAME(snd_pcm_nonblock)(pcm_handle, 0);
 
@@ -509,8 +733,18 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 		return(-1);
 	}
 
-	/* SDL only uses interleaved sample output */
-	status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_RW_INTERLEAVED);
+	/* SDL only uses interleaved sample output, optionally mmapped */
+	mmap_mode = 0;
+	if ( ! this->iscapture ) {
+		const char *env = SDL_getenv("SDL_AUDIO_ALSA_MMAP");
+		if ( env && SDL_atoi(env) ) {
+			status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+			mmap_mode = (status >= 0);
+		}
+	}
+	if ( ! mmap_mode ) {
+		status = SDL_NAME(snd_pcm_hw_params_set_access)(pcm_handle, hwparams, SND_PCM_ACCESS_RW_INTERLEAVED);
+	}
 	if ( status < 0 ) {
 		SDL_SetError("Couldn't set interleaved access: %s", SDL_NAME(snd_strerror)(status));
 		ALSA_CloseAudio(this);
@@ -620,6 +854,23 @@ static int ALSA_OpenAudio(_THIS, SDL_AudioSpec *spec)
 		return(-1);
 	}
 
+	/* Get the descriptors to wait on for mmapped output */
+	if ( mmap_mode ) {
+		pollcount = SDL_NAME(snd_pcm_poll_descriptors_count)(pcm_handle);
+		if ( pollcount <= 0 ) {
+			SDL_SetError("Couldn't get poll descriptors");
+			ALSA_CloseAudio(this);
+			return(-1);
+		}
+		pollfds = (struct pollfd *)SDL_malloc(pollcount * sizeof(*pollfds));
+		if ( pollfds == NULL ) {
+			SDL_OutOfMemory();
+			ALSA_CloseAudio(this);
+			return(-1);
+		}
+		SDL_NAME(snd_pcm_poll_descriptors)(pcm_handle, pollfds, pollcount);
+	}
+
 	/* Calculate the final parameters for this audio specification */
 	SDL_CalculateAudioSpec(spec);
 
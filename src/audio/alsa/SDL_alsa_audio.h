@@ -38,11 +38,25 @@ struct SDL_PrivateAudioData {
 	/* Raw mixing buffer */
 	Uint8 *mixbuf;
 	int    mixlen;
+
+	/* Set when the audio is written straight into the ring buffer */
+	int mmap_mode;
+	Uint8 *mmapbuf;
+	snd_pcm_uframes_t mmap_offset;
+
+	/* The descriptors polled while waiting for buffer space */
+	struct pollfd *pollfds;
+	int pollcount;
 };
 
 /* Old variable names */
 #define pcm_handle		(this->hidden->pcm_handle)
 #define mixbuf			(this->hidden->mixbuf)
 #define mixlen			(this->hidden->mixlen)
+#define mmap_mode		(this->hidden->mmap_mode)
+#define mmapbuf			(this->hidden->mmapbuf)
+#define mmap_offset		(this->hidden->mmap_offset)
+#define pollfds			(this->hidden->pollfds)
+#define pollcount		(this->hidden->pollcount)
 
 #endif /* _ALSA_PCM_audio_h */
@@ -85,12 +85,14 @@ static struct {
 	{ "arts_error_text",	(void **)&SDL_NAME(arts_error_text)	},
 };
 
+/* The library is loaded once for each device, and unloaded with the last */
 static void UnloadARTSLibrary()
 {
 	if ( arts_loaded ) {
-		SDL_UnloadObject(arts_handle);
-		arts_handle = NULL;
-		arts_loaded = 0;
+		if ( --arts_loaded == 0 ) {
+			SDL_UnloadObject(arts_handle);
+			arts_handle = NULL;
+		}
 	}
 }
 
@@ -98,6 +100,10 @@ static int LoadARTSLibrary(void)
 {
 	int i, retval = -1;
 
+	if ( arts_loaded ) {
+		++arts_loaded;
+		return 0;
+	}
 	arts_handle = SDL_LoadObject(arts_library);
 	if ( arts_handle ) {
 		arts_loaded = 1;
@@ -189,6 +195,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		UnloadARTSLibrary();
 		return(0);
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
@@ -201,6 +208,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->GetAudioBuf = ARTS_GetAudioBuf;
 	this->CloseAudio = ARTS_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	return this;
@@ -23,18 +23,20 @@
 */
 #include "SDL_config.h"
 
-/* Output raw audio data to a file. */
+/* Output raw audio data, or a WAVE file, to a file, and capture it back. */
 
 #if HAVE_STDIO_H
 #include <stdio.h>
 #endif
 
 #include "SDL_rwops.h"
+#include "SDL_thread.h"
 #include "SDL_timer.h"
 #include "SDL_audio.h"
 #include "../SDL_audiomem.h"
 #include "../SDL_audio_c.h"
 #include "../SDL_audiodev_c.h"
+#include "../SDL_wave.h"
 #include "SDL_diskaudio.h"
 
 /* The tag name used by DISK audio */
@@ -45,13 +47,19 @@
 #define DISKDEFAULT_OUTFILE      "sdlaudio.raw"
 #define DISKENVR_WRITEDELAY      "SDL_DISKAUDIODELAY"
 #define DISKDEFAULT_WRITEDELAY   150
+#define DISKENVR_FREERUN         "SDL_DISKAUDIOFREERUN"
+#define DISKENVR_INFILE          "SDL_DISKAUDIOFILEIN"
+#define DISKDEFAULT_INFILE       "sdlaudio-in.raw"
 
 /* Audio driver functions */
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec);
+static void DISKAUD_ThreadInit(_THIS);
 static void DISKAUD_WaitAudio(_THIS);
 static void DISKAUD_PlayAudio(_THIS);
 static Uint8 *DISKAUD_GetAudioBuf(_THIS);
 static void DISKAUD_CloseAudio(_THIS);
+static int DISKAUD_CaptureAudio(_THIS, Uint8 *buf, int len);
+static int DISKAUD_GetDelay(_THIS);
 
 static const char *DISKAUD_GetOutputFilename(void)
 {
@@ -59,6 +67,12 @@ static const char *DISKAUD_GetOutputFilename(void)
 	return((envr != NULL) ? envr : DISKDEFAULT_OUTFILE);
 }
 
+static const char *DISKAUD_GetInputFilename(void)
+{
+	const char *envr = SDL_getenv(DISKENVR_INFILE);
+	return((envr != NULL) ? envr : DISKDEFAULT_INFILE);
+}
+
 /* Audio driver bootstrap functions */
 static int DISKAUD_Available(void)
 {
@@ -99,12 +113,25 @@ static SDL_AudioDevice *DISKAUD_CreateDevice(int devindex)
 	envr = SDL_getenv(DISKENVR_WRITEDELAY);
 	this->hidden->write_delay = (envr) ? SDL_atoi(envr) : DISKDEFAULT_WRITEDELAY;
 
+	/* In freerun mode the audio thread doesn't wait between buffers, so
+	   the callback runs as fast as it can produce audio.  Nothing is
+	   written while the device is paused, so the file only holds what
+	   the callback produced. */
+	envr = SDL_getenv(DISKENVR_FREERUN);
+	this->hidden->freerun = (envr) ? SDL_atoi(envr) : 0;
+	this->waitpaused = this->hidden->freerun;
+
 	/* Set the function pointers */
 	this->OpenAudio = DISKAUD_OpenAudio;
+	this->ThreadInit = DISKAUD_ThreadInit;
 	this->WaitAudio = DISKAUD_WaitAudio;
 	this->PlayAudio = DISKAUD_PlayAudio;
 	this->GetAudioBuf = DISKAUD_GetAudioBuf;
 	this->CloseAudio = DISKAUD_CloseAudio;
+	this->CaptureAudio = DISKAUD_CaptureAudio;
+	this->GetDelay = DISKAUD_GetDelay;
+
+	this->multiopen = 1;
 
 	this->free = DISKAUD_DeleteDevice;
 
@@ -116,10 +143,21 @@ AudioBootStrap DISKAUD_bootstrap = {
 	DISKAUD_Available, DISKAUD_CreateDevice
 };
 
+static void DISKAUD_ThreadInit(_THIS)
+{
+	/* A free running audio thread never sleeps, so it mustn't keep the
+	   raised priority or it would starve the rest of the program */
+	if ( this->hidden->freerun ) {
+		SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
+	}
+}
+
 /* This function waits until it is possible to write a full sound buffer */
 static void DISKAUD_WaitAudio(_THIS)
 {
-	SDL_Delay(this->hidden->write_delay);
+	if ( ! this->hidden->freerun ) {
+		SDL_Delay(this->hidden->write_delay);
+	}
 }
 
 static void DISKAUD_PlayAudio(_THIS)
@@ -135,6 +173,7 @@ static void DISKAUD_PlayAudio(_THIS)
 	if ( (Uint32)written != this->hidden->mixlen ) {
 		this->enabled = 0;
 	}
+	this->hidden->datalen += written;
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", written);
 #endif
@@ -145,21 +184,154 @@ static Uint8 *DISKAUD_GetAudioBuf(_THIS)
 	return(this->hidden->mixbuf);
 }
 
+static int DISKAUD_GetDelay(_THIS)
+{
+	/* The file gets the audio as soon as it's written */
+	return(0);
+}
+
+/* Write a WAVE header for PCM data, with the sizes filled in on close */
+static int DISKAUD_WriteWaveHeader(SDL_RWops *dst, SDL_AudioSpec *spec,
+							Uint32 datalen)
+{
+	Uint16 bits = (Uint16)(spec->format & 0xFF);
+	Uint16 blockalign = (Uint16)((bits / 8) * spec->channels);
+
+	SDL_WriteLE32(dst, RIFF);
+	SDL_WriteLE32(dst, 36 + datalen + (datalen & 1));
+	SDL_WriteLE32(dst, WAVE);
+	SDL_WriteLE32(dst, FMT);
+	SDL_WriteLE32(dst, 16);
+	SDL_WriteLE16(dst, PCM_CODE);
+	SDL_WriteLE16(dst, spec->channels);
+	SDL_WriteLE32(dst, spec->freq);
+	SDL_WriteLE32(dst, spec->freq * blockalign);
+	SDL_WriteLE16(dst, blockalign);
+	SDL_WriteLE16(dst, bits);
+	SDL_WriteLE32(dst, DATA);
+	return SDL_WriteLE32(dst, datalen);
+}
+
+/* Read the capture file, the rest of the buffer is silence once it ends */
+static int DISKAUD_CaptureAudio(_THIS, Uint8 *buf, int len)
+{
+	int got, amount;
+
+	/* Capture at the rate audio would be played */
+	DISKAUD_WaitAudio(this);
+
+	for ( got = 0; got < len; got += amount ) {
+		if ( this->hidden->wavein != NULL ) {
+			amount = SDL_ReadWAVStream(this->hidden->wavein,
+							buf + got, len - got);
+		} else {
+			amount = SDL_RWread(this->hidden->input,
+							buf + got, 1, len - got);
+		}
+		if ( amount <= 0 ) {
+			break;
+		}
+	}
+	return(got);
+}
+
 static void DISKAUD_CloseAudio(_THIS)
 {
+	if ( this->hidden->input != NULL ) {
+		SDL_RWclose(this->hidden->input);
+		this->hidden->input = NULL;
+	}
+	if ( this->hidden->wavein != NULL ) {
+		SDL_CloseWAVStream(this->hidden->wavein);
+		this->hidden->wavein = NULL;
+	}
 	if ( this->hidden->mixbuf != NULL ) {
 		SDL_FreeAudioMem(this->hidden->mixbuf);
 		this->hidden->mixbuf = NULL;
 	}
 	if ( this->hidden->output != NULL ) {
+		if ( this->hidden->wave ) {
+			/* Pad the data chunk and fix up the chunk sizes */
+			if ( this->hidden->datalen & 1 ) {
+				Uint8 pad = 0;
+				SDL_RWwrite(this->hidden->output, &pad, 1, 1);
+			}
+			SDL_RWseek(this->hidden->output, 0, RW_SEEK_SET);
+			DISKAUD_WriteWaveHeader(this->hidden->output,
+				&this->spec, this->hidden->datalen);
+		}
 		SDL_RWclose(this->hidden->output);
 		this->hidden->output = NULL;
 	}
 }
 
+/* Capture devices read raw audio in the requested format, or a WAVE
+   file in its own format, which is converted if necessary */
+static int DISKAUD_OpenCapture(_THIS, SDL_AudioSpec *spec)
+{
+	SDL_AudioSpec wavespec;
+	const char *fname;
+	size_t len;
+
+	if ( this->devname != NULL ) {
+		fname = this->devname;
+	} else {
+		fname = DISKAUD_GetInputFilename();
+	}
+	len = SDL_strlen(fname);
+
+	if ( (len >= 4) && (SDL_strcasecmp(fname + len - 4, ".wav") == 0) ) {
+		this->hidden->wavein = SDL_OpenWAVStream_RW(
+				SDL_RWFromFile(fname, "rb"), 1, &wavespec, NULL);
+		if ( this->hidden->wavein == NULL ) {
+			return(-1);
+		}
+		spec->freq = wavespec.freq;
+		spec->format = wavespec.format;
+		spec->channels = wavespec.channels;
+		SDL_CalculateAudioSpec(spec);
+	} else {
+		this->hidden->input = SDL_RWFromFile(fname, "rb");
+		if ( this->hidden->input == NULL ) {
+			return(-1);
+		}
+	}
+
+#if HAVE_STDIO_H
+	fprintf(stderr, "WARNING: You are using the SDL disk writer"
+                    " audio driver!\n Reading from file [%s].\n", fname);
+#endif
+	return(0);
+}
+
 static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
-	const char *fname = DISKAUD_GetOutputFilename();
+	const char *fname;
+	size_t len;
+
+	if ( this->iscapture ) {
+		return(DISKAUD_OpenCapture(this, spec));
+	}
+
+	/* A device opened by name writes to that file */
+	if ( this->devname != NULL ) {
+		fname = this->devname;
+	} else {
+		fname = DISKAUD_GetOutputFilename();
+	}
+	len = SDL_strlen(fname);
+
+	/* Write a WAVE file if the name ends in .wav, in one of its formats */
+	this->hidden->wave = ( (len >= 4) &&
+			(SDL_strcasecmp(fname + len - 4, ".wav") == 0) );
+	if ( this->hidden->wave ) {
+		if ( (spec->format & 0xFF) == 8 ) {
+			spec->format = AUDIO_U8;
+		} else {
+			spec->format = AUDIO_S16LSB;
+		}
+		SDL_CalculateAudioSpec(spec);
+	}
 
 	/* Open the audio device */
 	this->hidden->output = SDL_RWFromFile(fname, "wb");
@@ -172,6 +344,14 @@ static int DISKAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
                     " audio driver!\n Writing to file [%s].\n", fname);
 #endif
 
+	if ( this->hidden->wave ) {
+		this->hidden->datalen = 0;
+		if ( ! DISKAUD_WriteWaveHeader(this->hidden->output, spec, 0) ) {
+			SDL_SetError("Couldn't write WAVE header to %s", fname);
+			return(-1);
+		}
+	}
+
 	/* Allocate mixing buffer */
 	this->hidden->mixlen = spec->size;
 	this->hidden->mixbuf = (Uint8 *) SDL_AllocAudioMem(this->hidden->mixlen);
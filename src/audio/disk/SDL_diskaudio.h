@@ -36,6 +36,15 @@ struct SDL_PrivateAudioData {
 	Uint8 *mixbuf;
 	Uint32 mixlen;
 	Uint32 write_delay;
+	int freerun;
+
+	/* Set when writing a WAVE file, its header is finished on close */
+	int wave;
+	Uint32 datalen;
+
+	/* The raw audio or WAVE file read by capture devices */
+	SDL_RWops *input;
+	SDL_WAVStream *wavein;
 };
 
 #endif /* _SDL_diskaudio_h */
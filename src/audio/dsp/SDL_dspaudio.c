@@ -56,6 +56,7 @@
 
 /* Open the audio device for playback, and don't block if busy */
 #define OPEN_FLAGS	(O_WRONLY|O_NONBLOCK)
+#define OPEN_FLAGS_CAPTURE	(O_RDONLY|O_NONBLOCK)
 
 /* Audio driver functions */
 static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec);
@@ -63,6 +64,8 @@ static void DSP_WaitAudio(_THIS);
 static void DSP_PlayAudio(_THIS);
 static Uint8 *DSP_GetAudioBuf(_THIS);
 static void DSP_CloseAudio(_THIS);
+static int DSP_CaptureAudio(_THIS, Uint8 *buf, int len);
+static int DSP_GetDelay(_THIS);
 
 /* Audio driver bootstrap functions */
 
@@ -113,6 +116,10 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->PlayAudio = DSP_PlayAudio;
 	this->GetAudioBuf = DSP_GetAudioBuf;
 	this->CloseAudio = DSP_CloseAudio;
+	this->CaptureAudio = DSP_CaptureAudio;
+	this->GetDelay = DSP_GetDelay;
+
+	this->multiopen = 1;
 
 	this->free = Audio_DeleteDevice;
 
@@ -130,6 +137,19 @@ static void DSP_WaitAudio(_THIS)
 	/* Not needed at all since OSS handles waiting automagically */
 }
 
+/* OSS 4 counts the underruns and overruns, and clears them when read */
+static void DSP_CountErrors(_THIS)
+{
+#ifdef SNDCTL_DSP_GETERROR
+	audio_errinfo info;
+
+	if ( ioctl(audio_fd, SNDCTL_DSP_GETERROR, &info) == 0 ) {
+		this->underruns += this->iscapture ?
+			info.rec_overruns : info.play_underruns;
+	}
+#endif
+}
+
 static void DSP_PlayAudio(_THIS)
 {
 	if (write(audio_fd, mixbuf, mixlen)==-1)
@@ -137,6 +157,7 @@ static void DSP_PlayAudio(_THIS)
 		perror("Audio write");
 		this->enabled = 0;
 	}
+	DSP_CountErrors(this);
 
 #ifdef DEBUG_AUDIO
 	fprintf(stderr, "Wrote %d bytes of audio data\n", mixlen);
@@ -148,6 +169,56 @@ static Uint8 *DSP_GetAudioBuf(_THIS)
 	return(mixbuf);
 }
 
+static int DSP_CaptureAudio(_THIS, Uint8 *buf, int len)
+{
+	int got, amount;
+
+	/* Blocking reads wait for a fragment of audio to be recorded */
+	for ( got = 0; got < len; got += amount ) {
+		amount = read(audio_fd, buf+got, len-got);
+		if ( amount < 0 ) {
+			if ( errno == EINTR ) {
+				amount = 0;
+				continue;
+			}
+			perror("Audio read");
+			return(-1);
+		}
+		if ( amount == 0 ) {
+			break;
+		}
+	}
+	DSP_CountErrors(this);
+	return(got);
+}
+
+static int DSP_GetDelay(_THIS)
+{
+	audio_buf_info info;
+	int bytes;
+
+	if ( this->iscapture ) {
+		/* The recorded audio waiting to be read */
+		if ( ioctl(audio_fd, SNDCTL_DSP_GETISPACE, &info) < 0 ) {
+			return(-1);
+		}
+		bytes = info.bytes;
+	} else {
+#ifdef SNDCTL_DSP_GETODELAY
+		if ( ioctl(audio_fd, SNDCTL_DSP_GETODELAY, &bytes) < 0 ) {
+			return(-1);
+		}
+#else
+		/* Everything that isn't free space is waiting to be played */
+		if ( ioctl(audio_fd, SNDCTL_DSP_GETOSPACE, &info) < 0 ) {
+			return(-1);
+		}
+		bytes = (info.fragstotal * info.fragsize) - info.bytes;
+#endif
+	}
+	return(bytes / (((this->spec.format & 0xFF) / 8) * this->spec.channels));
+}
+
 static void DSP_CloseAudio(_THIS)
 {
 	if ( mixbuf != NULL ) {
@@ -163,6 +234,7 @@ static void DSP_CloseAudio(_THIS)
 static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
 {
 	char audiodev[1024];
+	int open_flags;
 	int format;
 	int value;
 	int frag_spec;
@@ -178,14 +250,20 @@ static int DSP_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	    spec->channels = 2;
 
 	/* Open the audio device */
-	audio_fd = SDL_OpenAudioPath(audiodev, sizeof(audiodev), OPEN_FLAGS, 0);
+	open_flags = this->iscapture ? OPEN_FLAGS_CAPTURE : OPEN_FLAGS;
+	if ( this->devname != NULL ) {
+		SDL_strlcpy(audiodev, this->devname, sizeof(audiodev));
+		audio_fd = open(audiodev, open_flags, 0);
+	} else {
+		audio_fd = SDL_OpenAudioPath(audiodev, sizeof(audiodev), open_flags, 0);
+	}
 	if ( audio_fd < 0 ) {
 		SDL_SetError("Couldn't open %s: %s", audiodev, strerror(errno));
 		return(-1);
 	}
 	mixbuf = NULL;
 
-	/* Make the file descriptor use blocking writes with fcntl() */
+	/* Make the file descriptor use blocking I/O with fcntl() */
 	{ long flags;
 		flags = fcntl(audio_fd, F_GETFL);
 		flags &= ~O_NONBLOCK;
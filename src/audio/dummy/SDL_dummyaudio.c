@@ -42,6 +42,7 @@ static void DUMMYAUD_WaitAudio(_THIS);
 static void DUMMYAUD_PlayAudio(_THIS);
 static Uint8 *DUMMYAUD_GetAudioBuf(_THIS);
 static void DUMMYAUD_CloseAudio(_THIS);
+static int DUMMYAUD_GetDelay(_THIS);
 
 /* Audio driver bootstrap functions */
 static int DUMMYAUD_Available(void)
@@ -85,6 +86,9 @@ static SDL_AudioDevice *DUMMYAUD_CreateDevice(int devindex)
 	this->PlayAudio = DUMMYAUD_PlayAudio;
 	this->GetAudioBuf = DUMMYAUD_GetAudioBuf;
 	this->CloseAudio = DUMMYAUD_CloseAudio;
+	this->GetDelay = DUMMYAUD_GetDelay;
+
+	this->multiopen = 1;
 
 	this->free = DUMMYAUD_DeleteDevice;
 
@@ -96,19 +100,39 @@ AudioBootStrap DUMMYAUD_bootstrap = {
 	DUMMYAUD_Available, DUMMYAUD_CreateDevice
 };
 
+/* The ticks when the pretend device will have played what it was given */
+static Uint32 DUMMYAUD_PlayedUntil(_THIS)
+{
+	return(this->hidden->start_ticks + (Uint32)
+		(((double) this->hidden->frames * 1000) / this->spec.freq));
+}
+
 /* This function waits until it is possible to write a full sound buffer */
 static void DUMMYAUD_WaitAudio(_THIS)
 {
-	/* Don't block on first calls to simulate initial fragment filling. */
-	if (this->hidden->initial_calls)
-		this->hidden->initial_calls--;
-	else
-		SDL_Delay(this->hidden->write_delay);
+	Sint32 ahead;
+
+	/* Keep two buffers in the pretend device, like real hardware */
+	ahead = (Sint32) (DUMMYAUD_PlayedUntil(this) - SDL_GetTicks());
+	ahead -= (Sint32) this->hidden->write_delay;
+	if ( ahead > 0 ) {
+		SDL_Delay(ahead);
+	}
 }
 
 static void DUMMYAUD_PlayAudio(_THIS)
 {
-	/* no-op...this is a null driver. */
+	Uint32 now = SDL_GetTicks();
+
+	/* The pretend device runs dry if a buffer comes after it's done */
+	if ( (Sint32) (now - DUMMYAUD_PlayedUntil(this)) > 0 ) {
+		if ( this->hidden->frames > 0 ) {
+			++this->underruns;
+		}
+		this->hidden->start_ticks = now;
+		this->hidden->frames = 0;
+	}
+	this->hidden->frames += this->spec.samples;
 }
 
 static Uint8 *DUMMYAUD_GetAudioBuf(_THIS)
@@ -116,6 +140,16 @@ static Uint8 *DUMMYAUD_GetAudioBuf(_THIS)
 	return(this->hidden->mixbuf);
 }
 
+static int DUMMYAUD_GetDelay(_THIS)
+{
+	Sint32 left = (Sint32) (DUMMYAUD_PlayedUntil(this) - SDL_GetTicks());
+
+	if ( left <= 0 ) {
+		return(0);
+	}
+	return((int) (((double) left * this->spec.freq) / 1000));
+}
+
 static void DUMMYAUD_CloseAudio(_THIS)
 {
 	if ( this->hidden->mixbuf != NULL ) {
@@ -142,11 +176,11 @@ static int DUMMYAUD_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	/*
 	 * We try to make this request more audio at the correct rate for
 	 *  a given audio spec, so timing stays fairly faithful.
-	 * Also, we have it not block at all for the first two calls, so
-	 *  it seems like we're filling two audio fragments right out of the
-	 *  gate, like other SDL drivers tend to do.
+	 * The pretend device starts out empty, so the first two buffers
+	 *  are asked for right away, like other SDL drivers tend to do.
 	 */
-	this->hidden->initial_calls = 2;
+	this->hidden->start_ticks = 0;
+	this->hidden->frames = 0;
 	this->hidden->write_delay =
 	               (Uint32) ((((float) spec->size) / bytes_per_sec) * 1000.0f);
 
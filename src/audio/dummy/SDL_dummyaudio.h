@@ -34,7 +34,10 @@ struct SDL_PrivateAudioData {
 	Uint8 *mixbuf;
 	Uint32 mixlen;
 	Uint32 write_delay;
-	Uint32 initial_calls;
+
+	/* The frames given to the pretend device since it started playing */
+	Uint32 start_ticks;
+	Uint32 frames;
 };
 
 #endif /* _SDL_dummyaudio_h */
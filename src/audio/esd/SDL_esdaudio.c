@@ -72,12 +72,14 @@ static struct {
 	{ "esd_play_stream",	(void **)&SDL_NAME(esd_play_stream)	},
 };
 
+/* The library is loaded once for each device, and unloaded with the last */
 static void UnloadESDLibrary()
 {
 	if ( esd_loaded ) {
-		SDL_UnloadObject(esd_handle);
-		esd_handle = NULL;
-		esd_loaded = 0;
+		if ( --esd_loaded == 0 ) {
+			SDL_UnloadObject(esd_handle);
+			esd_handle = NULL;
+		}
 	}
 }
 
@@ -85,6 +87,10 @@ static int LoadESDLibrary(void)
 {
 	int i, retval = -1;
 
+	if ( esd_loaded ) {
+		++esd_loaded;
+		return 0;
+	}
 	esd_handle = SDL_LoadObject(esd_library);
 	if ( esd_handle ) {
 		esd_loaded = 1;
@@ -159,6 +165,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		UnloadESDLibrary();
 		return(0);
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
@@ -171,6 +178,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->GetAudioBuf = ESD_GetAudioBuf;
 	this->CloseAudio = ESD_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	return this;
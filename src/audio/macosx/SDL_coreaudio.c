@@ -82,6 +82,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
     this->GetAudioBuf = Core_GetAudioBuf;
     this->CloseAudio = Core_CloseAudio;
 
+    this->multiopen = 1;
+
     this->free = Audio_DeleteDevice;
 
     return this;
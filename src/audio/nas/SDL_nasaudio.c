@@ -102,12 +102,17 @@ load_nas_syms(void)
 
 #ifdef SDL_AUDIO_DRIVER_NAS_DYNAMIC
 
+static int nas_loaded = 0;
+
+/* The library is loaded once for each device, and unloaded with the last */
 static void
 UnloadNASLibrary(void)
 {
-    if (nas_handle != NULL) {
-        SDL_UnloadObject(nas_handle);
-        nas_handle = NULL;
+    if (nas_loaded) {
+        if (--nas_loaded == 0) {
+            SDL_UnloadObject(nas_handle);
+            nas_handle = NULL;
+        }
     }
 }
 
@@ -115,7 +120,9 @@ static int
 LoadNASLibrary(void)
 {
     int retval = 0;
-    if (nas_handle == NULL) {
+    if (nas_loaded) {
+        ++nas_loaded;
+    } else {
         nas_handle = SDL_LoadObject(nas_library);
         if (nas_handle == NULL) {
             /* Copy error string so we can use it in a new SDL_SetError(). */
@@ -127,6 +134,7 @@ LoadNASLibrary(void)
             SDL_SetError("NAS: SDL_LoadObject('%s') failed: %s\n",
                          nas_library, err);
         } else {
+            nas_loaded = 1;
             retval = load_nas_syms();
             if (retval < 0) {
                 UnloadNASLibrary();
@@ -204,6 +212,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		UnloadNASLibrary();
 		return NULL;
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
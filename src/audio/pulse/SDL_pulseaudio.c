@@ -58,6 +58,8 @@ static Uint8 *PULSE_GetAudioBuf(_THIS);
 static void PULSE_CloseAudio(_THIS);
 static void PULSE_WaitDone(_THIS);
 static void PULSE_SetCaption(_THIS, const char *str);
+static int PULSE_CaptureAudio(_THIS, Uint8 *buf, int len);
+static int PULSE_GetDelay(_THIS);
 
 #ifdef SDL_AUDIO_DRIVER_PULSE_DYNAMIC
 
@@ -107,7 +109,12 @@ static pa_stream * (*SDL_NAME(pa_stream_new))(pa_context *c,
 static int (*SDL_NAME(pa_stream_connect_playback))(pa_stream *s, const char *dev,
 	const pa_buffer_attr *attr, pa_stream_flags_t flags,
 	pa_cvolume *volume, pa_stream *sync_stream);
+static int (*SDL_NAME(pa_stream_connect_record))(pa_stream *s, const char *dev,
+	const pa_buffer_attr *attr, pa_stream_flags_t flags);
 static pa_stream_state_t (*SDL_NAME(pa_stream_get_state))(pa_stream *s);
+static size_t (*SDL_NAME(pa_stream_readable_size))(pa_stream *s);
+static int (*SDL_NAME(pa_stream_peek))(pa_stream *s, const void **data, size_t *nbytes);
+static int (*SDL_NAME(pa_stream_drop))(pa_stream *s);
 static size_t (*SDL_NAME(pa_stream_writable_size))(pa_stream *s);
 static int (*SDL_NAME(pa_stream_write))(pa_stream *s, const void *data, size_t nbytes,
 	pa_free_cb_t free_cb, int64_t offset, pa_seek_mode_t seek);
@@ -115,6 +122,12 @@ static pa_operation * (*SDL_NAME(pa_stream_drain))(pa_stream *s,
 	pa_stream_success_cb_t cb, void *userdata);
 static int (*SDL_NAME(pa_stream_disconnect))(pa_stream *s);
 static void (*SDL_NAME(pa_stream_unref))(pa_stream *s);
+static int (*SDL_NAME(pa_stream_get_latency))(pa_stream *s,
+	pa_usec_t *r_usec, int *negative);
+static void (*SDL_NAME(pa_stream_set_underflow_callback))(pa_stream *s,
+	pa_stream_notify_cb_t cb, void *userdata);
+static void (*SDL_NAME(pa_stream_set_overflow_callback))(pa_stream *s,
+	pa_stream_notify_cb_t cb, void *userdata);
 static pa_operation* (*SDL_NAME(pa_context_set_name))(pa_context *c,
 	const char *name, pa_context_success_cb_t cb, void *userdata);
 
@@ -156,8 +169,16 @@ static struct {
 		(void **)&SDL_NAME(pa_stream_new)		},
 	{ "pa_stream_connect_playback",
 		(void **)&SDL_NAME(pa_stream_connect_playback)	},
+	{ "pa_stream_connect_record",
+		(void **)&SDL_NAME(pa_stream_connect_record)	},
 	{ "pa_stream_get_state",
 		(void **)&SDL_NAME(pa_stream_get_state)		},
+	{ "pa_stream_readable_size",
+		(void **)&SDL_NAME(pa_stream_readable_size)	},
+	{ "pa_stream_peek",
+		(void **)&SDL_NAME(pa_stream_peek)		},
+	{ "pa_stream_drop",
+		(void **)&SDL_NAME(pa_stream_drop)		},
 	{ "pa_stream_writable_size",
 		(void **)&SDL_NAME(pa_stream_writable_size)	},
 	{ "pa_stream_write",
@@ -168,16 +189,24 @@ static struct {
 		(void **)&SDL_NAME(pa_stream_disconnect)	},
 	{ "pa_stream_unref",
 		(void **)&SDL_NAME(pa_stream_unref)		},
+	{ "pa_stream_get_latency",
+		(void **)&SDL_NAME(pa_stream_get_latency)	},
+	{ "pa_stream_set_underflow_callback",
+		(void **)&SDL_NAME(pa_stream_set_underflow_callback)	},
+	{ "pa_stream_set_overflow_callback",
+		(void **)&SDL_NAME(pa_stream_set_overflow_callback)	},
 	{ "pa_context_set_name",
 		(void **)&SDL_NAME(pa_context_set_name)		},
 };
 
+/* The library is loaded once for each device, and unloaded with the last */
 static void UnloadPulseLibrary()
 {
 	if ( pulse_loaded ) {
-		SDL_UnloadObject(pulse_handle);
-		pulse_handle = NULL;
-		pulse_loaded = 0;
+		if ( --pulse_loaded == 0 ) {
+			SDL_UnloadObject(pulse_handle);
+			pulse_handle = NULL;
+		}
 	}
 }
 
@@ -185,6 +214,10 @@ static int LoadPulseLibrary(void)
 {
 	int i, retval = -1;
 
+	if ( pulse_loaded ) {
+		++pulse_loaded;
+		return 0;
+	}
 	pulse_handle = SDL_LoadObject(pulse_library);
 	if ( pulse_handle ) {
 		pulse_loaded = 1;
@@ -277,6 +310,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		UnloadPulseLibrary();
 		return(0);
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
@@ -289,6 +323,10 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->CloseAudio = PULSE_CloseAudio;
 	this->WaitDone = PULSE_WaitDone;
 	this->SetCaption = PULSE_SetCaption;
+	this->CaptureAudio = PULSE_CaptureAudio;
+	this->GetDelay = PULSE_GetDelay;
+
+	this->multiopen = 1;
 
 	this->free = Audio_DeleteDevice;
 
@@ -329,12 +367,83 @@ static Uint8 *PULSE_GetAudioBuf(_THIS)
 	return(mixbuf);
 }
 
+static int PULSE_CaptureAudio(_THIS, Uint8 *buf, int len)
+{
+	const void *data;
+	size_t nbytes;
+	int got, amount;
+
+	got = 0;
+	while ( (got < len) && this->enabled ) {
+		/* Wait for the next fragment once the last one is used up */
+		if ( this->hidden->capturelen == 0 ) {
+			if (SDL_NAME(pa_context_get_state)(context) != PA_CONTEXT_READY ||
+			    SDL_NAME(pa_stream_get_state)(stream) != PA_STREAM_READY) {
+				return(-1);
+			}
+			if (SDL_NAME(pa_stream_readable_size)(stream) == 0) {
+				if (SDL_NAME(pa_mainloop_iterate)(mainloop, 1, NULL) < 0) {
+					return(-1);
+				}
+				continue;
+			}
+			if (SDL_NAME(pa_stream_peek)(stream, &data, &nbytes) < 0) {
+				return(-1);
+			}
+			if ( data == NULL ) {
+				/* Skip over holes in the stream */
+				if ( nbytes > 0 ) {
+					SDL_NAME(pa_stream_drop)(stream);
+				}
+				continue;
+			}
+			this->hidden->capturebuf = (const Uint8 *)data;
+			this->hidden->capturelen = nbytes;
+		}
+
+		amount = len - got;
+		if ( (size_t)amount > this->hidden->capturelen ) {
+			amount = (int)this->hidden->capturelen;
+		}
+		SDL_memcpy(buf + got, this->hidden->capturebuf, amount);
+		this->hidden->capturebuf += amount;
+		this->hidden->capturelen -= amount;
+		got += amount;
+		if ( this->hidden->capturelen == 0 ) {
+			SDL_NAME(pa_stream_drop)(stream);
+		}
+	}
+	return(got);
+}
+
+static int PULSE_GetDelay(_THIS)
+{
+	pa_usec_t usec;
+	int negative;
+	int frames;
+
+	/* The server keeps the timing info up to date as the loop runs */
+	if (SDL_NAME(pa_stream_get_latency)(stream, &usec, &negative) < 0) {
+		return(-1);
+	}
+	frames = negative ? 0 : (int)((usec * this->spec.freq) / 1000000);
+
+	/* What's left of a captured fragment hasn't been read yet either */
+	if ( this->iscapture ) {
+		frames += (int)(this->hidden->capturelen /
+			(((this->spec.format & 0xFF) / 8) * this->spec.channels));
+	}
+	return(frames);
+}
+
 static void PULSE_CloseAudio(_THIS)
 {
 	if ( mixbuf != NULL ) {
 		SDL_FreeAudioMem(mixbuf);
 		mixbuf = NULL;
 	}
+	this->hidden->capturebuf = NULL;
+	this->hidden->capturelen = 0;
 	if ( stream != NULL ) {
 		SDL_NAME(pa_stream_disconnect)(stream);
 		SDL_NAME(pa_stream_unref)(stream);
@@ -403,6 +512,14 @@ static void stream_drain_complete(pa_stream *s, int success, void *userdata)
 	/* no-op. */
 }
 
+/* Called from the mainloop, which only runs on the audio thread */
+static void stream_xrun(pa_stream *s, void *userdata)
+{
+	SDL_AudioDevice *this = (SDL_AudioDevice *)userdata;
+
+	++this->underruns;
+}
+
 static void PULSE_WaitDone(_THIS)
 {
 	pa_operation *o;
@@ -485,6 +602,11 @@ static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
 	paattr.maxlength = mixlen*2;
 	paattr.minreq = mixlen;
 #endif
+	/* Have the server send the timing info used for the latency */
+	flags |= PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
+
+	/* Capture devices are sent a fragment per buffer */
+	paattr.fragsize = mixlen;
 
 	/* The SDL ALSA output hints us that we use Windows' channel mapping */
 	/* http://bugzilla.libsdl.org/show_bug.cgi?id=110 */
@@ -545,8 +667,16 @@ static int PULSE_OpenAudio(_THIS, SDL_AudioSpec *spec)
 		return(-1);
 	}
 
-	if (SDL_NAME(pa_stream_connect_playback)(stream, NULL, &paattr, flags,
-			NULL, NULL) < 0) {
+	if ( this->iscapture ) {
+		SDL_NAME(pa_stream_set_overflow_callback)(stream, stream_xrun, this);
+		state = SDL_NAME(pa_stream_connect_record)(stream, this->devname,
+				&paattr, flags);
+	} else {
+		SDL_NAME(pa_stream_set_underflow_callback)(stream, stream_xrun, this);
+		state = SDL_NAME(pa_stream_connect_playback)(stream, this->devname,
+				&paattr, flags, NULL, NULL);
+	}
+	if ( state < 0 ) {
 		PULSE_CloseAudio(this);
 		SDL_SetError("Could not connect PulseAudio stream");
 		return(-1);
@@ -42,6 +42,10 @@ struct SDL_PrivateAudioData {
 	/* Raw mixing buffer */
 	Uint8 *mixbuf;
 	int    mixlen;
+
+	/* What is left of the fragment being read by a capture device */
+	const Uint8 *capturebuf;
+	size_t capturelen;
 };
 
 #if (PA_API_VERSION < 12)
@@ -88,6 +88,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->GetAudioBuf = SNDIO_GetAudioBuf;
 	this->CloseAudio = SNDIO_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	hdl = NULL;
@@ -110,6 +110,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->GetAudioBuf = DSP_GetAudioBuf;
 	this->CloseAudio = DSP_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	return this;
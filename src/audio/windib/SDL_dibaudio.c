@@ -87,6 +87,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->WaitDone = DIB_WaitDone;
 	this->CloseAudio = DIB_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	return this;
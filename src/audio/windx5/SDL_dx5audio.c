@@ -97,24 +97,33 @@ static int Audio_Available(void)
 	return(dsound_ok);
 }
 
-/* Functions for loading the DirectX functions dynamically */
+/* Functions for loading the DirectX functions dynamically.
+   DSOUND.DLL is loaded once for each device, and unloaded with the last.
+ */
 static HINSTANCE DSoundDLL = NULL;
+static int DSoundLoaded = 0;
 
 static void DX5_Unload(void)
 {
-	if ( DSoundDLL != NULL ) {
-		FreeLibrary(DSoundDLL);
-		DSoundCreate = NULL;
-		DSoundDLL = NULL;
+	if ( DSoundLoaded ) {
+		if ( --DSoundLoaded == 0 ) {
+			FreeLibrary(DSoundDLL);
+			DSoundCreate = NULL;
+			DSoundDLL = NULL;
+		}
 	}
 }
 static int DX5_Load(void)
 {
 	int status;
 
-	DX5_Unload();
+	if ( DSoundLoaded ) {
+		++DSoundLoaded;
+		return 0;
+	}
 	DSoundDLL = LoadLibrary(TEXT("DSOUND.DLL"));
 	if ( DSoundDLL != NULL ) {
+		DSoundLoaded = 1;
 		DSoundCreate = (void *)GetProcAddress(DSoundDLL,
 					TEXT("DirectSoundCreate"));
 	}
@@ -155,6 +164,7 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 		if ( this ) {
 			SDL_free(this);
 		}
+		DX5_Unload();
 		return(0);
 	}
 	SDL_memset(this->hidden, 0, (sizeof *this->hidden));
@@ -168,6 +178,8 @@ static SDL_AudioDevice *Audio_CreateDevice(int devindex)
 	this->WaitDone = DX5_WaitDone;
 	this->CloseAudio = DX5_CloseAudio;
 
+	this->multiopen = 1;
+
 	this->free = Audio_DeleteDevice;
 
 	return this;
@@ -69,16 +69,42 @@
 #include <swis.h>
 #endif
 
-#define CPU_HAS_RDTSC	0x00000001
-#define CPU_HAS_MMX	0x00000002
-#define CPU_HAS_MMXEXT	0x00000004
-#define CPU_HAS_3DNOW	0x00000010
-#define CPU_HAS_3DNOWEXT 0x00000020
-#define CPU_HAS_SSE	0x00000040
-#define CPU_HAS_SSE2	0x00000080
-#define CPU_HAS_ALTIVEC	0x00000100
-#define CPU_HAS_ARM_SIMD 0x00000200
-#define CPU_HAS_NEON     0x00000400
+#if defined(__WIN32__)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if defined(__MACOSX__)
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#endif
+#if defined(_MSC_VER) && (_MSC_VER >= 1500) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define HAVE_MSC_CPUIDEX	1
+#endif
+
+#define CPU_HAS_RDTSC		SDL_CPU_RDTSC
+#define CPU_HAS_MMX		SDL_CPU_MMX
+#define CPU_HAS_MMXEXT		SDL_CPU_MMXEXT
+#define CPU_HAS_3DNOW		SDL_CPU_3DNOW
+#define CPU_HAS_3DNOWEXT	SDL_CPU_3DNOWEXT
+#define CPU_HAS_SSE		SDL_CPU_SSE
+#define CPU_HAS_SSE2		SDL_CPU_SSE2
+#define CPU_HAS_ALTIVEC		SDL_CPU_ALTIVEC
+#define CPU_HAS_ARM_SIMD	SDL_CPU_ARM_SIMD
+#define CPU_HAS_NEON		SDL_CPU_NEON
+#define CPU_HAS_SSE3		SDL_CPU_SSE3
+#define CPU_HAS_SSSE3		SDL_CPU_SSSE3
+#define CPU_HAS_SSE41		SDL_CPU_SSE41
+#define CPU_HAS_SSE42		SDL_CPU_SSE42
+#define CPU_HAS_AVX		SDL_CPU_AVX
+#define CPU_HAS_AVX2		SDL_CPU_AVX2
+#define CPU_HAS_FMA		SDL_CPU_FMA
+#define CPU_HAS_AVX512F		SDL_CPU_AVX512F
+
+/* Used when the cache line size can't be queried */
+#define SDL_CACHELINE_SIZE	128
 
 #if SDL_ALTIVEC_BLITTERS && HAVE_SETJMP && !__MACOSX__ && !__OpenBSD__
 /* This is the brute force way of detecting instruction sets...
@@ -339,6 +365,149 @@ done:
 	return features;
 }
 
+/* Run CPUID for a leaf and subleaf, the caller checks that CPUID exists
+   and that the leaf is supported.  Returns 0 if it couldn't be run.
+ */
+static __inline__ int CPU_cpuid(Uint32 leaf, Uint32 subleaf, Uint32 regs[4])
+{
+#if defined(__GNUC__) && defined(__i386__)
+	__asm__ __volatile__ (
+"        pushl   %%ebx                                                 \n"
+"        cpuid                                                         \n"
+"        movl    %%ebx,%%esi                                           \n"
+"        popl    %%ebx                                                 \n"
+	: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (leaf), "c" (subleaf)
+	);
+	return 1;
+#elif defined(__GNUC__) && defined(__x86_64__)
+	__asm__ __volatile__ (
+"        pushq   %%rbx                                                 \n"
+"        cpuid                                                         \n"
+"        movq    %%rbx,%%rsi                                           \n"
+"        popq    %%rbx                                                 \n"
+	: "=a" (regs[0]), "=S" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+	: "a" (leaf), "c" (subleaf)
+	);
+	return 1;
+#elif defined(HAVE_MSC_CPUIDEX)
+	int info[4];
+	__cpuidex(info, (int)leaf, (int)subleaf);
+	regs[0] = info[0];
+	regs[1] = info[1];
+	regs[2] = info[2];
+	regs[3] = info[3];
+	return 1;
+#elif (defined(_MSC_VER) && defined(_M_IX86)) || defined(__WATCOMC__)
+	Uint32 a, b, c, d;
+	__asm {
+        mov     eax, leaf
+        mov     ecx, subleaf
+        push    ebx
+        cpuid
+        mov     esi, ebx
+        pop     ebx
+        mov     a, eax
+        mov     b, esi
+        mov     c, ecx
+        mov     d, edx
+	}
+	regs[0] = a;
+	regs[1] = b;
+	regs[2] = c;
+	regs[3] = d;
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/* The highest standard CPUID leaf, or 0 */
+static __inline__ Uint32 CPU_getCPUIDMaxLeaf(void)
+{
+	Uint32 regs[4];
+
+	if ( CPU_haveCPUID() && CPU_cpuid(0, 0, regs) ) {
+		return regs[0];
+	}
+	return 0;
+}
+
+/* The OS must save the wider registers on context switches, which is
+   reported by XGETBV once CPUID says the OS has enabled it (OSXSAVE).
+ */
+static __inline__ Uint32 CPU_getXCR0(void)
+{
+	Uint32 xcr0 = 0;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	Uint32 edx;
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0  # xgetbv"
+	                      : "=a" (xcr0), "=d" (edx) : "c" (0));
+#elif defined(_MSC_VER) && (_MSC_FULL_VER >= 160040219)
+	xcr0 = (Uint32)_xgetbv(0);
+#elif (defined(_MSC_VER) && defined(_M_IX86)) || defined(__WATCOMC__)
+	__asm {
+        xor     ecx, ecx
+        _emit   0x0f
+        _emit   0x01
+        _emit   0xd0
+        mov     xcr0, eax
+	}
+#endif
+	return xcr0;
+}
+
+#define XCR0_SSE_AVX	0x00000006	/* XMM and YMM state */
+#define XCR0_AVX512	0x000000E6	/* ... and opmask and ZMM state */
+
+/* Adds the features from CPUID leaf 1 ECX and leaf 7 EBX */
+static __inline__ Uint32 CPU_getCPUIDFeaturesModern(void)
+{
+	Uint32 features = 0;
+	Uint32 maxleaf, xcr0 = 0;
+	Uint32 regs[4];
+
+	maxleaf = CPU_getCPUIDMaxLeaf();
+	if ( maxleaf < 1 || !CPU_cpuid(1, 0, regs) ) {
+		return 0;
+	}
+	if ( regs[2] & 0x00000001 ) {
+		features |= CPU_HAS_SSE3;
+	}
+	if ( regs[2] & 0x00000200 ) {
+		features |= CPU_HAS_SSSE3;
+	}
+	if ( regs[2] & 0x00080000 ) {
+		features |= CPU_HAS_SSE41;
+	}
+	if ( regs[2] & 0x00100000 ) {
+		features |= CPU_HAS_SSE42;
+	}
+	if ( regs[2] & 0x08000000 ) {	/* OSXSAVE */
+		xcr0 = CPU_getXCR0();
+	}
+	if ( (xcr0 & XCR0_SSE_AVX) != XCR0_SSE_AVX ) {
+		/* The OS doesn't support AVX, so none of the rest is usable */
+		return features;
+	}
+	if ( regs[2] & 0x10000000 ) {
+		features |= CPU_HAS_AVX;
+	}
+	if ( regs[2] & 0x00001000 ) {
+		features |= CPU_HAS_FMA;
+	}
+	if ( maxleaf >= 7 && CPU_cpuid(7, 0, regs) ) {
+		if ( regs[1] & 0x00000020 ) {
+			features |= CPU_HAS_AVX2;
+		}
+		if ( (regs[1] & 0x00010000) &&
+		     (xcr0 & XCR0_AVX512) == XCR0_AVX512 ) {
+			features |= CPU_HAS_AVX512F;
+		}
+	}
+	return features;
+}
+
 static __inline__ int CPU_haveRDTSC(void)
 {
 	if ( CPU_haveCPUID() ) {
@@ -571,10 +740,16 @@ static __inline__ int CPU_haveNEON(void)
 }
 
 static Uint32 SDL_CPUFeatures = 0xFFFFFFFF;
+static Uint32 SDL_CPUFeatureMask = 0xFFFFFFFF;
 
 static Uint32 SDL_GetCPUFeatures(void)
 {
 	if ( SDL_CPUFeatures == 0xFFFFFFFF ) {
+		/* Provide an override for testing and benchmarking */
+		const char *mask = SDL_getenv("SDL_CPU_FEATURE_MASK");
+		if ( mask ) {
+			SDL_CPUFeatureMask = (Uint32)SDL_strtoul(mask, NULL, 0);
+		}
 		SDL_CPUFeatures = 0;
 		if ( CPU_haveRDTSC() ) {
 			SDL_CPUFeatures |= CPU_HAS_RDTSC;
@@ -606,8 +781,24 @@ static Uint32 SDL_GetCPUFeatures(void)
 		if ( CPU_haveNEON() ) {
 			SDL_CPUFeatures |= CPU_HAS_NEON;
 		}
+		if ( CPU_haveCPUID() ) {
+			SDL_CPUFeatures |= CPU_getCPUIDFeaturesModern();
+		}
 	}
-	return SDL_CPUFeatures;
+	return SDL_CPUFeatures & SDL_CPUFeatureMask;
+}
+
+void SDL_SetCPUFeatureMask(Uint32 mask)
+{
+	/* Detect first, so the environment doesn't override this later */
+	SDL_GetCPUFeatures();
+	SDL_CPUFeatureMask = mask;
+}
+
+Uint32 SDL_GetCPUFeatureMask(void)
+{
+	SDL_GetCPUFeatures();
+	return SDL_CPUFeatureMask;
 }
 
 SDL_bool SDL_HasRDTSC(void)
@@ -690,6 +881,149 @@ SDL_bool SDL_HasNEON(void)
 	return SDL_FALSE;
 }
 
+SDL_bool SDL_HasSSE3(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE3 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSSE3(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSSE3 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSE41(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE41 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasSSE42(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_SSE42 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX2(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX2 ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasFMA(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_FMA ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+SDL_bool SDL_HasAVX512F(void)
+{
+	if ( SDL_GetCPUFeatures() & CPU_HAS_AVX512F ) {
+		return SDL_TRUE;
+	}
+	return SDL_FALSE;
+}
+
+static int SDL_CPUCount = 0;
+
+int SDL_GetCPUCount(void)
+{
+	if ( !SDL_CPUCount ) {
+#if defined(__WIN32__)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		SDL_CPUCount = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+		SDL_CPUCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined(__MACOSX__)
+		size_t size = sizeof(SDL_CPUCount);
+		sysctlbyname("hw.ncpu", &SDL_CPUCount, &size, NULL, 0);
+#endif
+		/* There's at least the one we're running on */
+		if ( SDL_CPUCount <= 0 ) {
+			SDL_CPUCount = 1;
+		}
+	}
+	return SDL_CPUCount;
+}
+
+static int SDL_CPUCacheLineSize = 0;
+
+int SDL_GetCPUCacheLineSize(void)
+{
+	Uint32 regs[4];
+
+	if ( !SDL_CPUCacheLineSize ) {
+		/* The CLFLUSH line size, in units of 8 bytes */
+		if ( CPU_getCPUIDMaxLeaf() >= 1 && CPU_cpuid(1, 0, regs) &&
+		     (regs[3] & 0x00080000) ) {
+			SDL_CPUCacheLineSize = ((regs[1] >> 8) & 0xFF) * 8;
+		}
+#if defined(_SC_LEVEL1_DCACHE_LINESIZE)
+		if ( SDL_CPUCacheLineSize <= 0 ) {
+			SDL_CPUCacheLineSize = (int)sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+		}
+#elif defined(__MACOSX__)
+		if ( SDL_CPUCacheLineSize <= 0 ) {
+			size_t size = sizeof(SDL_CPUCacheLineSize);
+			sysctlbyname("hw.cachelinesize", &SDL_CPUCacheLineSize, &size, NULL, 0);
+		}
+#endif
+		if ( SDL_CPUCacheLineSize <= 0 ) {
+			SDL_CPUCacheLineSize = SDL_CACHELINE_SIZE;
+		}
+	}
+	return SDL_CPUCacheLineSize;
+}
+
+static int SDL_SystemRAM = 0;
+
+int SDL_GetSystemRAM(void)
+{
+	if ( !SDL_SystemRAM ) {
+#if defined(__WIN32__)
+		MEMORYSTATUS status;
+		status.dwLength = sizeof(status);
+		GlobalMemoryStatus(&status);
+		SDL_SystemRAM = (int)(status.dwTotalPhys / (1024*1024));
+#elif defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+		long pages = sysconf(_SC_PHYS_PAGES);
+		long pagesize = sysconf(_SC_PAGESIZE);
+		if ( pages > 0 && pagesize > 0 ) {
+			SDL_SystemRAM = (int)((double)pages * pagesize / (1024*1024));
+		}
+#elif defined(__MACOSX__)
+		Uint64 memsize = 0;
+		size_t size = sizeof(memsize);
+		if ( sysctlbyname("hw.memsize", &memsize, &size, NULL, 0) == 0 ) {
+			SDL_SystemRAM = (int)(memsize / (1024*1024));
+		}
+#endif
+	}
+	return SDL_SystemRAM;
+}
+
 #ifdef TEST_MAIN
 
 #include <stdio.h>
@@ -706,6 +1040,17 @@ int main()
 	printf("AltiVec: %d\n", SDL_HasAltiVec());
 	printf("ARM SIMD: %d\n", SDL_HasARMSIMD());
 	printf("NEON: %d\n", SDL_HasNEON());
+	printf("SSE3: %d\n", SDL_HasSSE3());
+	printf("SSSE3: %d\n", SDL_HasSSSE3());
+	printf("SSE4.1: %d\n", SDL_HasSSE41());
+	printf("SSE4.2: %d\n", SDL_HasSSE42());
+	printf("AVX: %d\n", SDL_HasAVX());
+	printf("AVX2: %d\n", SDL_HasAVX2());
+	printf("FMA: %d\n", SDL_HasFMA());
+	printf("AVX-512F: %d\n", SDL_HasAVX512F());
+	printf("CPU count: %d\n", SDL_GetCPUCount());
+	printf("Cache line size: %d\n", SDL_GetCPUCacheLineSize());
+	printf("System RAM: %d MB\n", SDL_GetSystemRAM());
 	return 0;
 }
 
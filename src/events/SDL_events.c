@@ -90,6 +90,7 @@ void SDL_Unlock_EventThread(void)
 static int SDLCALL SDL_GobbleEvents(void *unused)
 {
 	event_thread = SDL_ThreadID();
+	SDL_SetThreadName("SDLEvents");
 
 #ifdef __OS2__
 #ifdef USE_DOSSETPRIORITY
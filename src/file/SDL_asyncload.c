@@ -0,0 +1,578 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Load bitmaps, sounds and raw data on a pool of background threads */
+
+#include "SDL_asyncload.h"
+#include "SDL_events.h"
+#include "SDL_thread.h"
+#include "SDL_mutex.h"
+
+#define ASYNC_DEFAULT_THREADS	2
+#define ASYNC_MAX_THREADS	16
+
+typedef enum {
+	ASYNC_BMP,
+	ASYNC_WAV,
+	ASYNC_DATA
+} async_type;
+
+struct SDL_AsyncLoad {
+	async_type type;
+	SDL_AsyncRequest request;
+	char *file;
+	SDL_PixelFormat format;
+	SDL_Palette palette;
+	SDL_AudioSpec spec;
+	volatile int status;
+	int finished;		/* Completion has been fully reported */
+	char error[128];
+
+	/* The result of the load */
+	SDL_Surface *surface;
+	SDL_AudioSpec wavspec;
+	Uint8 *data;
+	Uint32 datalen;
+
+	struct SDL_AsyncLoad *next;
+};
+
+/* The pool of loading threads, started with the first request */
+static SDL_mutex *async_lock = NULL;
+static SDL_cond *async_wake = NULL;	/* A request was queued */
+static SDL_cond *async_done = NULL;	/* A request was completed */
+static SDL_AsyncLoad *async_queue = NULL;	/* Sorted by priority */
+static SDL_Thread *async_threads[ASYNC_MAX_THREADS];
+static int async_numthreads = 0;
+static int async_quit = 0;
+
+static int LoadData(SDL_AsyncLoad *load, SDL_RWops *src)
+{
+	int size, len;
+
+	size = SDL_RWseek(src, 0, RW_SEEK_END);
+	if ( (size < 0) || (SDL_RWseek(src, 0, RW_SEEK_SET) < 0) ) {
+		SDL_Error(SDL_EFSEEK);
+		return(-1);
+	}
+	/* Allocate one extra byte so text can be null terminated */
+	load->data = (Uint8 *)SDL_malloc(size+1);
+	if ( load->data == NULL ) {
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	len = (size > 0) ? SDL_RWread(src, load->data, size, 1) : 1;
+	if ( len != 1 ) {
+		SDL_Error(SDL_EFREAD);
+		return(-1);
+	}
+	load->data[size] = '\0';
+	load->datalen = size;
+	return(0);
+}
+
+#if !SDL_VIDEO_DISABLED
+static int LoadBMP(SDL_AsyncLoad *load, SDL_RWops *src)
+{
+	if ( load->request.format ) {
+		load->surface = SDL_LoadBMPFormat_RW(src, 0,
+				&load->format, load->request.flags);
+	} else {
+		load->surface = SDL_LoadBMP_RW(src, 0);
+	}
+	if ( load->surface == NULL ) {
+		return(-1);
+	}
+	return(0);
+}
+#endif /* !SDL_VIDEO_DISABLED */
+
+#if !SDL_AUDIO_DISABLED
+static int LoadWAV(SDL_AsyncLoad *load, SDL_RWops *src)
+{
+	SDL_AudioCVT cvt;
+	Uint8 *buf;
+	int status;
+
+	if ( SDL_LoadWAV_RW(src, 0, &load->wavspec,
+				&load->data, &load->datalen) == NULL ) {
+		return(-1);
+	}
+	if ( !load->request.spec ) {
+		return(0);
+	}
+	status = SDL_BuildAudioCVT(&cvt,
+			load->wavspec.format, load->wavspec.channels,
+			load->wavspec.freq,
+			load->spec.format, load->spec.channels,
+			load->spec.freq);
+	if ( status < 0 ) {
+		return(-1);
+	}
+	if ( status > 0 ) {
+		buf = (Uint8 *)SDL_realloc(load->data, load->datalen*cvt.len_mult);
+		if ( buf == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		load->data = buf;
+		cvt.buf = buf;
+		cvt.len = load->datalen;
+		if ( SDL_ConvertAudio(&cvt) < 0 ) {
+			return(-1);
+		}
+		load->datalen = cvt.len_cvt;
+	}
+	load->wavspec.format = load->spec.format;
+	load->wavspec.channels = load->spec.channels;
+	load->wavspec.freq = load->spec.freq;
+	return(0);
+}
+#endif /* !SDL_AUDIO_DISABLED */
+
+static void FreeResult(SDL_AsyncLoad *load)
+{
+#if !SDL_VIDEO_DISABLED
+	if ( load->surface ) {
+		SDL_FreeSurface(load->surface);
+		load->surface = NULL;
+	}
+#endif
+	if ( load->data ) {
+		SDL_free(load->data);
+		load->data = NULL;
+	}
+}
+
+/* Load the data for a request, called without the lock held */
+static void RunLoad(SDL_AsyncLoad *load)
+{
+	SDL_RWops *src;
+	int retval;
+
+	if ( load->file ) {
+		src = SDL_RWFromMappedFile(load->file);
+	} else {
+		src = load->request.src;
+	}
+	if ( src == NULL ) {
+		retval = -1;
+	} else {
+		switch (load->type) {
+#if !SDL_VIDEO_DISABLED
+			case ASYNC_BMP:
+				retval = LoadBMP(load, src);
+				break;
+#endif
+#if !SDL_AUDIO_DISABLED
+			case ASYNC_WAV:
+				retval = LoadWAV(load, src);
+				break;
+#endif
+			case ASYNC_DATA:
+				retval = LoadData(load, src);
+				break;
+			default:
+				SDL_SetError("Not supported in this build of SDL");
+				retval = -1;
+				break;
+		}
+		if ( load->file || load->request.freesrc ) {
+			SDL_RWclose(src);
+		}
+	}
+	if ( retval < 0 ) {
+		SDL_strlcpy(load->error, SDL_GetError(), sizeof(load->error));
+		FreeResult(load);
+		load->status = SDL_ASYNC_FAILED;
+	} else {
+		load->status = SDL_ASYNC_DONE;
+	}
+
+	/* Report the completion, the request may be freed after the event */
+	if ( load->request.callback ) {
+		load->request.callback(load, load->request.userdata);
+	}
+#if !SDL_EVENTS_DISABLED
+	if ( load->request.event ) {
+		SDL_Event event;
+
+		event.type = load->request.event;
+		event.user.code = load->status;
+		event.user.data1 = load;
+		event.user.data2 = load->request.userdata;
+		SDL_PushEvent(&event);
+	}
+#endif
+}
+
+#if !SDL_THREADS_DISABLED
+static int SDLCALL AsyncThread(void *data)
+{
+	SDL_AsyncLoad *load;
+
+	SDL_SetThreadName("SDLAsyncLoad");
+	SDL_mutexP(async_lock);
+	while ( !async_quit ) {
+		load = async_queue;
+		if ( load == NULL ) {
+			SDL_CondWait(async_wake, async_lock);
+			continue;
+		}
+		async_queue = load->next;
+		load->next = NULL;
+		load->status = SDL_ASYNC_RUNNING;
+		SDL_mutexV(async_lock);
+
+		RunLoad(load);
+
+		SDL_mutexP(async_lock);
+		load->finished = 1;
+		SDL_CondBroadcast(async_done);
+	}
+	SDL_mutexV(async_lock);
+	return(0);
+}
+
+static int StartThreads(void)
+{
+	const char *env;
+	int i, numthreads;
+
+	if ( async_numthreads > 0 ) {
+		return(0);
+	}
+
+	numthreads = ASYNC_DEFAULT_THREADS;
+	env = SDL_getenv("SDL_ASYNCLOAD_THREADS");
+	if ( env ) {
+		numthreads = SDL_atoi(env);
+	}
+	if ( numthreads < 1 ) {
+		numthreads = 1;
+	}
+	if ( numthreads > ASYNC_MAX_THREADS ) {
+		numthreads = ASYNC_MAX_THREADS;
+	}
+
+	async_quit = 0;
+	for ( i = 0; i < numthreads; ++i ) {
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
+#undef SDL_CreateThread
+		async_threads[i] = SDL_CreateThread(AsyncThread, NULL, NULL, NULL);
+#else
+		async_threads[i] = SDL_CreateThread(AsyncThread, NULL);
+#endif
+		if ( async_threads[i] == NULL ) {
+			break;
+		}
+		++async_numthreads;
+	}
+	if ( async_numthreads == 0 ) {
+		SDL_SetError("Couldn't create loading thread");
+		return(-1);
+	}
+	return(0);
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+static void FreeLoad(SDL_AsyncLoad *load)
+{
+	FreeResult(load);
+	if ( load->palette.colors ) {
+		SDL_free(load->palette.colors);
+	}
+	if ( load->file ) {
+		SDL_free(load->file);
+	}
+	SDL_free(load);
+}
+
+static SDL_AsyncLoad *QueueLoad(async_type type, const SDL_AsyncRequest *request)
+{
+	SDL_AsyncLoad *load;
+
+	if ( !request || (!request->file && !request->src) ) {
+		SDL_SetError("No file or source to load");
+		return NULL;
+	}
+
+	load = (SDL_AsyncLoad *)SDL_malloc(sizeof(*load));
+	if ( load == NULL ) {
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	SDL_memset(load, 0, sizeof(*load));
+	load->type = type;
+	load->request = *request;
+	if ( request->file ) {
+		load->file = SDL_strdup(request->file);
+		if ( load->file == NULL ) {
+			FreeLoad(load);
+			SDL_OutOfMemory();
+			return NULL;
+		}
+	}
+
+	/* Copy the target formats, the caller's may not outlive the request */
+	if ( request->format ) {
+		load->format = *request->format;
+		if ( request->format->palette ) {
+			load->palette.ncolors = request->format->palette->ncolors;
+			load->palette.colors = (SDL_Color *)SDL_malloc(
+				load->palette.ncolors*sizeof(SDL_Color));
+			if ( load->palette.colors == NULL ) {
+				FreeLoad(load);
+				SDL_OutOfMemory();
+				return NULL;
+			}
+			SDL_memcpy(load->palette.colors,
+				request->format->palette->colors,
+				load->palette.ncolors*sizeof(SDL_Color));
+			load->format.palette = &load->palette;
+		}
+	}
+	if ( request->spec ) {
+		load->spec = *request->spec;
+	}
+
+#if SDL_THREADS_DISABLED
+	/* No threads, load it right away */
+	load->status = SDL_ASYNC_RUNNING;
+	RunLoad(load);
+	load->finished = 1;
+#else
+	if ( !async_lock ) {
+		async_lock = SDL_CreateMutex();
+		async_wake = SDL_CreateCond();
+		async_done = SDL_CreateCond();
+		if ( !async_lock || !async_wake || !async_done ) {
+			FreeLoad(load);
+			return NULL;
+		}
+	}
+	SDL_mutexP(async_lock);
+	if ( StartThreads() < 0 ) {
+		SDL_mutexV(async_lock);
+		FreeLoad(load);
+		return NULL;
+	}
+	{
+		SDL_AsyncLoad **prev = &async_queue;
+
+		/* Insert after any request with the same or higher priority */
+		while ( *prev && ((*prev)->request.priority >= load->request.priority) ) {
+			prev = &(*prev)->next;
+		}
+		load->next = *prev;
+		*prev = load;
+	}
+	load->status = SDL_ASYNC_QUEUED;
+	SDL_CondSignal(async_wake);
+	SDL_mutexV(async_lock);
+#endif /* SDL_THREADS_DISABLED */
+	return(load);
+}
+
+SDL_AsyncLoad *SDL_LoadBMPAsync(const SDL_AsyncRequest *request)
+{
+	return QueueLoad(ASYNC_BMP, request);
+}
+
+SDL_AsyncLoad *SDL_LoadWAVAsync(const SDL_AsyncRequest *request)
+{
+	return QueueLoad(ASYNC_WAV, request);
+}
+
+SDL_AsyncLoad *SDL_LoadFileAsync(const SDL_AsyncRequest *request)
+{
+	return QueueLoad(ASYNC_DATA, request);
+}
+
+int SDL_GetAsyncStatus(SDL_AsyncLoad *load)
+{
+	if ( !load ) {
+		SDL_SetError("Passed a NULL load request");
+		return(-1);
+	}
+	return(load->status);
+}
+
+int SDL_CancelAsync(SDL_AsyncLoad *load)
+{
+	int retval = -1;
+
+	if ( !load ) {
+		SDL_SetError("Passed a NULL load request");
+		return(-1);
+	}
+#if !SDL_THREADS_DISABLED
+	if ( async_lock ) {
+		SDL_AsyncLoad **prev;
+
+		SDL_mutexP(async_lock);
+		for ( prev = &async_queue; *prev; prev = &(*prev)->next ) {
+			if ( *prev == load ) {
+				*prev = load->next;
+				load->next = NULL;
+				load->status = SDL_ASYNC_CANCELED;
+				load->finished = 1;
+				SDL_CondBroadcast(async_done);
+				retval = 0;
+				break;
+			}
+		}
+		SDL_mutexV(async_lock);
+	}
+#endif
+	return(retval);
+}
+
+int SDL_WaitAsync(SDL_AsyncLoad *load)
+{
+	if ( !load ) {
+		SDL_SetError("Passed a NULL load request");
+		return(-1);
+	}
+#if !SDL_THREADS_DISABLED
+	if ( async_lock ) {
+		SDL_mutexP(async_lock);
+		while ( !load->finished ) {
+			SDL_CondWait(async_done, async_lock);
+		}
+		SDL_mutexV(async_lock);
+	}
+#endif
+	return(load->status);
+}
+
+const char *SDL_GetAsyncError(SDL_AsyncLoad *load)
+{
+	if ( !load ) {
+		return "";
+	}
+	return(load->error);
+}
+
+SDL_Surface *SDL_GetAsyncSurface(SDL_AsyncLoad *load)
+{
+	SDL_Surface *surface;
+
+	if ( !load || (load->status != SDL_ASYNC_DONE) ) {
+		SDL_SetError("The load request isn't completed");
+		return NULL;
+	}
+	surface = load->surface;
+	load->surface = NULL;
+	return(surface);
+}
+
+SDL_AudioSpec *SDL_GetAsyncWAV(SDL_AsyncLoad *load, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+	if ( !load || (load->status != SDL_ASYNC_DONE) ||
+	     (load->type != ASYNC_WAV) || !load->data ) {
+		SDL_SetError("The load request isn't completed");
+		return NULL;
+	}
+	*spec = load->wavspec;
+	*audio_buf = load->data;
+	*audio_len = load->datalen;
+	load->data = NULL;
+	return(spec);
+}
+
+void *SDL_GetAsyncData(SDL_AsyncLoad *load, int *size)
+{
+	void *data;
+
+	if ( !load || (load->status != SDL_ASYNC_DONE) ||
+	     (load->type != ASYNC_DATA) || !load->data ) {
+		SDL_SetError("The load request isn't completed");
+		return NULL;
+	}
+	data = load->data;
+	if ( size ) {
+		*size = load->datalen;
+	}
+	load->data = NULL;
+	return(data);
+}
+
+void SDL_FreeAsync(SDL_AsyncLoad *load)
+{
+	if ( !load ) {
+		return;
+	}
+#if !SDL_THREADS_DISABLED
+	if ( async_lock ) {
+		if ( SDL_CancelAsync(load) < 0 ) {
+			SDL_WaitAsync(load);
+		}
+	}
+#endif
+	/* The source of a request that never ran still needs to be closed */
+	if ( (load->status == SDL_ASYNC_CANCELED) &&
+	     !load->file && load->request.freesrc ) {
+		SDL_RWclose(load->request.src);
+	}
+	FreeLoad(load);
+}
+
+/* Stop the loading threads, called by SDL_Quit() */
+void SDL_AsyncLoadQuit(void)
+{
+#if !SDL_THREADS_DISABLED
+	int i;
+
+	if ( !async_lock ) {
+		return;
+	}
+	SDL_mutexP(async_lock);
+	async_quit = 1;
+	SDL_CondBroadcast(async_wake);
+	SDL_mutexV(async_lock);
+	for ( i = 0; i < async_numthreads; ++i ) {
+		SDL_WaitThread(async_threads[i], NULL);
+		async_threads[i] = NULL;
+	}
+	async_numthreads = 0;
+
+	/* Anything still queued will never be loaded */
+	SDL_mutexP(async_lock);
+	while ( async_queue ) {
+		SDL_AsyncLoad *load = async_queue;
+		async_queue = load->next;
+		load->next = NULL;
+		load->status = SDL_ASYNC_CANCELED;
+		load->finished = 1;
+	}
+	SDL_mutexV(async_lock);
+
+	SDL_DestroyCond(async_done);
+	async_done = NULL;
+	SDL_DestroyCond(async_wake);
+	async_wake = NULL;
+	SDL_DestroyMutex(async_lock);
+	async_lock = NULL;
+#endif
+}
@@ -27,6 +27,18 @@
 
 #include "SDL_endian.h"
 #include "SDL_rwops.h"
+#include "SDL_thread.h"
+
+#if !defined(__WIN32__) && (defined(__unix__) || defined(__APPLE__))
+#include <unistd.h>
+#if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#define SDL_RWOPS_MMAP	1
+#endif
+#endif
 
 
 #if defined(__WIN32__) && !defined(__SYMBIAN32__)
@@ -433,6 +445,278 @@ static int SDLCALL mem_close(SDL_RWops *context)
 	return(0);
 }
 
+#ifdef SDL_RWOPS_MMAP
+
+/* Functions to read memory mapped files, the mapping is a const memory area */
+
+static int SDLCALL mmap_close(SDL_RWops *context)
+{
+	if ( context ) {
+		munmap(context->hidden.mem.base,
+		       context->hidden.mem.stop-context->hidden.mem.base);
+		SDL_FreeRW(context);
+	}
+	return(0);
+}
+#endif /* SDL_RWOPS_MMAP */
+
+
+/* Functions to read buffered from another SDL_RWops */
+
+#define RWBUFFER_DEFAULT_SIZE	4096
+
+typedef struct rwbuffer {
+	SDL_RWops *src;
+	int freesrc;
+	int size;		/* Size of each buffer */
+	Uint8 *data;		/* The buffer being read from */
+	int here;		/* The read position in data */
+	int stop;		/* The number of valid bytes in data */
+	int offset;		/* The source offset of data[0] */
+#if !SDL_THREADS_DISABLED
+	/* The read-ahead thread fills 'ahead' while 'data' is consumed */
+	SDL_Thread *thread;
+	SDL_mutex *lock;
+	SDL_cond *wake;
+	Uint8 *ahead;
+	int ahead_len;
+	enum { AHEAD_EMPTY, AHEAD_PENDING, AHEAD_READY } ahead_state;
+	int quit;
+#endif
+} rwbuffer;
+
+#if SDL_THREADS_DISABLED
+#define RWBUFFER_THREADED(buf)	0
+#else
+#define RWBUFFER_THREADED(buf)	((buf)->thread != NULL)
+
+static int SDLCALL rwbuffer_thread(void *data)
+{
+	rwbuffer *buf = (rwbuffer *)data;
+	int len;
+
+	SDL_mutexP(buf->lock);
+	while ( !buf->quit ) {
+		if ( buf->ahead_state == AHEAD_PENDING ) {
+			SDL_mutexV(buf->lock);
+			len = SDL_RWread(buf->src, buf->ahead, 1, buf->size);
+			SDL_mutexP(buf->lock);
+			buf->ahead_len = (len > 0) ? len : 0;
+			buf->ahead_state = AHEAD_READY;
+			SDL_CondSignal(buf->wake);
+		} else {
+			SDL_CondWait(buf->wake, buf->lock);
+		}
+	}
+	SDL_mutexV(buf->lock);
+	return(0);
+}
+
+/* Wait for any read in progress, and throw away what was read ahead.
+   Returns the number of bytes the source is ahead of the buffer.
+   Called with the lock held, afterwards the source can be used freely.
+ */
+static int rwbuffer_sync(rwbuffer *buf)
+{
+	int ahead = 0;
+
+	while ( buf->ahead_state == AHEAD_PENDING ) {
+		SDL_CondWait(buf->wake, buf->lock);
+	}
+	if ( buf->ahead_state == AHEAD_READY ) {
+		ahead = buf->ahead_len;
+		buf->ahead_state = AHEAD_EMPTY;
+	}
+	return(ahead);
+}
+#endif /* !SDL_THREADS_DISABLED */
+
+/* Move to the next block of the source, returns the number of bytes in it */
+static int rwbuffer_fill(rwbuffer *buf)
+{
+	int len;
+
+	buf->offset += buf->stop;
+	buf->here = 0;
+#if !SDL_THREADS_DISABLED
+	if ( buf->thread ) {
+		Uint8 *data;
+
+		SDL_mutexP(buf->lock);
+		while ( buf->ahead_state == AHEAD_PENDING ) {
+			SDL_CondWait(buf->wake, buf->lock);
+		}
+		if ( buf->ahead_state == AHEAD_READY ) {
+			data = buf->data;
+			buf->data = buf->ahead;
+			buf->ahead = data;
+			buf->stop = buf->ahead_len;
+		} else {
+			len = SDL_RWread(buf->src, buf->data, 1, buf->size);
+			buf->stop = (len > 0) ? len : 0;
+		}
+		/* Start reading the block after this one */
+		if ( buf->stop > 0 ) {
+			buf->ahead_state = AHEAD_PENDING;
+			SDL_CondSignal(buf->wake);
+		} else {
+			buf->ahead_state = AHEAD_EMPTY;
+		}
+		SDL_mutexV(buf->lock);
+		return(buf->stop);
+	}
+#endif
+	len = SDL_RWread(buf->src, buf->data, 1, buf->size);
+	buf->stop = (len > 0) ? len : 0;
+	return(buf->stop);
+}
+
+/* Drop the buffered data and put the source at 'offset' */
+static int rwbuffer_reset(rwbuffer *buf, int offset, int whence)
+{
+	int pos;
+
+#if !SDL_THREADS_DISABLED
+	if ( buf->thread ) {
+		SDL_mutexP(buf->lock);
+		rwbuffer_sync(buf);
+		pos = SDL_RWseek(buf->src, offset, whence);
+		SDL_mutexV(buf->lock);
+	} else
+#endif
+	pos = SDL_RWseek(buf->src, offset, whence);
+	if ( pos >= 0 ) {
+		buf->offset = pos;
+		buf->here = buf->stop = 0;
+	}
+	return(pos);
+}
+
+static int SDLCALL rwbuffer_seek(SDL_RWops *context, int offset, int whence)
+{
+	rwbuffer *buf = (rwbuffer *)context->hidden.unknown.data1;
+	int pos;
+
+	switch (whence) {
+		case RW_SEEK_SET:
+			pos = offset;
+			break;
+		case RW_SEEK_CUR:
+			pos = buf->offset+buf->here+offset;
+			break;
+		case RW_SEEK_END:
+			return rwbuffer_reset(buf, offset, RW_SEEK_END);
+		default:
+			SDL_SetError("Unknown value for 'whence'");
+			return(-1);
+	}
+	/* Seeking within the buffer doesn't need the source at all */
+	if ( (pos >= buf->offset) && (pos <= buf->offset+buf->stop) ) {
+		buf->here = pos-buf->offset;
+		return(pos);
+	}
+	return rwbuffer_reset(buf, pos, RW_SEEK_SET);
+}
+static int SDLCALL rwbuffer_read(SDL_RWops *context, void *ptr, int size, int maxnum)
+{
+	rwbuffer *buf = (rwbuffer *)context->hidden.unknown.data1;
+	Uint8 *dst = (Uint8 *)ptr;
+	int total_bytes, left, len;
+
+	total_bytes = (maxnum * size);
+	if ( (maxnum <= 0) || (size <= 0) || ((total_bytes / maxnum) != size) ) {
+		return 0;
+	}
+
+	left = total_bytes;
+	while ( left > 0 ) {
+		len = buf->stop-buf->here;
+		if ( (len == 0) && (left >= buf->size) && !RWBUFFER_THREADED(buf) ) {
+			/* Large reads go straight from the source */
+			buf->offset += buf->stop;
+			buf->here = buf->stop = 0;
+			len = SDL_RWread(buf->src, dst, 1, left);
+			if ( len <= 0 ) {
+				break;
+			}
+			buf->offset += len;
+			dst += len;
+			left -= len;
+			continue;
+		}
+		if ( len == 0 ) {
+			if ( rwbuffer_fill(buf) == 0 ) {
+				break;
+			}
+			len = buf->stop;
+		}
+		if ( len > left ) {
+			len = left;
+		}
+		SDL_memcpy(dst, buf->data+buf->here, len);
+		buf->here += len;
+		dst += len;
+		left -= len;
+	}
+	total_bytes -= left;
+
+	/* Leave a partial object unread, like the other sources do */
+	left = total_bytes % size;
+	if ( left ) {
+		rwbuffer_seek(context, -left, RW_SEEK_CUR);
+	}
+	return (total_bytes / size);
+}
+static int SDLCALL rwbuffer_write(SDL_RWops *context, const void *ptr, int size, int num)
+{
+	rwbuffer *buf = (rwbuffer *)context->hidden.unknown.data1;
+
+	/* Put the source where the reader is, then write through */
+	if ( rwbuffer_reset(buf, buf->offset+buf->here, RW_SEEK_SET) < 0 ) {
+		return(-1);
+	}
+	num = SDL_RWwrite(buf->src, ptr, size, num);
+	if ( num > 0 ) {
+		buf->offset += num*size;
+	}
+	return(num);
+}
+static int SDLCALL rwbuffer_close(SDL_RWops *context)
+{
+	rwbuffer *buf;
+
+	if ( context ) {
+		buf = (rwbuffer *)context->hidden.unknown.data1;
+#if !SDL_THREADS_DISABLED
+		if ( buf->thread ) {
+			SDL_mutexP(buf->lock);
+			buf->quit = 1;
+			SDL_CondSignal(buf->wake);
+			SDL_mutexV(buf->lock);
+			SDL_WaitThread(buf->thread, NULL);
+		}
+		if ( buf->wake ) {
+			SDL_DestroyCond(buf->wake);
+		}
+		if ( buf->lock ) {
+			SDL_DestroyMutex(buf->lock);
+		}
+		if ( buf->ahead ) {
+			SDL_free(buf->ahead);
+		}
+#endif
+		if ( buf->freesrc ) {
+			SDL_RWclose(buf->src);
+		} else {
+			/* Leave the source where the reader stopped */
+			SDL_RWseek(buf->src, buf->offset+buf->here, RW_SEEK_SET);
+		}
+		SDL_free(buf->data);
+		SDL_free(buf);
+		SDL_FreeRW(context);
+	}
+	return(0);
+}
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -546,6 +830,54 @@ SDL_RWops *SDL_RWFromFP(FILE *fp, int autoclose)
 }
 #endif /* HAVE_STDIO_H */
 
+SDL_RWops *SDL_RWFromMappedFile(const char *file)
+{
+#ifdef SDL_RWOPS_MMAP
+	SDL_RWops *rwops;
+	struct stat st;
+	void *base;
+	int fd;
+
+	if ( !file || !*file ) {
+		SDL_SetError("SDL_RWFromMappedFile(): No file specified");
+		return NULL;
+	}
+	fd = open(file, O_RDONLY);
+	if ( fd < 0 ) {
+		SDL_SetError("Couldn't open %s", file);
+		return NULL;
+	}
+	/* Empty files can't be mapped, and larger than 2GB can't be seeked */
+	if ( (fstat(fd, &st) < 0) || !S_ISREG(st.st_mode) ||
+	     (st.st_size <= 0) || (st.st_size > 0x7FFFFFFF) ) {
+		close(fd);
+		return SDL_RWFromFile(file, "rb");
+	}
+	base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( base == MAP_FAILED ) {
+		return SDL_RWFromFile(file, "rb");
+	}
+
+	rwops = SDL_AllocRW();
+	if ( rwops == NULL ) {
+		munmap(base, (size_t)st.st_size);
+		return NULL;
+	}
+	rwops->seek = mem_seek;
+	rwops->read = mem_read;
+	rwops->write = mem_writeconst;
+	rwops->close = mmap_close;
+	rwops->hidden.mem.base = (Uint8 *)base;
+	rwops->hidden.mem.here = rwops->hidden.mem.base;
+	rwops->hidden.mem.stop = rwops->hidden.mem.base+(int)st.st_size;
+	return(rwops);
+#else
+	/* No memory mapping on this platform, use the regular file access */
+	return SDL_RWFromFile(file, "rb");
+#endif /* SDL_RWOPS_MMAP */
+}
+
 SDL_RWops *SDL_RWFromMem(void *mem, int size)
 {
 	SDL_RWops *rwops;
@@ -580,6 +912,83 @@ SDL_RWops *SDL_RWFromConstMem(const void *mem, int size)
 	return(rwops);
 }
 
+SDL_RWops *SDL_RWFromBuffered(SDL_RWops *src, int freesrc, int bufsize, int readahead)
+{
+	SDL_RWops *rwops;
+	rwbuffer *buf;
+
+	if ( !src ) {
+		SDL_SetError("SDL_RWFromBuffered(): No source specified");
+		return NULL;
+	}
+	if ( bufsize <= 0 ) {
+		bufsize = RWBUFFER_DEFAULT_SIZE;
+	}
+
+	buf = (rwbuffer *)SDL_malloc(sizeof(*buf));
+	if ( buf == NULL ) {
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	SDL_memset(buf, 0, sizeof(*buf));
+	buf->src = src;
+	buf->size = bufsize;
+	buf->offset = SDL_RWtell(src);
+	if ( buf->offset < 0 ) {
+		buf->offset = 0;
+	}
+	buf->data = (Uint8 *)SDL_malloc(bufsize);
+	rwops = SDL_AllocRW();
+	if ( !buf->data || !rwops ) {
+		if ( buf->data ) {
+			SDL_free(buf->data);
+		}
+		if ( rwops ) {
+			SDL_FreeRW(rwops);
+		}
+		SDL_free(buf);
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	rwops->seek = rwbuffer_seek;
+	rwops->read = rwbuffer_read;
+	rwops->write = rwbuffer_write;
+	rwops->close = rwbuffer_close;
+	rwops->hidden.unknown.data1 = buf;
+
+#if !SDL_THREADS_DISABLED
+	if ( readahead ) {
+		buf->ahead = (Uint8 *)SDL_malloc(bufsize);
+		buf->lock = SDL_CreateMutex();
+		buf->wake = SDL_CreateCond();
+		if ( buf->ahead && buf->lock && buf->wake ) {
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
+#undef SDL_CreateThread
+			buf->thread = SDL_CreateThread(rwbuffer_thread, buf, NULL, NULL);
+#else
+			buf->thread = SDL_CreateThread(rwbuffer_thread, buf);
+#endif
+		}
+		/* Without the thread this is still a working buffered reader */
+	}
+#endif
+	/* The wrapper owns the source only once it's successfully created */
+	buf->freesrc = freesrc;
+	return(rwops);
+}
+
+const void *SDL_RWGetMemory(SDL_RWops *context, int *size)
+{
+	/* Memory, const memory and mapped file sources share the reader */
+	if ( !context || (context->read != mem_read) ) {
+		return NULL;
+	}
+	if ( size ) {
+		*size = (context->hidden.mem.stop-context->hidden.mem.base);
+	}
+	return(context->hidden.mem.base);
+}
+
 SDL_RWops *SDL_AllocRW(void)
 {
 	SDL_RWops *area;
@@ -641,6 +1050,63 @@ Uint64 SDL_ReadBE64 (SDL_RWops *src)
 	return(SDL_SwapBE64(value));
 }
 
+int SDL_ReadLE16Array (SDL_RWops *src, Uint16 *values, int num)
+{
+	int i;
+
+	num = SDL_RWread(src, values, (sizeof *values), num);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	for ( i = 0; i < num; ++i ) {
+		values[i] = SDL_Swap16(values[i]);
+	}
+#else
+	(void) i;
+#endif
+	return(num);
+}
+int SDL_ReadBE16Array (SDL_RWops *src, Uint16 *values, int num)
+{
+	int i;
+
+	num = SDL_RWread(src, values, (sizeof *values), num);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	for ( i = 0; i < num; ++i ) {
+		values[i] = SDL_Swap16(values[i]);
+	}
+#else
+	(void) i;
+#endif
+	return(num);
+}
+int SDL_ReadLE32Array (SDL_RWops *src, Uint32 *values, int num)
+{
+	int i;
+
+	num = SDL_RWread(src, values, (sizeof *values), num);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	for ( i = 0; i < num; ++i ) {
+		values[i] = SDL_Swap32(values[i]);
+	}
+#else
+	(void) i;
+#endif
+	return(num);
+}
+int SDL_ReadBE32Array (SDL_RWops *src, Uint32 *values, int num)
+{
+	int i;
+
+	num = SDL_RWread(src, values, (sizeof *values), num);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	for ( i = 0; i < num; ++i ) {
+		values[i] = SDL_Swap32(values[i]);
+	}
+#else
+	(void) i;
+#endif
+	return(num);
+}
+
 int SDL_WriteLE16 (SDL_RWops *dst, Uint16 value)
 {
 	value = SDL_SwapLE16(value);
@@ -0,0 +1,285 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Atomic operations, using the compiler builtins when available */
+
+#include "SDL_atomic.h"
+#include "SDL_mutex.h"
+#include "SDL_timer.h"
+
+#if defined(__GNUC__) && \
+    ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7)))
+#define HAVE_GCC_ATOMICS	1	/* The __atomic builtins */
+#elif defined(__GNUC__) && \
+    ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 1))
+#define HAVE_GCC_SYNC_ATOMICS	1	/* The older __sync builtins */
+#endif
+
+#if !HAVE_GCC_ATOMICS && !HAVE_GCC_SYNC_ATOMICS
+/* Without atomic builtins, every operation is done with a global mutex.
+   As with SDL_AddThread(), the very first atomic operations must not be
+   done by several threads at the same time.
+ */
+static SDL_mutex *atomic_lock = NULL;
+
+static void enterLock(void)
+{
+	if ( !atomic_lock ) {
+		atomic_lock = SDL_CreateMutex();
+	}
+	SDL_mutexP(atomic_lock);
+}
+
+static void leaveLock(void)
+{
+	SDL_mutexV(atomic_lock);
+}
+#endif
+
+SDL_bool SDL_AtomicTryLock(SDL_SpinLock *lock)
+{
+#if HAVE_GCC_ATOMICS
+	return (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) == 0) ?
+							SDL_TRUE : SDL_FALSE;
+#elif HAVE_GCC_SYNC_ATOMICS
+	return (__sync_lock_test_and_set(lock, 1) == 0) ? SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool retval = SDL_FALSE;
+
+	enterLock();
+	if ( *lock == 0 ) {
+		*lock = 1;
+		retval = SDL_TRUE;
+	}
+	leaveLock();
+	return retval;
+#endif
+}
+
+void SDL_AtomicLock(SDL_SpinLock *lock)
+{
+	int spins = 0;
+
+	/* Spin for a while, then give up the CPU between tries */
+	while ( !SDL_AtomicTryLock(lock) ) {
+		if ( spins < 64 ) {
+			++spins;
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+			__asm__ __volatile__ ("pause");
+#endif
+		} else {
+			SDL_Delay(0);
+		}
+	}
+}
+
+void SDL_AtomicUnlock(SDL_SpinLock *lock)
+{
+#if HAVE_GCC_ATOMICS
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	__sync_lock_release(lock);
+#else
+	enterLock();
+	*lock = 0;
+	leaveLock();
+#endif
+}
+
+void SDL_MemoryBarrierRelease(void)
+{
+#if HAVE_GCC_ATOMICS
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	__sync_synchronize();
+#else
+	/* Taking and releasing the mutex orders memory accesses */
+	enterLock();
+	leaveLock();
+#endif
+}
+
+void SDL_MemoryBarrierAcquire(void)
+{
+#if HAVE_GCC_ATOMICS
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	__sync_synchronize();
+#else
+	enterLock();
+	leaveLock();
+#endif
+}
+
+SDL_bool SDL_AtomicCAS(SDL_atomic_t *a, int oldval, int newval)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_compare_exchange_n(&a->value, &oldval, newval, 0,
+				__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ?
+							SDL_TRUE : SDL_FALSE;
+#elif HAVE_GCC_SYNC_ATOMICS
+	return __sync_bool_compare_and_swap(&a->value, oldval, newval) ?
+							SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool retval = SDL_FALSE;
+
+	enterLock();
+	if ( a->value == oldval ) {
+		a->value = newval;
+		retval = SDL_TRUE;
+	}
+	leaveLock();
+	return retval;
+#endif
+}
+
+int SDL_AtomicSet(SDL_atomic_t *a, int value)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_exchange_n(&a->value, value, __ATOMIC_SEQ_CST);
+#elif HAVE_GCC_SYNC_ATOMICS
+	int oldval;
+
+	do {
+		oldval = a->value;
+	} while ( !__sync_bool_compare_and_swap(&a->value, oldval, value) );
+	return oldval;
+#else
+	int oldval;
+
+	enterLock();
+	oldval = a->value;
+	a->value = value;
+	leaveLock();
+	return oldval;
+#endif
+}
+
+int SDL_AtomicGet(SDL_atomic_t *a)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	return __sync_fetch_and_add(&a->value, 0);
+#else
+	int value;
+
+	enterLock();
+	value = a->value;
+	leaveLock();
+	return value;
+#endif
+}
+
+void SDL_AtomicStore(SDL_atomic_t *a, int value)
+{
+#if HAVE_GCC_ATOMICS
+	__atomic_store_n(&a->value, value, __ATOMIC_RELEASE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	__sync_synchronize();
+	*(volatile int *)&a->value = value;
+#else
+	enterLock();
+	a->value = value;
+	leaveLock();
+#endif
+}
+
+int SDL_AtomicAdd(SDL_atomic_t *a, int value)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_fetch_add(&a->value, value, __ATOMIC_SEQ_CST);
+#elif HAVE_GCC_SYNC_ATOMICS
+	return __sync_fetch_and_add(&a->value, value);
+#else
+	int oldval;
+
+	enterLock();
+	oldval = a->value;
+	a->value = oldval + value;
+	leaveLock();
+	return oldval;
+#endif
+}
+
+SDL_bool SDL_AtomicCASPtr(void **a, void *oldval, void *newval)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_compare_exchange_n(a, &oldval, newval, 0,
+				__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ?
+							SDL_TRUE : SDL_FALSE;
+#elif HAVE_GCC_SYNC_ATOMICS
+	return __sync_bool_compare_and_swap(a, oldval, newval) ?
+							SDL_TRUE : SDL_FALSE;
+#else
+	SDL_bool retval = SDL_FALSE;
+
+	enterLock();
+	if ( *a == oldval ) {
+		*a = newval;
+		retval = SDL_TRUE;
+	}
+	leaveLock();
+	return retval;
+#endif
+}
+
+void *SDL_AtomicSetPtr(void **a, void *value)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_exchange_n(a, value, __ATOMIC_SEQ_CST);
+#elif HAVE_GCC_SYNC_ATOMICS
+	void *oldval;
+
+	do {
+		oldval = *a;
+	} while ( !__sync_bool_compare_and_swap(a, oldval, value) );
+	return oldval;
+#else
+	void *oldval;
+
+	enterLock();
+	oldval = *a;
+	*a = value;
+	leaveLock();
+	return oldval;
+#endif
+}
+
+void *SDL_AtomicGetPtr(void **a)
+{
+#if HAVE_GCC_ATOMICS
+	return __atomic_load_n(a, __ATOMIC_ACQUIRE);
+#elif HAVE_GCC_SYNC_ATOMICS
+	void *value = *(void * volatile *)a;
+	__sync_synchronize();
+	return value;
+#else
+	void *value;
+
+	enterLock();
+	value = *a;
+	leaveLock();
+	return value;
+#endif
+}
@@ -0,0 +1,583 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A work stealing pool of worker threads */
+
+#include "SDL_jobs.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+
+#define JOBS_MAX_THREADS	64
+#define JOBS_DEQUE_SIZE		64	/* Initial size, a power of two */
+
+struct SDL_Job {
+	SDL_JobFunc func;
+	void *data;
+	SDL_JobPool *pool;
+	SDL_atomic_t refcount;	/* The handle, and the pool until done */
+	SDL_atomic_t pending;	/* Dependencies left, plus one until queued */
+	SDL_atomic_t done;
+
+	/* The jobs waiting for this one, protected by the spinlock */
+	SDL_SpinLock lock;
+	SDL_Job **dependents;
+	int numdependents;
+	int maxdependents;
+};
+
+/* A queue the owning worker pushes to and pops from at the tail, while
+   the other threads steal from the head */
+typedef struct {
+	SDL_SpinLock lock;
+	SDL_Job **jobs;
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	unsigned int mask;
+} SDL_JobDeque;
+
+struct SDL_JobPool {
+	int numthreads;
+	SDL_Thread **threads;
+
+	/* One deque per worker, and one for jobs queued by other threads */
+	SDL_JobDeque *deques;
+	int numdeques;
+	SDL_TLSID worker;	/* The deque index + 1 of a worker thread */
+
+	SDL_sem *work;		/* Posted once for every queued job */
+	SDL_atomic_t unfinished;	/* Jobs created but not done */
+	SDL_atomic_t queued;	/* Incremented whenever a job is queued */
+	volatile int quit;
+
+	/* Threads waiting for a job are woken up when jobs are done or
+	   queued, so they can help out */
+	SDL_mutex *lock;
+	SDL_cond *changed;
+	SDL_atomic_t waiters;
+};
+
+/* The default pool, created when it's first used */
+static SDL_JobPool *default_pool = NULL;
+static SDL_SpinLock default_pool_lock = 0;
+
+static int PushJob(SDL_JobDeque *deque, SDL_Job *job)
+{
+	SDL_AtomicLock(&deque->lock);
+	if ( (deque->tail - deque->head) > deque->mask ) {
+		unsigned int i, mask;
+		SDL_Job **jobs;
+
+		mask = (deque->mask << 1) | 1;
+		jobs = (SDL_Job **)SDL_malloc((mask+1)*(sizeof *jobs));
+		if ( jobs == NULL ) {
+			SDL_AtomicUnlock(&deque->lock);
+			return(-1);
+		}
+		for ( i = deque->head; i != deque->tail; ++i ) {
+			jobs[i & mask] = deque->jobs[i & deque->mask];
+		}
+		SDL_free(deque->jobs);
+		deque->jobs = jobs;
+		deque->mask = mask;
+	}
+	deque->jobs[deque->tail & deque->mask] = job;
+	++deque->tail;
+	SDL_AtomicUnlock(&deque->lock);
+	return(0);
+}
+
+static SDL_Job *PopJob(SDL_JobDeque *deque, int steal)
+{
+	SDL_Job *job = NULL;
+
+	if ( deque->head == deque->tail ) {
+		return(NULL);
+	}
+	SDL_AtomicLock(&deque->lock);
+	if ( deque->head != deque->tail ) {
+		if ( steal ) {
+			job = deque->jobs[deque->head & deque->mask];
+			++deque->head;
+		} else {
+			--deque->tail;
+			job = deque->jobs[deque->tail & deque->mask];
+		}
+	}
+	SDL_AtomicUnlock(&deque->lock);
+	return(job);
+}
+
+/* Returns the index of the calling worker thread, or -1 */
+static int GetWorker(SDL_JobPool *pool)
+{
+	return (int)(size_t)SDL_TLSGet(pool->worker) - 1;
+}
+
+/* Take a job from our own deque, or steal one from another */
+static SDL_Job *TakeJob(SDL_JobPool *pool, int self)
+{
+	SDL_Job *job = NULL;
+	int i, n;
+
+	if ( self >= 0 ) {
+		job = PopJob(&pool->deques[self], 0);
+	}
+	n = pool->numthreads + 1;
+	for ( i = 1; !job && i <= n; ++i ) {
+		job = PopJob(&pool->deques[(self + i + n) % n], 1);
+	}
+	return(job);
+}
+
+static void WakeWaiters(SDL_JobPool *pool)
+{
+	if ( SDL_AtomicGet(&pool->waiters) > 0 ) {
+		SDL_mutexP(pool->lock);
+		SDL_CondBroadcast(pool->changed);
+		SDL_mutexV(pool->lock);
+	}
+}
+
+static void RunJob(SDL_Job *job);
+
+static void QueueJob(SDL_Job *job)
+{
+	SDL_JobPool *pool = job->pool;
+	int self;
+
+	self = GetWorker(pool);
+	if ( self < 0 ) {
+		self = pool->numthreads;
+	}
+	/* Without workers, or memory for the queue, run it right away */
+	if ( (pool->numthreads == 0) ||
+	     (PushJob(&pool->deques[self], job) < 0) ) {
+		RunJob(job);
+		return;
+	}
+	SDL_AtomicIncRef(&pool->queued);
+	SDL_SemPost(pool->work);
+	WakeWaiters(pool);
+}
+
+void SDL_ReleaseJob(SDL_Job *job)
+{
+	if ( job && SDL_AtomicDecRef(&job->refcount) ) {
+		SDL_free(job->dependents);
+		SDL_free(job);
+	}
+}
+
+static void RunJob(SDL_Job *job)
+{
+	SDL_JobPool *pool = job->pool;
+	SDL_Job **dependents;
+	int i, numdependents;
+
+	job->func(job->data);
+
+	/* Nothing can be added to the dependents once the job is done */
+	SDL_AtomicLock(&job->lock);
+	SDL_AtomicStore(&job->done, 1);
+	dependents = job->dependents;
+	numdependents = job->numdependents;
+	job->dependents = NULL;
+	job->numdependents = 0;
+	SDL_AtomicUnlock(&job->lock);
+
+	for ( i = 0; i < numdependents; ++i ) {
+		if ( SDL_AtomicDecRef(&dependents[i]->pending) ) {
+			QueueJob(dependents[i]);
+		}
+	}
+	SDL_free(dependents);
+
+	SDL_AtomicAdd(&pool->unfinished, -1);
+	WakeWaiters(pool);
+	SDL_ReleaseJob(job);
+}
+
+/* Wait until 'done' returns true, running jobs of the pool meanwhile */
+static void HelpUntil(SDL_JobPool *pool, int (*done)(void *), void *data)
+{
+	SDL_Job *job;
+	int self, queued;
+
+	self = GetWorker(pool);
+	SDL_AtomicIncRef(&pool->waiters);
+	while ( !done(data) ) {
+		queued = SDL_AtomicGet(&pool->queued);
+		job = TakeJob(pool, self);
+		if ( job ) {
+			RunJob(job);
+			continue;
+		}
+		/* Sleep until a job is done, or one is queued we can run */
+		SDL_mutexP(pool->lock);
+		if ( !done(data) && (queued == SDL_AtomicGet(&pool->queued)) ) {
+			SDL_CondWait(pool->changed, pool->lock);
+		}
+		SDL_mutexV(pool->lock);
+	}
+	SDL_AtomicAdd(&pool->waiters, -1);
+}
+
+typedef struct {
+	SDL_JobPool *pool;
+	int index;
+} worker_args;
+
+static int SDLCALL JobWorker(void *data)
+{
+	worker_args *args = (worker_args *)data;
+	SDL_JobPool *pool = args->pool;
+	SDL_Job *job;
+	int self;
+
+	self = args->index;
+	SDL_free(args);
+	SDL_TLSSet(pool->worker, (void *)(size_t)(self + 1), NULL);
+	SDL_SetThreadName("SDLJobWorker");
+
+	for ( ; ; ) {
+		SDL_SemWait(pool->work);
+		if ( pool->quit ) {
+			break;
+		}
+		/* Another thread may have taken the job already */
+		job = TakeJob(pool, self);
+		if ( job ) {
+			RunJob(job);
+		}
+	}
+	return(0);
+}
+
+static void FreeJobPool(SDL_JobPool *pool)
+{
+	int i;
+
+	if ( pool->deques ) {
+		for ( i = 0; i < pool->numdeques; ++i ) {
+			SDL_free(pool->deques[i].jobs);
+		}
+	}
+	if ( pool->changed ) {
+		SDL_DestroyCond(pool->changed);
+	}
+	if ( pool->lock ) {
+		SDL_DestroyMutex(pool->lock);
+	}
+	if ( pool->work ) {
+		SDL_DestroySemaphore(pool->work);
+	}
+	SDL_free(pool->deques);
+	SDL_free(pool->threads);
+	SDL_free(pool);
+}
+
+SDL_JobPool *SDL_CreateJobPool(int numthreads)
+{
+	SDL_JobPool *pool;
+	worker_args *args;
+	int i;
+
+	if ( numthreads <= 0 ) {
+		numthreads = SDL_GetCPUCount();
+	}
+	if ( numthreads > JOBS_MAX_THREADS ) {
+		numthreads = JOBS_MAX_THREADS;
+	}
+
+	pool = (SDL_JobPool *)SDL_malloc(sizeof(*pool));
+	if ( pool == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(pool, 0, (sizeof *pool));
+	pool->threads = (SDL_Thread **)SDL_malloc(
+				numthreads*(sizeof *pool->threads));
+	pool->deques = (SDL_JobDeque *)SDL_malloc(
+				(numthreads+1)*(sizeof *pool->deques));
+	if ( !pool->threads || !pool->deques ) {
+		SDL_OutOfMemory();
+		goto error;
+	}
+	SDL_memset(pool->deques, 0, (numthreads+1)*(sizeof *pool->deques));
+	pool->numdeques = numthreads+1;
+	for ( i = 0; i < pool->numdeques; ++i ) {
+		pool->deques[i].mask = JOBS_DEQUE_SIZE-1;
+		pool->deques[i].jobs = (SDL_Job **)SDL_malloc(
+				JOBS_DEQUE_SIZE*(sizeof *pool->deques[i].jobs));
+		if ( !pool->deques[i].jobs ) {
+			SDL_OutOfMemory();
+			goto error;
+		}
+	}
+	pool->worker = SDL_TLSCreate();
+	pool->work = SDL_CreateSemaphore(0);
+	pool->lock = SDL_CreateMutex();
+	pool->changed = SDL_CreateCond();
+	if ( !pool->worker || !pool->work || !pool->lock || !pool->changed ) {
+		goto error;
+	}
+
+	/* Jobs are run by the calling thread if no workers can be started */
+	for ( i = 0; i < numthreads; ++i ) {
+		args = (worker_args *)SDL_malloc(sizeof(*args));
+		if ( args == NULL ) {
+			break;
+		}
+		args->pool = pool;
+		args->index = i;
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC) && !defined(__SYMBIAN32__)
+#undef SDL_CreateThread
+		pool->threads[i] = SDL_CreateThread(JobWorker, args, NULL, NULL);
+#else
+		pool->threads[i] = SDL_CreateThread(JobWorker, args);
+#endif
+		if ( pool->threads[i] == NULL ) {
+			SDL_free(args);
+			break;
+		}
+	}
+	pool->numthreads = i;
+	return(pool);
+
+error:
+	FreeJobPool(pool);
+	return(NULL);
+}
+
+static int PoolIsIdle(void *data)
+{
+	SDL_JobPool *pool = (SDL_JobPool *)data;
+	return (SDL_AtomicGet(&pool->unfinished) == 0);
+}
+
+/* Wait for the remaining jobs, and stop the worker threads */
+static void StopJobPool(SDL_JobPool *pool)
+{
+	int i;
+
+	HelpUntil(pool, PoolIsIdle, pool);
+	pool->quit = 1;
+	for ( i = 0; i < pool->numthreads; ++i ) {
+		SDL_SemPost(pool->work);
+	}
+	for ( i = 0; i < pool->numthreads; ++i ) {
+		SDL_WaitThread(pool->threads[i], NULL);
+	}
+}
+
+void SDL_DestroyJobPool(SDL_JobPool *pool)
+{
+	if ( pool && (pool != default_pool) ) {
+		StopJobPool(pool);
+		FreeJobPool(pool);
+	}
+}
+
+/* This is called from SDL_Quit() */
+void SDL_JobsQuit(void)
+{
+	if ( default_pool ) {
+		StopJobPool(default_pool);
+		FreeJobPool(default_pool);
+		default_pool = NULL;
+	}
+}
+
+static SDL_JobPool *GetJobPool(SDL_JobPool *pool)
+{
+	if ( pool == NULL ) {
+		SDL_AtomicLock(&default_pool_lock);
+		if ( default_pool == NULL ) {
+			default_pool = SDL_CreateJobPool(0);
+		}
+		pool = default_pool;
+		SDL_AtomicUnlock(&default_pool_lock);
+	}
+	return(pool);
+}
+
+SDL_Job *SDL_CreateJob(SDL_JobPool *pool, SDL_JobFunc func, void *data, SDL_Job **dependencies, int numdependencies)
+{
+	SDL_Job *job, *dependency;
+	int i;
+
+	if ( func == NULL ) {
+		SDL_SetError("Passed a NULL function");
+		return(NULL);
+	}
+	pool = GetJobPool(pool);
+	if ( pool == NULL ) {
+		return(NULL);
+	}
+	job = (SDL_Job *)SDL_malloc(sizeof(*job));
+	if ( job == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(job, 0, (sizeof *job));
+	job->func = func;
+	job->data = data;
+	job->pool = pool;
+	SDL_AtomicStore(&job->refcount, 2);
+	SDL_AtomicStore(&job->pending, 1);
+	SDL_AtomicIncRef(&pool->unfinished);
+
+	/* Register with the dependencies that haven't completed yet */
+	for ( i = 0; i < numdependencies; ++i ) {
+		dependency = dependencies[i];
+		if ( dependency == NULL ) {
+			continue;
+		}
+		SDL_AtomicLock(&dependency->lock);
+		if ( !SDL_AtomicGet(&dependency->done) ) {
+			if ( dependency->numdependents == dependency->maxdependents ) {
+				int max = dependency->maxdependents + 4;
+				SDL_Job **dependents;
+
+				dependents = (SDL_Job **)SDL_realloc(
+					dependency->dependents,
+					max*(sizeof *dependents));
+				if ( dependents == NULL ) {
+					/* Run the job once it can, but not this
+					   dependency, rather than failing it */
+					SDL_AtomicUnlock(&dependency->lock);
+					SDL_WaitJob(dependency);
+					continue;
+				}
+				dependency->dependents = dependents;
+				dependency->maxdependents = max;
+			}
+			dependency->dependents[dependency->numdependents++] = job;
+			SDL_AtomicIncRef(&job->pending);
+		}
+		SDL_AtomicUnlock(&dependency->lock);
+	}
+
+	if ( SDL_AtomicDecRef(&job->pending) ) {
+		QueueJob(job);
+	}
+	return(job);
+}
+
+int SDL_IsJobDone(SDL_Job *job)
+{
+	return SDL_AtomicGet(&job->done);
+}
+
+static int JobIsDone(void *data)
+{
+	return SDL_IsJobDone((SDL_Job *)data);
+}
+
+void SDL_WaitJob(SDL_Job *job)
+{
+	if ( !SDL_IsJobDone(job) ) {
+		HelpUntil(job->pool, JobIsDone, job);
+	}
+}
+
+typedef struct {
+	SDL_ParallelForFunc func;
+	void *data;
+	SDL_atomic_t next;
+	int start;
+	int count;
+	int grain;
+} parallel_for;
+
+static void SDLCALL ParallelForJob(void *data)
+{
+	parallel_for *range = (parallel_for *)data;
+	int first, last;
+
+	for ( ; ; ) {
+		first = SDL_AtomicAdd(&range->next, range->grain);
+		if ( first >= range->count ) {
+			break;
+		}
+		last = first + range->grain;
+		if ( last > range->count ) {
+			last = range->count;
+		}
+		range->func(range->data, range->start+first, range->start+last);
+	}
+}
+
+int SDL_ParallelFor(SDL_JobPool *pool, int start, int end, int grain, SDL_ParallelForFunc func, void *data)
+{
+	SDL_Job *helpers[JOBS_MAX_THREADS];
+	parallel_for range;
+	int i, numhelpers;
+
+	if ( func == NULL ) {
+		SDL_SetError("Passed a NULL function");
+		return(-1);
+	}
+	if ( end <= start ) {
+		return(0);
+	}
+	pool = GetJobPool(pool);
+	if ( pool == NULL ) {
+		return(-1);
+	}
+
+	range.func = func;
+	range.data = data;
+	SDL_AtomicStore(&range.next, 0);
+	range.start = start;
+	range.count = end - start;
+	if ( grain <= 0 ) {
+		/* A few parts per thread, to even out the load */
+		grain = range.count / ((pool->numthreads + 1) * 4);
+		if ( grain < 1 ) {
+			grain = 1;
+		}
+	}
+	range.grain = grain;
+
+	/* Workers help with the range, the calling thread takes part too */
+	numhelpers = (range.count - 1) / grain;
+	if ( numhelpers > pool->numthreads ) {
+		numhelpers = pool->numthreads;
+	}
+	for ( i = 0; i < numhelpers; ++i ) {
+		helpers[i] = SDL_CreateJob(pool, ParallelForJob, &range, NULL, 0);
+		if ( helpers[i] == NULL ) {
+			break;
+		}
+	}
+	numhelpers = i;
+	ParallelForJob(&range);
+	for ( i = 0; i < numhelpers; ++i ) {
+		SDL_WaitJob(helpers[i]);
+		SDL_ReleaseJob(helpers[i]);
+	}
+	return(0);
+}
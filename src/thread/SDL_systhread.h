@@ -49,4 +49,24 @@ extern void SDL_SYS_WaitThread(SDL_Thread *thread);
 /* This function kills the thread and returns */
 extern void SDL_SYS_KillThread(SDL_Thread *thread);
 
+#ifdef SDL_SYS_HAS_THREAD_CONTROL
+/* These functions change the priority, name and CPU affinity of the
+   current thread.  They return 0, or set the error and return -1.
+   An affinity mask of 0 allows all CPUs.
+ */
+extern int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority);
+extern int SDL_SYS_SetThreadName(const char *name);
+extern int SDL_SYS_SetThreadAffinity(Uint32 cpumask);
+#endif
+
+#ifdef SDL_SYS_HAS_TLS
+/* These functions get and set the thread local storage of the current
+   thread, which is passed to SDL_TLSCleanup() when the thread exits.
+   They must not call SDL_SetError(), since they're used to find the
+   error buffer itself.
+ */
+extern SDL_TLSData *SDL_SYS_GetTLSData(void);
+extern int SDL_SYS_SetTLSData(SDL_TLSData *data);
+#endif
+
 #endif /* _SDL_systhread_h */
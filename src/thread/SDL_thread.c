@@ -141,6 +141,185 @@ static void SDL_DelThread(SDL_Thread *thread)
 #endif
 }
 
+#ifndef SDL_SYS_HAS_TLS
+/* Without thread local storage in the thread implementation, the data
+   for each thread is kept in a list indexed by thread ID.
+ */
+typedef struct SDL_TLSEntry {
+	Uint32 thread;
+	SDL_TLSData *data;
+	struct SDL_TLSEntry *next;
+} SDL_TLSEntry;
+
+static SDL_mutex *tls_lock = NULL;
+static SDL_TLSEntry *SDL_TLSEntries = NULL;
+
+static SDL_TLSData *SDL_SYS_GetTLSData(void)
+{
+	Uint32 this_thread;
+	SDL_TLSEntry *entry;
+	SDL_TLSData *data;
+
+	if ( !tls_lock ) {
+		return(NULL);
+	}
+	this_thread = SDL_ThreadID();
+	data = NULL;
+	SDL_mutexP(tls_lock);
+	for ( entry = SDL_TLSEntries; entry; entry = entry->next ) {
+		if ( entry->thread == this_thread ) {
+			data = entry->data;
+			break;
+		}
+	}
+	SDL_mutexV(tls_lock);
+	return(data);
+}
+
+static int SDL_SYS_SetTLSData(SDL_TLSData *data)
+{
+	Uint32 this_thread;
+	SDL_TLSEntry *entry, *prev;
+
+	/* See the warning in SDL_AddThread() about this initialization */
+	if ( !tls_lock ) {
+		tls_lock = SDL_CreateMutex();
+		if ( !tls_lock ) {
+			return(-1);
+		}
+	}
+	this_thread = SDL_ThreadID();
+	SDL_mutexP(tls_lock);
+	prev = NULL;
+	for ( entry = SDL_TLSEntries; entry; entry = entry->next ) {
+		if ( entry->thread == this_thread ) {
+			break;
+		}
+		prev = entry;
+	}
+	if ( data ) {
+		if ( !entry ) {
+			entry = (SDL_TLSEntry *)SDL_malloc(sizeof(*entry));
+			if ( entry ) {
+				entry->thread = this_thread;
+				entry->next = SDL_TLSEntries;
+				SDL_TLSEntries = entry;
+			}
+		}
+		if ( entry ) {
+			entry->data = data;
+		}
+	} else if ( entry ) {
+		if ( prev ) {
+			prev->next = entry->next;
+		} else {
+			SDL_TLSEntries = entry->next;
+		}
+		SDL_free(entry);
+	}
+	SDL_mutexV(tls_lock);
+	return((data && !entry) ? -1 : 0);
+}
+#endif /* !SDL_SYS_HAS_TLS */
+
+/* Get the thread local storage of the current thread, allocating it
+   if it doesn't exist yet and 'create' is set.  This doesn't set the
+   error message, so it can be used to find the error buffer.
+ */
+static SDL_TLSData *SDL_GetTLSData(int create)
+{
+	SDL_TLSData *data;
+
+	data = SDL_SYS_GetTLSData();
+	if ( !data && create ) {
+		data = (SDL_TLSData *)SDL_malloc(sizeof(*data));
+		if ( !data ) {
+			return(NULL);
+		}
+		SDL_memset(data, 0, (sizeof *data));
+		if ( SDL_SYS_SetTLSData(data) < 0 ) {
+			SDL_free(data);
+			return(NULL);
+		}
+	}
+	return(data);
+}
+
+void SDL_TLSCleanup(void *tls)
+{
+	SDL_TLSData *data = (SDL_TLSData *)tls;
+	unsigned int i;
+
+	for ( i = 0; i < data->limit; ++i ) {
+		if ( data->array[i].destructor ) {
+			data->array[i].destructor(data->array[i].data);
+		}
+	}
+	SDL_free(data->array);
+	SDL_free(data->errbuf);
+	SDL_free(data);
+}
+
+static SDL_TLSID SDL_tls_next = 0;
+
+SDL_TLSID SDL_TLSCreate(void)
+{
+	SDL_TLSID id;
+
+	if ( !thread_lock ) {
+		if ( SDL_ThreadsInit() < 0 ) {
+			return(0);
+		}
+	}
+	SDL_mutexP(thread_lock);
+	id = ++SDL_tls_next;
+	SDL_mutexV(thread_lock);
+	return(id);
+}
+
+void *SDL_TLSGet(SDL_TLSID id)
+{
+	SDL_TLSData *data;
+
+	data = SDL_GetTLSData(0);
+	if ( !data || (id == 0) || (id > data->limit) ) {
+		return(NULL);
+	}
+	return(data->array[id-1].data);
+}
+
+int SDL_TLSSet(SDL_TLSID id, const void *value, void (SDLCALL *destructor)(void*))
+{
+	SDL_TLSData *data;
+
+	if ( id == 0 ) {
+		SDL_SetError("Invalid thread local storage ID");
+		return(-1);
+	}
+	data = SDL_GetTLSData(1);
+	if ( !data ) {
+		SDL_SetError("Couldn't create thread local storage");
+		return(-1);
+	}
+	if ( id > data->limit ) {
+		unsigned int limit = id + ARRAY_CHUNKSIZE;
+		void *array;
+
+		array = SDL_realloc(data->array, limit*(sizeof *data->array));
+		if ( !array ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		data->array = array;
+		SDL_memset(&data->array[data->limit], 0,
+			(limit - data->limit)*(sizeof *data->array));
+		data->limit = limit;
+	}
+	data->array[id-1].data = (void *)value;
+	data->array[id-1].destructor = destructor;
+	return(0);
+}
+
 /* The default (non-thread-safe) global error variable */
 static SDL_error SDL_global_error;
 
@@ -149,6 +328,24 @@ SDL_error *SDL_GetErrBuf(void)
 {
 	SDL_error *errbuf;
 
+#ifdef SDL_SYS_HAS_TLS
+	SDL_TLSData *data;
+
+	/* Each thread finds its own error buffer without any locking */
+	errbuf = &SDL_global_error;
+	data = SDL_GetTLSData(1);
+	if ( data ) {
+		if ( !data->errbuf ) {
+			data->errbuf = (SDL_error *)SDL_malloc(sizeof(*errbuf));
+			if ( data->errbuf ) {
+				SDL_memset(data->errbuf, 0, sizeof(*errbuf));
+			}
+		}
+		if ( data->errbuf ) {
+			errbuf = data->errbuf;
+		}
+	}
+#else
 	errbuf = &SDL_global_error;
 	if ( SDL_Threads ) {
 		int i;
@@ -164,6 +361,7 @@ SDL_error *SDL_GetErrBuf(void)
 		}
 		SDL_mutexV(thread_lock);
 	}
+#endif /* SDL_SYS_HAS_TLS */
 	return(errbuf);
 }
 
@@ -202,6 +400,17 @@ void SDL_RunThread(void *data)
 
 	/* Run the function */
 	*statusloc = userfunc(userdata);
+
+#ifndef SDL_SYS_HAS_TLS
+	/* Clean up the thread local storage of the thread */
+	{
+		SDL_TLSData *tls = SDL_GetTLSData(0);
+		if ( tls ) {
+			SDL_SYS_SetTLSData(NULL);
+			SDL_TLSCleanup(tls);
+		}
+	}
+#endif
 }
 
 #ifdef SDL_PASSED_BEGINTHREAD_ENDTHREAD
@@ -298,3 +507,42 @@ void SDL_KillThread(SDL_Thread *thread)
 	}
 }
 
+
+int SDL_SetThreadPriority(SDL_ThreadPriority priority)
+{
+	if ( (priority < SDL_THREAD_PRIORITY_LOW) ||
+	     (priority > SDL_THREAD_PRIORITY_TIME_CRITICAL) ) {
+		SDL_SetError("Invalid thread priority");
+		return(-1);
+	}
+#ifdef SDL_SYS_HAS_THREAD_CONTROL
+	return SDL_SYS_SetThreadPriority(priority);
+#else
+	SDL_SetError("Thread priorities are not supported on this platform");
+	return(-1);
+#endif
+}
+
+int SDL_SetThreadName(const char *name)
+{
+	if ( name == NULL ) {
+		SDL_SetError("Passed a NULL thread name");
+		return(-1);
+	}
+#ifdef SDL_SYS_HAS_THREAD_CONTROL
+	return SDL_SYS_SetThreadName(name);
+#else
+	SDL_SetError("Thread names are not supported on this platform");
+	return(-1);
+#endif
+}
+
+int SDL_SetThreadAffinity(Uint32 cpumask)
+{
+#ifdef SDL_SYS_HAS_THREAD_CONTROL
+	return SDL_SYS_SetThreadAffinity(cpumask);
+#else
+	SDL_SetError("Thread affinity is not supported on this platform");
+	return(-1);
+#endif
+}
@@ -61,4 +61,18 @@ struct SDL_Thread {
 /* This is the function called to run a thread */
 extern void SDL_RunThread(void *data);
 
+/* This is the per-thread data stored in thread local storage */
+typedef struct SDL_TLSData {
+	SDL_error *errbuf;
+	unsigned int limit;
+	struct {
+		void *data;
+		void (SDLCALL *destructor)(void*);
+	} *array;
+} SDL_TLSData;
+
+/* This is the function called to free the thread local storage of a
+   thread when it exits */
+extern void SDL_TLSCleanup(void *data);
+
 #endif /* _SDL_thread_c_h */
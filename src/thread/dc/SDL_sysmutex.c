@@ -26,6 +26,7 @@
 
 #include "SDL_thread.h"
 #include "SDL_systhread_c.h"
+#include "SDL_timer.h"
 
 #include <arch/spinlock.h>
 
@@ -90,6 +91,47 @@ int SDL_mutexP(SDL_mutex *mutex)
 #endif /* SDL_THREADS_DISABLED */
 }
 
+/* Lock the semaphore, waiting for it at most 'ms' milliseconds */
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+#if SDL_THREADS_DISABLED
+	return 0;
+#else
+	Uint32 this_thread, end;
+
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+	this_thread = SDL_ThreadID();
+	if ( mutex->owner == this_thread ) {
+		++mutex->recursive;
+		return 0;
+	}
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_mutexP(mutex);
+	}
+
+	end = SDL_GetTicks() + ms;
+	while ( !spinlock_trylock(&mutex->mutex) ) {
+		if ( (Sint32)(SDL_GetTicks() - end) >= 0 ) {
+			return SDL_MUTEX_TIMEDOUT;
+		}
+		SDL_Delay(1);
+	}
+	mutex->owner = this_thread;
+	mutex->recursive = 0;
+
+	return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	return SDL_LockMutexTimeout(mutex, 0);
+}
+
 /* Unlock the mutex */
 int SDL_mutexV(SDL_mutex *mutex)
 {
@@ -96,6 +96,41 @@ int SDL_mutexP(SDL_mutex *mutex)
 #endif /* SDL_THREADS_DISABLED */
 }
 
+/* Lock the semaphore, waiting for it at most 'ms' milliseconds */
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+#if SDL_THREADS_DISABLED
+	return 0;
+#else
+	Uint32 this_thread;
+	int retval;
+
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+	retval = 0;
+	this_thread = SDL_ThreadID();
+	if ( mutex->owner == this_thread ) {
+		++mutex->recursive;
+	} else {
+		retval = SDL_SemWaitTimeout(mutex->sem, ms);
+		if ( retval == 0 ) {
+			mutex->owner = this_thread;
+			mutex->recursive = 0;
+		}
+	}
+
+	return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	return SDL_LockMutexTimeout(mutex, 0);
+}
+
 /* Unlock the mutex */
 int SDL_mutexV(SDL_mutex *mutex)
 {
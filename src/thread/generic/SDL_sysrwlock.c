@@ -0,0 +1,167 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* An implementation of reader-writer locks using a mutex and condition
+   variables.  Waiting writers hold off new readers, so that a steady
+   stream of readers can't starve them.
+ */
+
+#include "SDL_thread.h"
+
+struct SDL_rwlock {
+	SDL_mutex *lock;
+	SDL_cond *can_read;
+	SDL_cond *can_write;
+	int readers;		/* Threads holding the lock for reading */
+	int writer;		/* Set while a thread holds it for writing */
+	int waiting_writers;
+};
+
+SDL_rwlock *SDL_CreateRWLock(void)
+{
+	SDL_rwlock *rwlock;
+
+	rwlock = (SDL_rwlock *)SDL_malloc(sizeof(*rwlock));
+	if ( ! rwlock ) {
+		SDL_OutOfMemory();
+		return NULL;
+	}
+	rwlock->readers = 0;
+	rwlock->writer = 0;
+	rwlock->waiting_writers = 0;
+
+	rwlock->lock = SDL_CreateMutex();
+	rwlock->can_read = SDL_CreateCond();
+	rwlock->can_write = SDL_CreateCond();
+	if ( !rwlock->lock || !rwlock->can_read || !rwlock->can_write ) {
+		SDL_DestroyRWLock(rwlock);
+		return NULL;
+	}
+	return rwlock;
+}
+
+void SDL_DestroyRWLock(SDL_rwlock *rwlock)
+{
+	if ( rwlock ) {
+		SDL_DestroyCond(rwlock->can_write);
+		SDL_DestroyCond(rwlock->can_read);
+		SDL_DestroyMutex(rwlock->lock);
+		SDL_free(rwlock);
+	}
+}
+
+static int LockRWLock(SDL_rwlock *rwlock, int write, int wait)
+{
+	int retval;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+
+	retval = 0;
+	SDL_LockMutex(rwlock->lock);
+	if ( write ) {
+		if ( rwlock->writer || rwlock->readers ) {
+			if ( wait ) {
+				++rwlock->waiting_writers;
+				while ( rwlock->writer || rwlock->readers ) {
+					SDL_CondWait(rwlock->can_write, rwlock->lock);
+				}
+				--rwlock->waiting_writers;
+			} else {
+				retval = SDL_MUTEX_TIMEDOUT;
+			}
+		}
+		if ( retval == 0 ) {
+			rwlock->writer = 1;
+		}
+	} else {
+		if ( rwlock->writer || rwlock->waiting_writers ) {
+			if ( wait ) {
+				while ( rwlock->writer || rwlock->waiting_writers ) {
+					SDL_CondWait(rwlock->can_read, rwlock->lock);
+				}
+			} else {
+				retval = SDL_MUTEX_TIMEDOUT;
+			}
+		}
+		if ( retval == 0 ) {
+			++rwlock->readers;
+		}
+	}
+	SDL_UnlockMutex(rwlock->lock);
+
+	return retval;
+}
+
+int SDL_LockRWLockForReading(SDL_rwlock *rwlock)
+{
+	return LockRWLock(rwlock, 0, 1);
+}
+
+int SDL_LockRWLockForWriting(SDL_rwlock *rwlock)
+{
+	return LockRWLock(rwlock, 1, 1);
+}
+
+int SDL_TryLockRWLockForReading(SDL_rwlock *rwlock)
+{
+	return LockRWLock(rwlock, 0, 0);
+}
+
+int SDL_TryLockRWLockForWriting(SDL_rwlock *rwlock)
+{
+	return LockRWLock(rwlock, 1, 0);
+}
+
+int SDL_UnlockRWLock(SDL_rwlock *rwlock)
+{
+	int retval;
+
+	if ( ! rwlock ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+
+	retval = 0;
+	SDL_LockMutex(rwlock->lock);
+	if ( rwlock->writer ) {
+		rwlock->writer = 0;
+	} else if ( rwlock->readers > 0 ) {
+		--rwlock->readers;
+	} else {
+		SDL_SetError("rwlock not locked");
+		retval = -1;
+	}
+	if ( rwlock->waiting_writers ) {
+		if ( rwlock->readers == 0 ) {
+			SDL_CondSignal(rwlock->can_write);
+		}
+	} else {
+		SDL_CondBroadcast(rwlock->can_read);
+	}
+	SDL_UnlockMutex(rwlock->lock);
+
+	return retval;
+}
@@ -91,6 +91,37 @@ DECLSPEC int SDLCALL SDL_mutexP(SDL_mutex *mutex)
   return(0);
 }
 
+/* Lock the mutex, waiting for it at most 'ms' milliseconds */
+DECLSPEC int SDLCALL SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+  APIRET ulrc;
+
+  if ( mutex == NULL )
+  {
+    SDL_SetError("Passed a NULL mutex");
+    return -1;
+  }
+
+  if ( ms == SDL_MUTEX_MAXWAIT )
+    ulrc = DosRequestMutexSem(mutex->hmtxID, SEM_INDEFINITE_WAIT);
+  else
+    ulrc = DosRequestMutexSem(mutex->hmtxID, ms);
+
+  if ( ulrc == ERROR_TIMEOUT )
+    return SDL_MUTEX_TIMEDOUT;
+  if ( ulrc != NO_ERROR )
+  {
+    SDL_SetError("Couldn't wait on mutex");
+    return -1;
+  }
+  return(0);
+}
+
+DECLSPEC int SDLCALL SDL_TryLockMutex(SDL_mutex *mutex)
+{
+  return SDL_LockMutexTimeout(mutex, SEM_IMMEDIATE_RETURN);
+}
+
 /* Unlock the mutex */
 DECLSPEC int SDLCALL SDL_mutexV(SDL_mutex *mutex)
 {
@@ -30,6 +30,7 @@
 #include <pth.h>
 
 #include "SDL_mutex.h"
+#include "SDL_timer.h"
 #include "SDL_sysmutex_c.h"
 
 /* Create a mutex */
@@ -73,6 +74,39 @@ int SDL_mutexP(SDL_mutex *mutex)
 	return(0);
 }
 
+/* Try to lock the mutex without blocking */
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+	if ( !pth_mutex_acquire(&(mutex->mutexpth_p), TRUE, NULL) ) {
+		return SDL_MUTEX_TIMEDOUT;
+	}
+	return(0);
+}
+
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+	Uint32 end;
+	int retval;
+
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_mutexP(mutex);
+	}
+
+	end = SDL_GetTicks() + ms;
+	while ( (retval = SDL_TryLockMutex(mutex)) == SDL_MUTEX_TIMEDOUT ) {
+		if ( (Sint32)(SDL_GetTicks() - end) >= 0 ) {
+			break;
+		}
+		SDL_Delay(1);
+	}
+	return retval;
+}
+
 /* Unlock the mutex */
 int SDL_mutexV(SDL_mutex *mutex)
 {
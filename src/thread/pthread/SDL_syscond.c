@@ -23,6 +23,7 @@
 
 #ifdef SDL_THREAD_PTHREAD
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <errno.h>
 #include <pthread.h>
@@ -39,14 +40,21 @@ struct SDL_cond
 SDL_cond * SDL_CreateCond(void)
 {
 	SDL_cond *cond;
+	pthread_condattr_t attr;
 
 	cond = (SDL_cond *) SDL_malloc(sizeof(SDL_cond));
 	if ( cond ) {
-		if ( pthread_cond_init(&cond->cond, NULL) < 0 ) {
+		pthread_condattr_init(&attr);
+#if HAVE_PTHREAD_CONDATTR_SETCLOCK
+		/* Timeouts shouldn't change when the wall clock is set */
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+		if ( pthread_cond_init(&cond->cond, &attr) != 0 ) {
 			SDL_SetError("pthread_cond_init() failed");
 			SDL_free(cond);
 			cond = NULL;
 		}
+		pthread_condattr_destroy(&attr);
 	}
 	return(cond);
 }
@@ -99,7 +107,9 @@ int SDL_CondBroadcast(SDL_cond *cond)
 int SDL_CondWaitTimeout(SDL_cond *cond, SDL_mutex *mutex, Uint32 ms)
 {
 	int retval;
+#if !HAVE_PTHREAD_CONDATTR_SETCLOCK
 	struct timeval delta;
+#endif
 	struct timespec abstime;
 
 	if ( ! cond ) {
@@ -107,14 +117,20 @@ int SDL_CondWaitTimeout(SDL_cond *cond, SDL_mutex *mutex, Uint32 ms)
 		return -1;
 	}
 
+#if HAVE_PTHREAD_CONDATTR_SETCLOCK
+	clock_gettime(CLOCK_MONOTONIC, &abstime);
+	abstime.tv_sec += (ms/1000);
+	abstime.tv_nsec += (ms%1000) * 1000000;
+#else
 	gettimeofday(&delta, NULL);
 
 	abstime.tv_sec = delta.tv_sec + (ms/1000);
 	abstime.tv_nsec = (delta.tv_usec + (ms%1000) * 1000) * 1000;
-        if ( abstime.tv_nsec > 1000000000 ) {
-          abstime.tv_sec += 1;
-          abstime.tv_nsec -= 1000000000;
-        }
+#endif
+	if ( abstime.tv_nsec >= 1000000000 ) {
+		abstime.tv_sec += 1;
+		abstime.tv_nsec -= 1000000000;
+	}
 
   tryagain:
 	retval = pthread_cond_timedwait(&cond->cond, &mutex->id, &abstime);
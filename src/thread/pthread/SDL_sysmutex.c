@@ -26,8 +26,11 @@
 #define _GNU_SOURCE
 #endif
 #include <pthread.h>
+#include <errno.h>
+#include <sys/time.h>
 
 #include "SDL_thread.h"
+#include "SDL_timer.h"
 
 #if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
     !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
@@ -117,6 +120,89 @@ int SDL_mutexP(SDL_mutex *mutex)
 	return retval;
 }
 
+/* Lock the mutex, waiting until the deadline at most */
+static int LockMutex(SDL_mutex *mutex, Uint32 ms)
+{
+	int result;
+#if HAVE_PTHREAD_MUTEX_TIMEDLOCK
+	struct timeval now;
+	struct timespec abstime;
+#else
+	Uint32 end;
+#endif
+
+	if ( ms == 0 ) {
+		result = pthread_mutex_trylock(&mutex->id);
+	} else if ( ms == SDL_MUTEX_MAXWAIT ) {
+		result = pthread_mutex_lock(&mutex->id);
+	} else {
+#if HAVE_PTHREAD_MUTEX_TIMEDLOCK
+		/* pthread_mutex_timedlock() only takes wall clock deadlines */
+		gettimeofday(&now, NULL);
+		abstime.tv_sec = now.tv_sec + (ms/1000);
+		abstime.tv_nsec = (now.tv_usec + (ms%1000) * 1000) * 1000;
+		if ( abstime.tv_nsec >= 1000000000 ) {
+			abstime.tv_sec += 1;
+			abstime.tv_nsec -= 1000000000;
+		}
+		result = pthread_mutex_timedlock(&mutex->id, &abstime);
+#else
+		end = SDL_GetTicks() + ms;
+		while ( (result = pthread_mutex_trylock(&mutex->id)) == EBUSY ) {
+			if ( (Sint32)(SDL_GetTicks() - end) >= 0 ) {
+				break;
+			}
+			SDL_Delay(1);
+		}
+#endif
+	}
+
+	switch (result) {
+	    case 0:
+		return 0;
+	    case EBUSY:
+	    case ETIMEDOUT:
+		return SDL_MUTEX_TIMEDOUT;
+	    default:
+		SDL_SetError("Couldn't lock mutex");
+		return -1;
+	}
+}
+
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+	int retval;
+#if FAKE_RECURSIVE_MUTEX
+	pthread_t this_thread;
+#endif
+
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+
+#if FAKE_RECURSIVE_MUTEX
+	this_thread = pthread_self();
+	if ( mutex->owner == this_thread ) {
+		++mutex->recursive;
+		return 0;
+	}
+	retval = LockMutex(mutex, ms);
+	if ( retval == 0 ) {
+		mutex->owner = this_thread;
+		mutex->recursive = 0;
+	}
+#else
+	retval = LockMutex(mutex, ms);
+#endif
+	return retval;
+}
+
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	return SDL_LockMutexTimeout(mutex, 0);
+}
+
 int SDL_mutexV(SDL_mutex *mutex)
 {
 	int retval;
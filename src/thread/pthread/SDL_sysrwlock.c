@@ -0,0 +1,138 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2012 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+#ifdef SDL_THREAD_PTHREAD
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <errno.h>
+#include <pthread.h>
+
+#include "SDL_thread.h"
+
+/* Reader-writer locks using POSIX rwlocks */
+
+struct SDL_rwlock {
+	pthread_rwlock_t id;
+};
+
+SDL_rwlock *SDL_CreateRWLock(void)
+{
+	SDL_rwlock *rwlock;
+
+	rwlock = (SDL_rwlock *)SDL_malloc(sizeof(*rwlock));
+	if ( rwlock ) {
+		if ( pthread_rwlock_init(&rwlock->id, NULL) != 0 ) {
+			SDL_SetError("pthread_rwlock_init() failed");
+			SDL_free(rwlock);
+			rwlock = NULL;
+		}
+	} else {
+		SDL_OutOfMemory();
+	}
+	return(rwlock);
+}
+
+void SDL_DestroyRWLock(SDL_rwlock *rwlock)
+{
+	if ( rwlock ) {
+		pthread_rwlock_destroy(&rwlock->id);
+		SDL_free(rwlock);
+	}
+}
+
+int SDL_LockRWLockForReading(SDL_rwlock *rwlock)
+{
+	if ( rwlock == NULL ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_rdlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_rdlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_LockRWLockForWriting(SDL_rwlock *rwlock)
+{
+	if ( rwlock == NULL ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_wrlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_wrlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_TryLockRWLockForReading(SDL_rwlock *rwlock)
+{
+	int result;
+
+	if ( rwlock == NULL ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	result = pthread_rwlock_tryrdlock(&rwlock->id);
+	if ( result == EBUSY ) {
+		return SDL_MUTEX_TIMEDOUT;
+	} else if ( result != 0 ) {
+		SDL_SetError("pthread_rwlock_tryrdlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_TryLockRWLockForWriting(SDL_rwlock *rwlock)
+{
+	int result;
+
+	if ( rwlock == NULL ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	result = pthread_rwlock_trywrlock(&rwlock->id);
+	if ( result == EBUSY ) {
+		return SDL_MUTEX_TIMEDOUT;
+	} else if ( result != 0 ) {
+		SDL_SetError("pthread_rwlock_trywrlock() failed");
+		return -1;
+	}
+	return 0;
+}
+
+int SDL_UnlockRWLock(SDL_rwlock *rwlock)
+{
+	if ( rwlock == NULL ) {
+		SDL_SetError("Passed a NULL rwlock");
+		return -1;
+	}
+	if ( pthread_rwlock_unlock(&rwlock->id) != 0 ) {
+		SDL_SetError("pthread_rwlock_unlock() failed");
+		return -1;
+	}
+	return 0;
+}
+#endif /* SDL_THREAD_PTHREAD */
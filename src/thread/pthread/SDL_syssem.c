@@ -22,10 +22,14 @@
 #include "SDL_config.h"
 
 #if defined(SDL_THREAD_PTHREAD)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <pthread.h>
 #include <semaphore.h>
 #include <errno.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "SDL_thread.h"
 #include "SDL_timer.h"
@@ -99,7 +103,9 @@ int SDL_SemWait(SDL_sem *sem)
 int SDL_SemWaitTimeout(SDL_sem *sem, Uint32 timeout)
 {
 	int retval;
-#ifdef HAVE_SEM_TIMEDWAIT
+#if HAVE_SEM_CLOCKWAIT
+	struct timespec ts_timeout;
+#elif defined(HAVE_SEM_TIMEDWAIT)
 	struct timeval now;
 	struct timespec ts_timeout;
 #else
@@ -119,7 +125,31 @@ int SDL_SemWaitTimeout(SDL_sem *sem, Uint32 timeout)
 		return SDL_SemWait(sem);
 	}
 
-#ifdef HAVE_SEM_TIMEDWAIT
+#if HAVE_SEM_CLOCKWAIT
+	/* Wait until a deadline on the monotonic clock, so that setting
+	 * the wall clock doesn't shorten or stretch the timeout.
+	 */
+	clock_gettime(CLOCK_MONOTONIC, &ts_timeout);
+	ts_timeout.tv_sec += timeout / 1000;
+	ts_timeout.tv_nsec += (timeout % 1000) * 1000000;
+	if ( ts_timeout.tv_nsec >= 1000000000 ) {
+		ts_timeout.tv_nsec -= 1000000000;
+		ts_timeout.tv_sec ++;
+	}
+
+	do
+		retval = sem_clockwait(&sem->sem, CLOCK_MONOTONIC, &ts_timeout);
+	while (retval == -1 && errno == EINTR);
+
+	if (retval == -1) {
+		if (errno == ETIMEDOUT) {
+			retval = SDL_MUTEX_TIMEDOUT;
+		}
+		else {
+			SDL_SetError(strerror(errno));
+		}
+	}
+#elif defined(HAVE_SEM_TIMEDWAIT)
 	/* Setup the timeout. sem_timedwait doesn't wait for
 	 * a lapse of time, but until we reach a certain time.
 	 * This time is now plus the timeout.
@@ -22,9 +22,24 @@
 #include "SDL_config.h"
 
 #ifdef SDL_THREAD_PTHREAD
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 
+#if defined(__LINUX__)
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#elif defined(__MACOSX__)
+#include <AvailabilityMacros.h>
+#elif defined(__FREEBSD__) || defined(__OPENBSD__)
+#include <pthread_np.h>
+#endif
+
 #include "SDL_thread.h"
 #include "../SDL_thread_c.h"
 #include "../SDL_systhread.h"
@@ -104,6 +119,147 @@ Uint32 SDL_ThreadID(void)
 	return((Uint32)((size_t)pthread_self()));
 }
 
+static pthread_key_t thread_local_storage;
+static pthread_once_t tls_once = PTHREAD_ONCE_INIT;
+static int tls_valid = 0;
+
+static void TLS_CreateKey(void)
+{
+	if ( pthread_key_create(&thread_local_storage, SDL_TLSCleanup) == 0 ) {
+		tls_valid = 1;
+	}
+}
+
+SDL_TLSData *SDL_SYS_GetTLSData(void)
+{
+	pthread_once(&tls_once, TLS_CreateKey);
+	if ( !tls_valid ) {
+		return(NULL);
+	}
+	return((SDL_TLSData *)pthread_getspecific(thread_local_storage));
+}
+
+int SDL_SYS_SetTLSData(SDL_TLSData *data)
+{
+	pthread_once(&tls_once, TLS_CreateKey);
+	if ( !tls_valid ||
+	     pthread_setspecific(thread_local_storage, data) != 0 ) {
+		return(-1);
+	}
+	return(0);
+}
+
+int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
+{
+	pthread_t self = pthread_self();
+	struct sched_param param;
+	int policy, min, max;
+#ifdef __LINUX__
+	static const int nice_levels[] = { 5, 0, -10, -20 };
+#endif
+
+	/* Use real-time scheduling for the high priorities, if permitted */
+	if ( priority >= SDL_THREAD_PRIORITY_HIGH ) {
+		if ( priority == SDL_THREAD_PRIORITY_TIME_CRITICAL ) {
+			policy = SCHED_FIFO;
+		} else {
+			policy = SCHED_RR;
+		}
+		min = sched_get_priority_min(policy);
+		max = sched_get_priority_max(policy);
+		if ( priority == SDL_THREAD_PRIORITY_TIME_CRITICAL ) {
+			param.sched_priority = max;
+		} else {
+			param.sched_priority = min + (max - min) / 4;
+		}
+		if ( pthread_setschedparam(self, policy, &param) == 0 ) {
+			return(0);
+		}
+	}
+
+	/* Otherwise go back to (or stay with) time sharing scheduling */
+	if ( (pthread_getschedparam(self, &policy, &param) == 0) &&
+	     (policy != SCHED_OTHER) ) {
+		param.sched_priority = 0;
+		pthread_setschedparam(self, SCHED_OTHER, &param);
+	}
+#ifdef __LINUX__
+	/* Linux threads have their own nice level */
+	if ( setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid),
+	                 nice_levels[priority]) < 0 ) {
+		SDL_SetError("Couldn't set thread priority");
+		return(-1);
+	}
+#else
+	min = sched_get_priority_min(SCHED_OTHER);
+	max = sched_get_priority_max(SCHED_OTHER);
+	switch (priority) {
+	    case SDL_THREAD_PRIORITY_LOW:
+		param.sched_priority = min;
+		break;
+	    case SDL_THREAD_PRIORITY_NORMAL:
+		param.sched_priority = min + (max - min) / 2;
+		break;
+	    default:
+		param.sched_priority = max;
+		break;
+	}
+	if ( pthread_setschedparam(self, SCHED_OTHER, &param) != 0 ) {
+		SDL_SetError("Couldn't set thread priority");
+		return(-1);
+	}
+#endif
+	return(0);
+}
+
+int SDL_SYS_SetThreadName(const char *name)
+{
+#if defined(__LINUX__) && defined(PR_SET_NAME)
+	/* The kernel keeps the first 15 characters */
+	if ( prctl(PR_SET_NAME, (unsigned long)name, 0, 0, 0) < 0 ) {
+		SDL_SetError("Couldn't set thread name");
+		return(-1);
+	}
+	return(0);
+#elif defined(__MACOSX__) && (MAC_OS_X_VERSION_MIN_REQUIRED >= 1060)
+	if ( pthread_setname_np(name) != 0 ) {
+		SDL_SetError("Couldn't set thread name");
+		return(-1);
+	}
+	return(0);
+#elif defined(__FREEBSD__) || defined(__OPENBSD__)
+	pthread_set_name_np(pthread_self(), name);
+	return(0);
+#else
+	SDL_SetError("Thread names are not supported on this platform");
+	return(-1);
+#endif
+}
+
+int SDL_SYS_SetThreadAffinity(Uint32 cpumask)
+{
+#if defined(__LINUX__) && defined(CPU_SET)
+	cpu_set_t cpus;
+	int i;
+
+	CPU_ZERO(&cpus);
+	for ( i = 0; i < CPU_SETSIZE; ++i ) {
+		if ( !cpumask || ((i < 32) && (cpumask & ((Uint32)1 << i))) ) {
+			CPU_SET(i, &cpus);
+		}
+	}
+	/* A pid of 0 is the calling thread */
+	if ( sched_setaffinity(0, sizeof(cpus), &cpus) < 0 ) {
+		SDL_SetError("Couldn't set thread affinity");
+		return(-1);
+	}
+	return(0);
+#else
+	SDL_SetError("Thread affinity is not supported on this platform");
+	return(-1);
+#endif
+}
+
 void SDL_SYS_WaitThread(SDL_Thread *thread)
 {
 	pthread_join(thread->handle, 0);
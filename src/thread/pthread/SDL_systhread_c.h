@@ -24,3 +24,9 @@
 #include <pthread.h>
 
 typedef pthread_t SYS_ThreadHandle;
+
+/* Thread local storage is implemented with pthread keys */
+#define SDL_SYS_HAS_TLS	1
+
+/* Thread priority, name and affinity are set with the pthread API */
+#define SDL_SYS_HAS_THREAD_CONTROL	1
@@ -116,6 +116,22 @@ int SDL_mutexP(SDL_mutex *mutex)
 	return(0);
 }
 
+/* RMutex can't be waited on with a timeout */
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	SDL_SetError("Timed mutex locks are not supported");
+	return -1;
+}
+
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+	if ( ms == SDL_MUTEX_MAXWAIT ) {
+		return SDL_mutexP(mutex);
+	}
+	SDL_SetError("Timed mutex locks are not supported");
+	return -1;
+}
+
 /* Unlock the mutex */
 int SDL_mutexV(SDL_mutex *mutex)
 {
@@ -80,6 +80,32 @@ int SDL_mutexP(SDL_mutex *mutex)
 	return(0);
 }
 
+/* Lock the mutex, waiting for it at most 'ms' milliseconds */
+int SDL_LockMutexTimeout(SDL_mutex *mutex, Uint32 ms)
+{
+	DWORD result;
+
+	if ( mutex == NULL ) {
+		SDL_SetError("Passed a NULL mutex");
+		return -1;
+	}
+	/* SDL_MUTEX_MAXWAIT is the same as INFINITE */
+	result = WaitForSingleObject(mutex->id, (DWORD)ms);
+	if ( result == WAIT_TIMEOUT ) {
+		return SDL_MUTEX_TIMEDOUT;
+	}
+	if ( result == WAIT_FAILED ) {
+		SDL_SetError("Couldn't wait on mutex");
+		return -1;
+	}
+	return(0);
+}
+
+int SDL_TryLockMutex(SDL_mutex *mutex)
+{
+	return SDL_LockMutexTimeout(mutex, 0);
+}
+
 /* Unlock the mutex */
 int SDL_mutexV(SDL_mutex *mutex)
 {
@@ -146,6 +146,73 @@ Uint32 SDL_ThreadID(void)
 	return((Uint32)GetCurrentThreadId());
 }
 
+int SDL_SYS_SetThreadPriority(SDL_ThreadPriority priority)
+{
+	static const int priorities[] = {
+		THREAD_PRIORITY_LOWEST,
+		THREAD_PRIORITY_NORMAL,
+		THREAD_PRIORITY_HIGHEST,
+		THREAD_PRIORITY_TIME_CRITICAL
+	};
+
+	if ( !SetThreadPriority(GetCurrentThread(), priorities[priority]) ) {
+		SDL_SetError("Couldn't set thread priority");
+		return(-1);
+	}
+	return(0);
+}
+
+int SDL_SYS_SetThreadName(const char *name)
+{
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+	/* Debuggers pick up the name from this exception */
+	struct {
+		DWORD dwType;		/* Must be 0x1000 */
+		LPCSTR szName;
+		DWORD dwThreadID;	/* -1 for the calling thread */
+		DWORD dwFlags;
+	} info;
+
+	info.dwType = 0x1000;
+	info.szName = name;
+	info.dwThreadID = (DWORD)-1;
+	info.dwFlags = 0;
+	__try {
+		RaiseException(0x406D1388, 0, sizeof(info)/sizeof(ULONG_PTR),
+		               (const ULONG_PTR *)&info);
+	} __except(EXCEPTION_EXECUTE_HANDLER) {
+	}
+	return(0);
+#else
+	SDL_SetError("Thread names are not supported on this platform");
+	return(-1);
+#endif
+}
+
+int SDL_SYS_SetThreadAffinity(Uint32 cpumask)
+{
+#ifdef _WIN32_WCE
+	SDL_SetError("Thread affinity is not supported on this platform");
+	return(-1);
+#else
+	DWORD_PTR mask, system_mask;
+
+	mask = cpumask;
+	if ( !mask ) {
+		if ( !GetProcessAffinityMask(GetCurrentProcess(),
+		                             &mask, &system_mask) ) {
+			SDL_SetError("Couldn't get process affinity");
+			return(-1);
+		}
+	}
+	if ( !SetThreadAffinityMask(GetCurrentThread(), mask) ) {
+		SDL_SetError("Couldn't set thread affinity");
+		return(-1);
+	}
+	return(0);
+#endif
+}
+
 void SDL_SYS_WaitThread(SDL_Thread *thread)
 {
 	WaitForSingleObject(thread->handle, INFINITE);
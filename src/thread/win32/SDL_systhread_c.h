@@ -26,3 +26,6 @@
 
 typedef HANDLE SYS_ThreadHandle;
 
+/* Thread priority, name and affinity are set with the Win32 API */
+#define SDL_SYS_HAS_THREAD_CONTROL	1
+
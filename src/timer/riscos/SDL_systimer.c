@@ -189,6 +189,10 @@ static SDL_Thread *timer = NULL;
 
 static int RunTimer(void *unused)
 {
+	/* Keep the timers on time when the CPUs are busy */
+	SDL_SetThreadName("SDLTimer");
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
 	while ( timer_alive ) {
 		if ( SDL_timer_running ) {
 			SDL_ThreadedTimerCheck();
@@ -38,7 +38,7 @@
    for __USE_POSIX199309
    Tommi Kyntola (tommi.kyntola@ray.fi) 27/09/2005
 */
-#if HAVE_NANOSLEEP || HAVE_CLOCK_GETTIME
+#if HAVE_NANOSLEEP || HAVE_CLOCK_GETTIME || HAVE_CLOCK_MONOTONIC
 #include <time.h>
 #endif
 
@@ -50,18 +50,23 @@
 #define USE_ITIMER
 #endif
 
+/* Use the monotonic clock whenever configure found it */
+#if HAVE_CLOCK_GETTIME || HAVE_CLOCK_MONOTONIC
+#define USE_CLOCK_MONOTONIC
+#endif
+
 /* The first ticks value of the application */
-#ifdef HAVE_CLOCK_GETTIME
+#ifdef USE_CLOCK_MONOTONIC
 static struct timespec start;
 #else
 static struct timeval start;
-#endif /* HAVE_CLOCK_GETTIME */
+#endif /* USE_CLOCK_MONOTONIC */
 
 
 void SDL_StartTicks(void)
 {
 	/* Set first ticks value */
-#if HAVE_CLOCK_GETTIME
+#ifdef USE_CLOCK_MONOTONIC
 	clock_gettime(CLOCK_MONOTONIC,&start);
 #else
 	gettimeofday(&start, NULL);
@@ -70,7 +75,7 @@ void SDL_StartTicks(void)
 
 Uint32 SDL_GetTicks (void)
 {
-#if HAVE_CLOCK_GETTIME
+#ifdef USE_CLOCK_MONOTONIC
 	Uint32 ticks;
 	struct timespec now;
 	clock_gettime(CLOCK_MONOTONIC,&now);
@@ -196,6 +201,10 @@ static SDL_Thread *timer = NULL;
 
 static int RunTimer(void *unused)
 {
+	/* Keep the timers on time when the CPUs are busy */
+	SDL_SetThreadName("SDLTimer");
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
 	while ( timer_alive ) {
 		if ( SDL_timer_running ) {
 			SDL_ThreadedTimerCheck();
@@ -52,8 +52,9 @@
  * Encoding of colorkeyed surfaces:
  *
  *   Encoded pixels always have the same format as the target surface.
- *   <skip> and <run> are unsigned 8 bit integers, except for 32 bit depth
- *   where they are 16 bit. This makes the pixel data aligned at all times.
+ *   <skip> and <run> are unsigned 8 bit integers for 8 and 24 bit depths,
+ *   and 16 bit for 16 and 32 bit depths. This makes the pixel data aligned
+ *   at all times.
  *   Segments never wrap around from one scan line to the next.
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the *
@@ -78,12 +79,20 @@
  *   and the hole filled with the 5 most significant bits of the alpha value.
  *   i.e. if the target has the format         rrrrrggggggbbbbb,
  *   the encoded pixel will be 00000gggggg00000rrrrr0aaaaabbbbb.
- *   The <skip> and <run> counts are 8 bit for the opaque lines, 16 bit
- *   for the translucent lines. Two padding bytes may be inserted
- *   before each translucent line to keep them 32-bit aligned.
+ *   The <skip> and <run> counts are 16 bit. Two padding bytes may be
+ *   inserted before each translucent line to keep them 32-bit aligned.
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Row index:
+ *
+ *   Both encodings are preceded by a table of 32-bit offsets into the
+ *   sequence, one for every RLE_INDEX_INTERVAL scan lines, so blits clipped
+ *   at the top can start near their first line instead of walking over all
+ *   the lines above it. Lines past the end of the sequence point at the
+ *   end marker. For surfaces with per-pixel alpha the table follows the
+ *   struct RLEDestFormat.
  */
 
 #include "SDL_video.h"
@@ -96,10 +105,19 @@
 #define MMX_ASMBLIT
 #endif
 
+#if SDL_ASSEMBLY_ROUTINES && (defined(__SSE2__) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || \
+			  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+#define SSE2_RLEBLIT
+#endif
+
 #ifdef MMX_ASMBLIT
 #include "mmx.h"
-#include "SDL_cpuinfo.h"
 #endif
+#ifdef SSE2_RLEBLIT
+#include <emmintrin.h>
+#endif
+#include "SDL_cpuinfo.h"
 
 #ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -108,6 +126,11 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* The row index has an entry every RLE_INDEX_INTERVAL lines */
+#define RLE_INDEX_INTERVAL	8
+#define RLE_INDEX_SIZE(h)	\
+    ((((h) + RLE_INDEX_INTERVAL - 1) / RLE_INDEX_INTERVAL) * sizeof(Uint32))
+
 #define PIXEL_COPY(to, from, len, bpp)			\
 do {							\
     if(bpp == 4) {					\
@@ -618,6 +641,182 @@ do {							\
 #define ALPHA_BLIT16_555_50(to, from, length, bpp, alpha)	\
     ALPHA_BLIT16_50(to, from, length, bpp, alpha, 0xfbde)
 
+#ifdef SSE2_RLEBLIT
+
+/*
+ * SSE2 versions of the blitters above. They do the same arithmetic on
+ * four pixels at a time (eight for 16bpp at 50%), so the results are
+ * identical to the C versions.
+ */
+
+#define RLE_HAS_SSE2()	SDL_HasSSE2()
+
+/*
+ * Low 32 bits of x * alpha in each lane. Alpha fits in 16 bits and is
+ * repeated in both halves of each lane, so 16 bit multiplies are enough.
+ */
+static __inline__ __m128i MulAlpha(__m128i x, __m128i alpha)
+{
+    return _mm_add_epi32(_mm_mullo_epi16(x, alpha),
+			 _mm_slli_epi32(_mm_mulhi_epu16(x, alpha), 16));
+}
+
+/* four pixels of ALPHA_BLIT32_888 */
+static __inline__ __m128i Blend888(__m128i s, __m128i d, __m128i alpha)
+{
+    const __m128i rb = _mm_set1_epi32(0x00ff00ff);
+    const __m128i g = _mm_set1_epi32(0x0000ff00);
+    __m128i s1 = _mm_and_si128(s, rb);
+    __m128i d1 = _mm_and_si128(d, rb);
+    d1 = _mm_add_epi32(d1, _mm_srli_epi32(MulAlpha(_mm_sub_epi32(s1, d1),
+						   alpha), 8));
+    d1 = _mm_and_si128(d1, rb);
+    s = _mm_and_si128(s, g);
+    d = _mm_and_si128(d, g);
+    d = _mm_add_epi32(d, _mm_srli_epi32(MulAlpha(_mm_sub_epi32(s, d),
+						 alpha), 8));
+    d = _mm_and_si128(d, g);
+    return _mm_or_si128(d1, d);
+}
+
+/* spread four zero-extended 16bpp pixels as in ALPHA_BLIT16_565 */
+static __inline__ __m128i Spread16(__m128i x, __m128i mask)
+{
+    return _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x, 16)), mask);
+}
+
+/* four spread pixels of ALPHA_BLIT16_565, alpha already 5 bits */
+static __inline__ __m128i Blend16(__m128i s, __m128i d, __m128i alpha,
+				  __m128i mask)
+{
+    d = _mm_add_epi32(d, _mm_srli_epi32(MulAlpha(_mm_sub_epi32(s, d),
+						 alpha), 5));
+    return _mm_and_si128(d, mask);
+}
+
+/* fold eight spread pixels back to 16bpp */
+static __inline__ __m128i Pack16(__m128i lo, __m128i hi)
+{
+    lo = _mm_or_si128(lo, _mm_srli_epi32(lo, 16));
+    hi = _mm_or_si128(hi, _mm_srli_epi32(hi, 16));
+    /* sign extend the low halves so that the pack doesn't saturate */
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+static void BlitAlpha32_888SSE2(Uint32 *to, Uint32 *from, int n,
+				unsigned alpha)
+{
+    __m128i a = _mm_set1_epi32(alpha | alpha << 16);
+    for(; n >= 4; n -= 4) {
+	__m128i s = _mm_loadu_si128((__m128i *)from);
+	__m128i d = _mm_loadu_si128((__m128i *)to);
+	_mm_storeu_si128((__m128i *)to, Blend888(s, d, a));
+	from += 4;
+	to += 4;
+    }
+    ALPHA_BLIT32_888(to, from, n, 4, alpha);
+}
+
+/* mask is 0x07e0f81f for 565 and 0x03e07c1f for 555 */
+static void BlitAlpha16SSE2(Uint16 *dst, Uint16 *src, int n,
+			    unsigned alpha, Uint32 mask)
+{
+    Uint32 ALPHA = alpha >> 3;
+    __m128i a = _mm_set1_epi32(ALPHA | ALPHA << 16);
+    __m128i m = _mm_set1_epi32(mask);
+    __m128i zero = _mm_setzero_si128();
+    for(; n >= 8; n -= 8) {
+	__m128i s = _mm_loadu_si128((__m128i *)src);
+	__m128i d = _mm_loadu_si128((__m128i *)dst);
+	__m128i lo = Blend16(Spread16(_mm_unpacklo_epi16(s, zero), m),
+			     Spread16(_mm_unpacklo_epi16(d, zero), m), a, m);
+	__m128i hi = Blend16(Spread16(_mm_unpackhi_epi16(s, zero), m),
+			     Spread16(_mm_unpackhi_epi16(d, zero), m), a, m);
+	_mm_storeu_si128((__m128i *)dst, Pack16(lo, hi));
+	src += 8;
+	dst += 8;
+    }
+    for(; n > 0; n--) {
+	Uint32 s = *src++;
+	Uint32 d = *dst;
+	s = (s | s << 16) & mask;
+	d = (d | d << 16) & mask;
+	d += (s - d) * ALPHA >> 5;
+	d &= mask;
+	*dst++ = (Uint16)(d | d >> 16);
+    }
+}
+
+static void BlitAlpha32_50SSE2(Uint32 *to, Uint32 *from, int n)
+{
+    __m128i m = _mm_set1_epi32(0x00fefefe);
+    __m128i low = _mm_set1_epi32(0x00010101);
+    for(; n >= 4; n -= 4) {
+	__m128i s = _mm_loadu_si128((__m128i *)from);
+	__m128i d = _mm_loadu_si128((__m128i *)to);
+	__m128i sum = _mm_add_epi32(_mm_and_si128(s, m), _mm_and_si128(d, m));
+	sum = _mm_add_epi32(_mm_srli_epi32(sum, 1),
+			    _mm_and_si128(_mm_and_si128(s, d), low));
+	_mm_storeu_si128((__m128i *)to, sum);
+	from += 4;
+	to += 4;
+    }
+    ALPHA_BLIT32_888_50(to, from, n, 4, 128);
+}
+
+static void BlitAlpha16_50SSE2(Uint16 *dst, Uint16 *src, int n, Uint16 mask)
+{
+    __m128i m = _mm_set1_epi16((short)mask);
+    __m128i low = _mm_set1_epi16((short)~mask);
+    for(; n >= 8; n -= 8) {
+	__m128i s = _mm_loadu_si128((__m128i *)src);
+	__m128i d = _mm_loadu_si128((__m128i *)dst);
+	/* shift before adding, the sum doesn't fit in 16 bits */
+	__m128i sum = _mm_add_epi16(_mm_srli_epi16(_mm_and_si128(s, m), 1),
+				    _mm_srli_epi16(_mm_and_si128(d, m), 1));
+	sum = _mm_add_epi16(sum, _mm_and_si128(_mm_and_si128(s, d), low));
+	_mm_storeu_si128((__m128i *)dst, sum);
+	src += 8;
+	dst += 8;
+    }
+    while(n--)
+	BLEND16_50(dst, src, mask);
+}
+
+#define ALPHA_BLIT32_888SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha32_888SSE2((Uint32 *)(to), (Uint32 *)(from), length, alpha)
+
+#define ALPHA_BLIT16_565SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha16SSE2((Uint16 *)(to), (Uint16 *)(from), length, alpha,	\
+		    0x07e0f81f)
+
+#define ALPHA_BLIT16_555SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha16SSE2((Uint16 *)(to), (Uint16 *)(from), length, alpha,	\
+		    0x03e07c1f)
+
+#define ALPHA_BLIT32_888_50SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha32_50SSE2((Uint32 *)(to), (Uint32 *)(from), length)
+
+#define ALPHA_BLIT16_565_50SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha16_50SSE2((Uint16 *)(to), (Uint16 *)(from), length, 0xf7de)
+
+#define ALPHA_BLIT16_555_50SSE2(to, from, length, bpp, alpha)		\
+    BlitAlpha16_50SSE2((Uint16 *)(to), (Uint16 *)(from), length, 0xfbde)
+
+#else
+
+#define RLE_HAS_SSE2()	0
+#define ALPHA_BLIT32_888SSE2	ALPHA_BLIT32_888
+#define ALPHA_BLIT16_565SSE2	ALPHA_BLIT16_565
+#define ALPHA_BLIT16_555SSE2	ALPHA_BLIT16_555
+#define ALPHA_BLIT32_888_50SSE2	ALPHA_BLIT32_888_50
+#define ALPHA_BLIT16_565_50SSE2	ALPHA_BLIT16_565_50
+#define ALPHA_BLIT16_555_50SSE2	ALPHA_BLIT16_555_50
+
+#endif /* SSE2_RLEBLIT */
+
 #ifdef MMX_ASMBLIT
 
 #define CHOOSE_BLIT(blitter, alpha, fmt)				\
@@ -625,7 +824,7 @@ do {							\
         if(alpha == 255) {						\
 	    switch(fmt->BytesPerPixel) {				\
 	    case 1: blitter(1, Uint8, OPAQUE_BLIT); break;		\
-	    case 2: blitter(2, Uint8, OPAQUE_BLIT); break;		\
+	    case 2: blitter(2, Uint16, OPAQUE_BLIT); break;		\
 	    case 3: blitter(3, Uint8, OPAQUE_BLIT); break;		\
 	    case 4: blitter(4, Uint16, OPAQUE_BLIT); break;		\
 	    }								\
@@ -642,12 +841,12 @@ do {							\
 		       || fmt->Rmask == 0x07e0				\
 		       || fmt->Bmask == 0x07e0) {			\
 			if(alpha == 128)				\
-			    blitter(2, Uint8, ALPHA_BLIT16_565_50);	\
+			    blitter(2, Uint16, ALPHA_BLIT16_565_50);	\
 			else {						\
 			    if(SDL_HasMMX())				\
-				blitter(2, Uint8, ALPHA_BLIT16_565MMX);	\
+				blitter(2, Uint16, ALPHA_BLIT16_565MMX);	\
 			    else					\
-				blitter(2, Uint8, ALPHA_BLIT16_565);	\
+				blitter(2, Uint16, ALPHA_BLIT16_565);	\
 			}						\
 		    } else						\
 			goto general16;					\
@@ -658,12 +857,12 @@ do {							\
 		       || fmt->Rmask == 0x03e0				\
 		       || fmt->Bmask == 0x03e0) {			\
 			if(alpha == 128)				\
-			    blitter(2, Uint8, ALPHA_BLIT16_555_50);	\
+			    blitter(2, Uint16, ALPHA_BLIT16_555_50);	\
 			else {						\
 			    if(SDL_HasMMX())				\
-				blitter(2, Uint8, ALPHA_BLIT16_555MMX);	\
+				blitter(2, Uint16, ALPHA_BLIT16_555MMX);	\
 			    else					\
-				blitter(2, Uint8, ALPHA_BLIT16_555);	\
+				blitter(2, Uint16, ALPHA_BLIT16_555);	\
 			}						\
 			break;						\
 		    }							\
@@ -671,7 +870,7 @@ do {							\
 									\
 		default:						\
 		general16:						\
-		    blitter(2, Uint8, ALPHA_BLIT_ANY);			\
+		    blitter(2, Uint16, ALPHA_BLIT_ANY);			\
 		}							\
 		break;							\
 									\
@@ -711,7 +910,7 @@ do {							\
         if(alpha == 255) {						\
 	    switch(fmt->BytesPerPixel) {				\
 	    case 1: blitter(1, Uint8, OPAQUE_BLIT); break;		\
-	    case 2: blitter(2, Uint8, OPAQUE_BLIT); break;		\
+	    case 2: blitter(2, Uint16, OPAQUE_BLIT); break;		\
 	    case 3: blitter(3, Uint8, OPAQUE_BLIT); break;		\
 	    case 4: blitter(4, Uint16, OPAQUE_BLIT); break;		\
 	    }								\
@@ -727,10 +926,16 @@ do {							\
 		    if(fmt->Gmask == 0x07e0				\
 		       || fmt->Rmask == 0x07e0				\
 		       || fmt->Bmask == 0x07e0) {			\
-			if(alpha == 128)				\
-			    blitter(2, Uint8, ALPHA_BLIT16_565_50);	\
-			else {						\
-			    blitter(2, Uint8, ALPHA_BLIT16_565);	\
+			if(alpha == 128) {				\
+			    if(RLE_HAS_SSE2())				\
+				blitter(2, Uint16, ALPHA_BLIT16_565_50SSE2);\
+			    else					\
+				blitter(2, Uint16, ALPHA_BLIT16_565_50);	\
+			} else {					\
+			    if(RLE_HAS_SSE2())				\
+				blitter(2, Uint16, ALPHA_BLIT16_565SSE2);\
+			    else					\
+				blitter(2, Uint16, ALPHA_BLIT16_565);	\
 			}						\
 		    } else						\
 			goto general16;					\
@@ -740,10 +945,16 @@ do {							\
 		    if(fmt->Gmask == 0x03e0				\
 		       || fmt->Rmask == 0x03e0				\
 		       || fmt->Bmask == 0x03e0) {			\
-			if(alpha == 128)				\
-			    blitter(2, Uint8, ALPHA_BLIT16_555_50);	\
-			else {						\
-			    blitter(2, Uint8, ALPHA_BLIT16_555);	\
+			if(alpha == 128) {				\
+			    if(RLE_HAS_SSE2())				\
+				blitter(2, Uint16, ALPHA_BLIT16_555_50SSE2);\
+			    else					\
+				blitter(2, Uint16, ALPHA_BLIT16_555_50);	\
+			} else {					\
+			    if(RLE_HAS_SSE2())				\
+				blitter(2, Uint16, ALPHA_BLIT16_555SSE2);\
+			    else					\
+				blitter(2, Uint16, ALPHA_BLIT16_555);	\
 			}						\
 			break;						\
 		    }							\
@@ -751,7 +962,7 @@ do {							\
 									\
 		default:						\
 		general16:						\
-		    blitter(2, Uint8, ALPHA_BLIT_ANY);			\
+		    blitter(2, Uint16, ALPHA_BLIT_ANY);			\
 		}							\
 		break;							\
 									\
@@ -763,10 +974,17 @@ do {							\
 		if((fmt->Rmask | fmt->Gmask | fmt->Bmask) == 0x00ffffff	\
 		   && (fmt->Gmask == 0xff00 || fmt->Rmask == 0xff00	\
 		       || fmt->Bmask == 0xff00)) {			\
-		    if(alpha == 128)					\
-			blitter(4, Uint16, ALPHA_BLIT32_888_50);	\
-		    else						\
-			blitter(4, Uint16, ALPHA_BLIT32_888);		\
+		    if(alpha == 128) {					\
+			if(RLE_HAS_SSE2())				\
+			    blitter(4, Uint16, ALPHA_BLIT32_888_50SSE2);\
+			else						\
+			    blitter(4, Uint16, ALPHA_BLIT32_888_50);	\
+		    } else {						\
+			if(RLE_HAS_SSE2())				\
+			    blitter(4, Uint16, ALPHA_BLIT32_888SSE2);	\
+			else						\
+			    blitter(4, Uint16, ALPHA_BLIT32_888);	\
+		    }							\
 		} else							\
 		    blitter(4, Uint16, ALPHA_BLIT_ANY);			\
 		break;							\
@@ -861,9 +1079,14 @@ int SDL_RLEBlit(SDL_Surface *src, SDL_Rect *srcrect,
 	srcbuf = (Uint8 *)src->map->sw_data->aux_data;
 
 	{
-	    /* skip lines at the top if neccessary */
+	    /* skip lines at the top if neccessary, starting from the
+	       closest line in the row index */
+	    Uint32 *rowindex = (Uint32 *)srcbuf;
 	    int vskip = srcrect->y;
 	    int ofs = 0;
+	    srcbuf += RLE_INDEX_SIZE(src->h);
+	    srcbuf += rowindex[vskip / RLE_INDEX_INTERVAL];
+	    vskip %= RLE_INDEX_INTERVAL;
 	    if(vskip) {
 
 #define RLESKIP(bpp, Type)			\
@@ -886,7 +1109,7 @@ int SDL_RLEBlit(SDL_Surface *src, SDL_Rect *srcrect,
 
 		switch(src->format->BytesPerPixel) {
 		case 1: RLESKIP(1, Uint8); break;
-		case 2: RLESKIP(2, Uint8); break;
+		case 2: RLESKIP(2, Uint16); break;
 		case 3: RLESKIP(3, Uint8); break;
 		case 4: RLESKIP(4, Uint16); break;
 		}
@@ -994,6 +1217,76 @@ done:
 	dst = (Uint16)(d | d >> 16);			\
     } while(0)
 
+/* blend a run of n translucent pixels, one at a time */
+#define BLIT_TRANSL_RUN(blend, to, from, n)	\
+    do {					\
+	unsigned i;				\
+	for(i = 0; i < (unsigned)(n); i++)	\
+	    blend((from)[i], (to)[i]);		\
+    } while(0)
+
+#define BLIT_TRANSL_888_RUN(to, from, n)	\
+    BLIT_TRANSL_RUN(BLIT_TRANSL_888, to, from, n)
+#define BLIT_TRANSL_565_RUN(to, from, n)	\
+    BLIT_TRANSL_RUN(BLIT_TRANSL_565, to, from, n)
+#define BLIT_TRANSL_555_RUN(to, from, n)	\
+    BLIT_TRANSL_RUN(BLIT_TRANSL_555, to, from, n)
+
+#ifdef SSE2_RLEBLIT
+
+/* the same, four pixels at a time */
+static void BlitTransl888SSE2(Uint32 *dst, Uint32 *src, int n)
+{
+    for(; n >= 4; n -= 4) {
+	__m128i s = _mm_loadu_si128((__m128i *)src);
+	__m128i d = _mm_loadu_si128((__m128i *)dst);
+	__m128i a = _mm_srli_epi32(s, 24);
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+	_mm_storeu_si128((__m128i *)dst, Blend888(s, d, a));
+	src += 4;
+	dst += 4;
+    }
+    BLIT_TRANSL_888_RUN(dst, src, n);
+}
+
+/* mask is 0x07e0f81f for 565 and 0x03e07c1f for 555 */
+static void BlitTransl16SSE2(Uint16 *dst, Uint32 *src, int n, Uint32 mask)
+{
+    __m128i m = _mm_set1_epi32(mask);
+    __m128i amask = _mm_set1_epi32(0x3e0);
+    __m128i zero = _mm_setzero_si128();
+    for(; n >= 4; n -= 4) {
+	__m128i s = _mm_loadu_si128((__m128i *)src);
+	__m128i d = _mm_loadl_epi64((__m128i *)dst);
+	__m128i a = _mm_srli_epi32(_mm_and_si128(s, amask), 5);
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+	d = Blend16(_mm_and_si128(s, m),
+		    Spread16(_mm_unpacklo_epi16(d, zero), m), a, m);
+	_mm_storel_epi64((__m128i *)dst, Pack16(d, d));
+	src += 4;
+	dst += 4;
+    }
+    if(mask == 0x07e0f81f)
+	BLIT_TRANSL_565_RUN(dst, src, n);
+    else
+	BLIT_TRANSL_555_RUN(dst, src, n);
+}
+
+#define BLIT_TRANSL_888_SSE2(to, from, n)	\
+    BlitTransl888SSE2(to, from, n)
+#define BLIT_TRANSL_565_SSE2(to, from, n)	\
+    BlitTransl16SSE2(to, from, n, 0x07e0f81f)
+#define BLIT_TRANSL_555_SSE2(to, from, n)	\
+    BlitTransl16SSE2(to, from, n, 0x03e07c1f)
+
+#else
+
+#define BLIT_TRANSL_888_SSE2	BLIT_TRANSL_888_RUN
+#define BLIT_TRANSL_565_SSE2	BLIT_TRANSL_565_RUN
+#define BLIT_TRANSL_555_SSE2	BLIT_TRANSL_555_RUN
+
+#endif /* SSE2_RLEBLIT */
+
 /* used to save the destination format in the encoding. Designed to be
    macro-compatible with SDL_PixelFormat but without the unneeded fields */
 typedef struct {
@@ -1018,10 +1311,9 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *dst,
     SDL_PixelFormat *df = dst->format;
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * and do_blend the macro to blend a run of pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)			  \
+#define RLEALPHACLIPBLIT(Ptype, do_blend)				  \
     do {								  \
 	int linecount = srcrect->h;					  \
 	int left = srcrect->x;						  \
@@ -1032,9 +1324,9 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *dst,
 	    /* blit opaque pixels on one line */			  \
 	    do {							  \
 		unsigned run;						  \
-		ofs += ((Ctype *)srcbuf)[0];				  \
-		run = ((Ctype *)srcbuf)[1];				  \
-		srcbuf += 2 * sizeof(Ctype);				  \
+		ofs += ((Uint16 *)srcbuf)[0];				  \
+		run = ((Uint16 *)srcbuf)[1];				  \
+		srcbuf += 4;						  \
 		if(run) {						  \
 		    /* clip to left and right borders */		  \
 		    int cofs = ofs;					  \
@@ -1074,13 +1366,9 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *dst,
 		    }							  \
 		    if(crun > right - cofs)				  \
 			crun = right - cofs;				  \
-		    if(crun > 0) {					  \
-			Ptype *dst = (Ptype *)dstbuf + cofs;		  \
-			Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);	  \
-			int i;						  \
-			for(i = 0; i < crun; i++)			  \
-			    do_blend(src[i], dst[i]);			  \
-		    }							  \
+		    if(crun > 0)					  \
+			do_blend((Ptype *)dstbuf + cofs,		  \
+				 (Uint32 *)srcbuf + (cofs - ofs), crun);  \
 		    srcbuf += run * 4;					  \
 		    ofs += run;						  \
 		}							  \
@@ -1092,13 +1380,23 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *dst,
     switch(df->BytesPerPixel) {
     case 2:
 	if(df->Gmask == 0x07e0 || df->Rmask == 0x07e0
-	   || df->Bmask == 0x07e0)
-	    RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
-	else
-	    RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+	   || df->Bmask == 0x07e0) {
+	    if(RLE_HAS_SSE2())
+		RLEALPHACLIPBLIT(Uint16, BLIT_TRANSL_565_SSE2);
+	    else
+		RLEALPHACLIPBLIT(Uint16, BLIT_TRANSL_565_RUN);
+	} else {
+	    if(RLE_HAS_SSE2())
+		RLEALPHACLIPBLIT(Uint16, BLIT_TRANSL_555_SSE2);
+	    else
+		RLEALPHACLIPBLIT(Uint16, BLIT_TRANSL_555_RUN);
+	}
 	break;
     case 4:
-	RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+	if(RLE_HAS_SSE2())
+	    RLEALPHACLIPBLIT(Uint32, BLIT_TRANSL_888_SSE2);
+	else
+	    RLEALPHACLIPBLIT(Uint32, BLIT_TRANSL_888_RUN);
 	break;
     }
 }
@@ -1126,8 +1424,13 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
     srcbuf = (Uint8 *)src->map->sw_data->aux_data + sizeof(RLEDestFormat);
 
     {
-	/* skip lines at the top if necessary */
+	/* skip lines at the top if necessary, starting from the closest
+	   line in the row index */
+	Uint32 *rowindex = (Uint32 *)srcbuf;
 	int vskip = srcrect->y;
+	srcbuf += RLE_INDEX_SIZE(src->h);
+	srcbuf += rowindex[vskip / RLE_INDEX_INTERVAL];
+	vskip %= RLE_INDEX_INTERVAL;
 	if(vskip) {
 	    int ofs;
 	    if(df->BytesPerPixel == 2) {
@@ -1137,9 +1440,9 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
 		    ofs = 0;
 		    do {
 			int run;
-			ofs += srcbuf[0];
-			run = srcbuf[1];
-			srcbuf += 2;
+			ofs += ((Uint16 *)srcbuf)[0];
+			run = ((Uint16 *)srcbuf)[1];
+			srcbuf += 4;
 			if(run) {
 			    srcbuf += 2 * run;
 			    ofs += run;
@@ -1188,10 +1491,9 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
 
 	/*
 	 * non-clipped blitter. Ptype is the destination pixel type,
-	 * Ctype the translucent count type, and do_blend the
-	 * macro to blend one pixel.
+	 * and do_blend the macro to blend a run of pixels.
 	 */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)				 \
+#define RLEALPHABLIT(Ptype, do_blend)					 \
 	do {								 \
 	    int linecount = srcrect->h;					 \
 	    do {							 \
@@ -1199,9 +1501,9 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
 		/* blit opaque pixels on one line */			 \
 		do {							 \
 		    unsigned run;					 \
-		    ofs += ((Ctype *)srcbuf)[0];			 \
-		    run = ((Ctype *)srcbuf)[1];				 \
-		    srcbuf += 2 * sizeof(Ctype);			 \
+		    ofs += ((Uint16 *)srcbuf)[0];			 \
+		    run = ((Uint16 *)srcbuf)[1];			 \
+		    srcbuf += 4;					 \
 		    if(run) {						 \
 			PIXEL_COPY(dstbuf + ofs * sizeof(Ptype), srcbuf, \
 				   run, sizeof(Ptype));			 \
@@ -1221,14 +1523,9 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
 		    run = ((Uint16 *)srcbuf)[1];			 \
 		    srcbuf += 4;					 \
 		    if(run) {						 \
-			Ptype *dst = (Ptype *)dstbuf + ofs;		 \
-			unsigned i;					 \
-			for(i = 0; i < run; i++) {			 \
-			    Uint32 src = *(Uint32 *)srcbuf;		 \
-			    do_blend(src, *dst);			 \
-			    srcbuf += 4;				 \
-			    dst++;					 \
-			}						 \
+			do_blend((Ptype *)dstbuf + ofs,			 \
+				 (Uint32 *)srcbuf, run);		 \
+			srcbuf += run * 4;				 \
 			ofs += run;					 \
 		    }							 \
 		} while(ofs < w);					 \
@@ -1239,13 +1536,23 @@ int SDL_RLEAlphaBlit(SDL_Surface *src, SDL_Rect *srcrect,
 	switch(df->BytesPerPixel) {
 	case 2:
 	    if(df->Gmask == 0x07e0 || df->Rmask == 0x07e0
-	       || df->Bmask == 0x07e0)
-		RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
-	    else
-		RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+	       || df->Bmask == 0x07e0) {
+		if(RLE_HAS_SSE2())
+		    RLEALPHABLIT(Uint16, BLIT_TRANSL_565_SSE2);
+		else
+		    RLEALPHABLIT(Uint16, BLIT_TRANSL_565_RUN);
+	    } else {
+		if(RLE_HAS_SSE2())
+		    RLEALPHABLIT(Uint16, BLIT_TRANSL_555_SSE2);
+		else
+		    RLEALPHABLIT(Uint16, BLIT_TRANSL_555_RUN);
+	    }
 	    break;
 	case 4:
-	    RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+	    if(RLE_HAS_SSE2())
+		RLEALPHABLIT(Uint32, BLIT_TRANSL_888_SSE2);
+	    else
+		RLEALPHABLIT(Uint32, BLIT_TRANSL_888_RUN);
 	    break;
 	}
     }
@@ -1396,16 +1703,30 @@ static int uncopy_32(Uint32 *dst, void *src, int n,
 #define ISTRANSL(pixel, fmt)	\
     ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
+/*
+ * Make the row index entries of the trailing blank lines, which aren't
+ * encoded, point at the end marker
+ */
+static void RLEClampRowIndex(Uint32 *rowindex, int h, Uint32 end)
+{
+    int i;
+    for(i = 0; i < (h + RLE_INDEX_INTERVAL - 1) / RLE_INDEX_INTERVAL; i++) {
+	if(rowindex[i] > end)
+	    rowindex[i] = end;
+    }
+}
+
 /* convert surface to be quickly alpha-blittable onto dest, if possible */
 static int RLEAlphaSurface(SDL_Surface *surface)
 {
     SDL_Surface *dest;
     SDL_PixelFormat *df;
     int maxsize = 0;
-    int max_opaque_run;
+    int max_opaque_run = 65535;
     int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *stream, *dst;
+    Uint32 *rowindex;
     int (*copy_opaque)(void *, Uint32 *, int,
 		       SDL_PixelFormat *, SDL_PixelFormat *);
     int (*copy_transl)(void *, Uint32 *, int,
@@ -1444,18 +1765,15 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	default:
 	    return -1;
 	}
-	max_opaque_run = 255;	/* runs stored as bytes */
-
 	/* worst case is alternating opaque and translucent pixels,
 	   with room for alignment padding between lines */
-	maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
+	maxsize = surface->h * (2 + (4 + 4) * (surface->w + 1)) + 4;
 	break;
     case 4:
 	if(masksum != 0x00ffffff)
 	    return -1;		/* requires unused high byte */
 	copy_opaque = copy_32;
 	copy_transl = copy_32;
-	max_opaque_run = 255;	/* runs stored as short ints */
 
 	/* worst case is alternating opaque and translucent pixels */
 	maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
@@ -1464,7 +1782,7 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	return -1;		/* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
+    maxsize += sizeof(RLEDestFormat) + RLE_INDEX_SIZE(surface->h);
     rlebuf = (Uint8 *)SDL_malloc(maxsize);
     if(!rlebuf) {
 	SDL_OutOfMemory();
@@ -1486,7 +1804,9 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	r->Bmask = df->Bmask;
 	r->Amask = df->Amask;
     }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    rowindex = (Uint32 *)(rlebuf + sizeof(RLEDestFormat));
+    stream = (Uint8 *)rowindex + RLE_INDEX_SIZE(surface->h);
+    dst = stream;
 
     /* Do the actual encoding */
     {
@@ -1496,17 +1816,9 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	Uint32 *src = (Uint32 *)surface->pixels;
 	Uint8 *lastline = dst;	/* end of last non-blank line */
 
-	/* opaque counts are 8 or 16 bits, depending on target depth */
+	/* opaque counts are 16 bit, like the translucent ones */
 #define ADD_OPAQUE_COUNTS(n, m)			\
-	if(df->BytesPerPixel == 4) {		\
-	    ((Uint16 *)dst)[0] = n;		\
-	    ((Uint16 *)dst)[1] = m;		\
-	    dst += 4;				\
-	} else {				\
-	    dst[0] = n;				\
-	    dst[1] = m;				\
-	    dst += 2;				\
-	}
+	(((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
 
 	/* translucent counts are always 16 bit */
 #define ADD_TRANSL_COUNTS(n, m)		\
@@ -1515,6 +1827,8 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	for(y = 0; y < h; y++) {
 	    int runstart, skipstart;
 	    int blankline = 0;
+	    if(y % RLE_INDEX_INTERVAL == 0)
+		rowindex[y / RLE_INDEX_INTERVAL] = (Uint32)(dst - stream);
 	    /* First encode all opaque pixels of a scan line */
 	    x = 0;
 	    do {
@@ -1586,6 +1900,7 @@ static int RLEAlphaSurface(SDL_Surface *surface)
 	    src += surface->pitch >> 2;
 	}
 	dst = lastline;		/* back up past trailing blank lines */
+	RLEClampRowIndex(rowindex, h, (Uint32)(dst - stream));
 	ADD_OPAQUE_COUNTS(0, 0);
     }
 
@@ -1642,7 +1957,8 @@ static getpix_func getpixes[4] = {
 
 static int RLEColorkeySurface(SDL_Surface *surface)
 {
-        Uint8 *rlebuf, *dst;
+        Uint8 *rlebuf, *stream, *dst;
+	Uint32 *rowindex;
 	int maxn;
 	int y;
 	Uint8 *srcbuf, *lastline;
@@ -1660,6 +1976,10 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 	    maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
 	    break;
 	case 2:
+	    /* worst case is alternating opaque and transparent pixels,
+	       starting with an opaque pixel */
+	    maxsize = surface->h * (4 + 2) * (surface->w / 2 + 2) + 4;
+	    break;
 	case 3:
 	    /* worst case is solid runs, at most 255 pixels wide */
 	    maxsize = surface->h * (2 * (surface->w / 255 + 1)
@@ -1672,6 +1992,7 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 	    break;
 	}
 
+	maxsize += RLE_INDEX_SIZE(surface->h);
 	rlebuf = (Uint8 *)SDL_malloc(maxsize);
 	if ( rlebuf == NULL ) {
 		SDL_OutOfMemory();
@@ -1680,8 +2001,10 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 
 	/* Set up the conversion */
 	srcbuf = (Uint8 *)surface->pixels;
-	maxn = bpp == 4 ? 65535 : 255;
-	dst = rlebuf;
+	maxn = (bpp == 2 || bpp == 4) ? 65535 : 255;
+	rowindex = (Uint32 *)rlebuf;
+	stream = rlebuf + RLE_INDEX_SIZE(surface->h);
+	dst = stream;
 	rgbmask = ~surface->format->Amask;
 	ckey = surface->format->colorkey & rgbmask;
 	lastline = dst;
@@ -1690,7 +2013,7 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 	h = surface->h;
 
 #define ADD_COUNTS(n, m)			\
-	if(bpp == 4) {				\
+	if(bpp == 2 || bpp == 4) {		\
 	    ((Uint16 *)dst)[0] = n;		\
 	    ((Uint16 *)dst)[1] = m;		\
 	    dst += 4;				\
@@ -1703,6 +2026,8 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 	for(y = 0; y < h; y++) {
 	    int x = 0;
 	    int blankline = 0;
+	    if(y % RLE_INDEX_INTERVAL == 0)
+		rowindex[y / RLE_INDEX_INTERVAL] = (Uint32)(dst - stream);
 	    do {
 		int run, skip, len;
 		int runstart;
@@ -1745,6 +2070,7 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 	    srcbuf += surface->pitch;
 	}
 	dst = lastline;		/* back up bast trailing blank lines */
+	RLEClampRowIndex(rowindex, h, (Uint32)(dst - stream));
 	ADD_COUNTS(0, 0);
 
 #undef ADD_COUNTS
@@ -1848,21 +2174,15 @@ static SDL_bool UnRLEAlpha(SDL_Surface *surface)
     SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
 
     dst = surface->pixels;
-    srcbuf = (Uint8 *)(df + 1);
+    srcbuf = (Uint8 *)(df + 1) + RLE_INDEX_SIZE(surface->h);
     for(;;) {
 	/* copy opaque pixels */
 	int ofs = 0;
 	do {
 	    unsigned run;
-	    if(bpp == 2) {
-		ofs += srcbuf[0];
-		run = srcbuf[1];
-		srcbuf += 2;
-	    } else {
-		ofs += ((Uint16 *)srcbuf)[0];
-		run = ((Uint16 *)srcbuf)[1];
-		srcbuf += 4;
-	    }
+	    ofs += ((Uint16 *)srcbuf)[0];
+	    run = ((Uint16 *)srcbuf)[1];
+	    srcbuf += 4;
 	    if(run) {
 		srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
 		ofs += run;
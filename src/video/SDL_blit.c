@@ -246,6 +246,7 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 		SDL_UnRLESurface(surface, 1);
 	}
 	surface->map->sw_blit = NULL;
+	surface->map->sw_data->name = NULL;
 
 	/* Figure out if an accelerated hardware blit is possible */
 	surface->flags &= ~SDL_HWACCEL;
@@ -309,11 +310,13 @@ int SDL_CalculateBlit(SDL_Surface *surface)
 
 	/* Check for special "identity" case -- copy blit */
 	if ( surface->map->identity && blit_index == 0 ) {
-	        surface->map->sw_data->blit = SDL_BlitCopy;
+	        surface->map->sw_data->blit =
+		    SDL_BLIT_SELECT(surface, SDL_BlitCopy);
 
 		/* Handle overlapping blits on the same surface */
 		if ( surface == surface->map->dst ) {
-		        surface->map->sw_data->blit = SDL_BlitCopyOverlap;
+		        surface->map->sw_data->blit =
+			    SDL_BLIT_SELECT(surface, SDL_BlitCopyOverlap);
 		}
 	} else {
 		if ( surface->format->BitsPerPixel < 8 ) {
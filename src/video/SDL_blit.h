@@ -52,6 +52,7 @@ typedef void (*SDL_loblit)(SDL_BlitInfo *info);
 struct private_swaccel {
 	SDL_loblit blit;
 	void *aux_data;
+	const char *name;	/* The name of the blit, for SDL_GetBlitName() */
 };
 
 /* Blit mapping definition */
@@ -79,6 +80,12 @@ extern SDL_loblit SDL_CalculateBlit1(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int complex);
 extern SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int complex);
 
+/* Returns a blit function from the SDL_Calculate*() functions, keeping
+   its name for SDL_GetBlitName() */
+#define SDL_BLIT_NAMED(surface, blit, blitname) \
+	((surface)->map->sw_data->name = (blitname), (blit))
+#define SDL_BLIT_SELECT(surface, blit)	SDL_BLIT_NAMED(surface, blit, #blit)
+
 /*
  * Useful macros for blitting routines
  */
@@ -435,10 +435,16 @@ static void BlitBtoNAlphaKey(SDL_BlitInfo *info)
 static SDL_loblit bitmap_blit[] = {
 	NULL, BlitBto1, BlitBto2, BlitBto3, BlitBto4
 };
+static const char *bitmap_blit_names[] = {
+	NULL, "BlitBto1", "BlitBto2", "BlitBto3", "BlitBto4"
+};
 
 static SDL_loblit colorkey_blit[] = {
     NULL, BlitBto1Key, BlitBto2Key, BlitBto3Key, BlitBto4Key
 };
+static const char *colorkey_blit_names[] = {
+    NULL, "BlitBto1Key", "BlitBto2Key", "BlitBto3Key", "BlitBto4Key"
+};
 
 SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int blit_index)
 {
@@ -455,16 +461,18 @@ SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int blit_index)
 	}
 	switch(blit_index) {
 	case 0:			/* copy */
-	    return bitmap_blit[which];
+	    return SDL_BLIT_NAMED(surface, bitmap_blit[which],
+	                          bitmap_blit_names[which]);
 
 	case 1:			/* colorkey */
-	    return colorkey_blit[which];
+	    return SDL_BLIT_NAMED(surface, colorkey_blit[which],
+	                          colorkey_blit_names[which]);
 
 	case 2:			/* alpha */
-	    return which >= 2 ? BlitBtoNAlpha : NULL;
+	    return which >= 2 ? SDL_BLIT_SELECT(surface, BlitBtoNAlpha) : NULL;
 
 	case 4:			/* alpha + colorkey */
-	    return which >= 2 ? BlitBtoNAlphaKey : NULL;
+	    return which >= 2 ? SDL_BLIT_SELECT(surface, BlitBtoNAlphaKey) : NULL;
 	}
 	return NULL;
 }
@@ -879,27 +879,28 @@ static void ConvertAltivec32to32_prefetch(SDL_BlitInfo *info)
 
 static enum blit_features GetBlitFeatures( void )
 {
-    static enum blit_features features = -1;
-    if (features == (enum blit_features) -1) {
-        /* Provide an override for testing .. */
-        char *override = SDL_getenv("SDL_ALTIVEC_BLIT_FEATURES");
-        if (override) {
-            unsigned int features_as_uint = 0;
-            SDL_sscanf(override, "%u", &features_as_uint);
-            features = (enum blit_features) features_as_uint;
-        } else {
-            features = ( 0
-                /* Feature 1 is has-MMX */
-                | ((SDL_HasMMX()) ? BLIT_FEATURE_HAS_MMX : 0)
-                /* Feature 2 is has-AltiVec */
-                | ((SDL_HasAltiVec()) ? BLIT_FEATURE_HAS_ALTIVEC : 0)
-                /* Feature 4 is dont-use-prefetch */
-                /* !!!! FIXME: Check for G5 or later, not the cache size! Always prefetch on a G4. */
-                | ((GetL3CacheSize() == 0) ? BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH : 0)
-            );
-        }
+    /* The CPU features aren't cached here, so SDL_SetCPUFeatureMask()
+       applies to the blits chosen after it's called */
+    static int dont_prefetch = -1;
+    /* Provide an override for testing .. */
+    char *override = SDL_getenv("SDL_ALTIVEC_BLIT_FEATURES");
+    if (override) {
+        unsigned int features_as_uint = 0;
+        SDL_sscanf(override, "%u", &features_as_uint);
+        return (enum blit_features) features_as_uint;
     }
-    return features;
+    if (dont_prefetch < 0) {
+        /* !!!! FIXME: Check for G5 or later, not the cache size! Always prefetch on a G4. */
+        dont_prefetch = (GetL3CacheSize() == 0);
+    }
+    return ( 0
+        /* Feature 1 is has-MMX */
+        | ((SDL_HasMMX()) ? BLIT_FEATURE_HAS_MMX : 0)
+        /* Feature 2 is has-AltiVec */
+        | ((SDL_HasAltiVec()) ? BLIT_FEATURE_HAS_ALTIVEC : 0)
+        /* Feature 4 is dont-use-prefetch */
+        | (dont_prefetch ? BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH : 0)
+    );
 }
 #if __MWERKS__
 #pragma altivec_model off
@@ -3051,6 +3052,7 @@ struct blit_table {
 	enum blit_features blit_features;
 	void *aux_data;
 	SDL_loblit blitfunc;
+	const char *name;
 	enum { NO_ALPHA=1, SET_ALPHA=2, COPY_ALPHA=4 } alpha;
 };
 static const struct blit_table normal_blit_1[] = {
@@ -3060,145 +3062,145 @@ static const struct blit_table normal_blit_1[] = {
 static const struct blit_table normal_blit_2[] = {
 #if SDL_HERMES_BLITTERS
     { 0x0000F800,0x000007E0,0x0000001F, 2, 0x0000001F,0x000007E0,0x0000F800,
-      0, ConvertX86p16_16BGR565, ConvertX86, NO_ALPHA },
+      0, ConvertX86p16_16BGR565, ConvertX86, "ConvertX86p16_16BGR565", NO_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 2, 0x00007C00,0x000003E0,0x0000001F,
-      0, ConvertX86p16_16RGB555, ConvertX86, NO_ALPHA },
+      0, ConvertX86p16_16RGB555, ConvertX86, "ConvertX86p16_16RGB555", NO_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 2, 0x0000001F,0x000003E0,0x00007C00,
-      0, ConvertX86p16_16BGR555, ConvertX86, NO_ALPHA },
+      0, ConvertX86p16_16BGR555, ConvertX86, "ConvertX86p16_16BGR555", NO_ALPHA },
 #elif SDL_ALTIVEC_BLITTERS
     /* has-altivec */
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x00000000,0x00000000,0x00000000,
-      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB565_32Altivec, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB565_32Altivec, "Blit_RGB565_32Altivec", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x00007C00,0x000003E0,0x0000001F, 4, 0x00000000,0x00000000,0x00000000,
-      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB555_32Altivec, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB555_32Altivec, "Blit_RGB555_32Altivec", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
 #endif
 #if SDL_ARM_SIMD_BLITTERS
     { 0x00000F00,0x000000F0,0x0000000F, 4, 0x00FF0000,0x0000FF00,0x000000FF,
-      BLIT_FEATURE_HAS_ARM_SIMD, NULL, Blit_RGB444_RGB888ARMSIMD, NO_ALPHA | COPY_ALPHA },
+      BLIT_FEATURE_HAS_ARM_SIMD, NULL, Blit_RGB444_RGB888ARMSIMD, "Blit_RGB444_RGB888ARMSIMD", NO_ALPHA | COPY_ALPHA },
 #endif
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x00FF0000,0x0000FF00,0x000000FF,
-      0, NULL, Blit_RGB565_ARGB8888, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      0, NULL, Blit_RGB565_ARGB8888, "Blit_RGB565_ARGB8888", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x000000FF,0x0000FF00,0x00FF0000,
-      0, NULL, Blit_RGB565_ABGR8888, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      0, NULL, Blit_RGB565_ABGR8888, "Blit_RGB565_ABGR8888", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0xFF000000,0x00FF0000,0x0000FF00,
-      0, NULL, Blit_RGB565_RGBA8888, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      0, NULL, Blit_RGB565_RGBA8888, "Blit_RGB565_RGBA8888", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x0000FF00,0x00FF0000,0xFF000000,
-      0, NULL, Blit_RGB565_BGRA8888, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      0, NULL, Blit_RGB565_BGRA8888, "Blit_RGB565_BGRA8888", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
 
     /* Default for 16-bit RGB source, used if no other blitter matches */
-    { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, 0 }
+    { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, "BlitNtoN", 0 }
 };
 static const struct blit_table normal_blit_3[] = {
     /* 3->4 with same rgb triplet */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 4, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__same_rgb,
+     0, NULL, Blit_3or4_to_3or4__same_rgb, "Blit_3or4_to_3or4__same_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 4, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__same_rgb,
+     0, NULL, Blit_3or4_to_3or4__same_rgb, "Blit_3or4_to_3or4__same_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA},
     /* 3->4 with inversed rgb triplet */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 4, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb,
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 4, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb,
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA},
     /* 3->3 to switch RGB 24 <-> BGR 24 */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 3, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb, NO_ALPHA },
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb", NO_ALPHA },
     {0x00FF0000, 0x0000FF00, 0x000000FF, 3, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb, NO_ALPHA },
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb", NO_ALPHA },
 	/* Default for 24-bit RGB source, never optimized */
-    { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, 0 }
+    { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, "BlitNtoN", 0 }
 };
 static const struct blit_table normal_blit_4[] = {
 #if SDL_HERMES_BLITTERS
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000F800,0x000007E0,0x0000001F,
-      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16RGB565, ConvertMMX, NO_ALPHA },
+      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16RGB565, ConvertMMX, "ConvertMMXpII32_16RGB565", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000F800,0x000007E0,0x0000001F,
-      0, ConvertX86p32_16RGB565, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_16RGB565, ConvertX86, "ConvertX86p32_16RGB565", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000001F,0x000007E0,0x0000F800,
-      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16BGR565, ConvertMMX, NO_ALPHA },
+      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16BGR565, ConvertMMX, "ConvertMMXpII32_16BGR565", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000001F,0x000007E0,0x0000F800,
-      0, ConvertX86p32_16BGR565, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_16BGR565, ConvertX86, "ConvertX86p32_16BGR565", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x00007C00,0x000003E0,0x0000001F,
-      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16RGB555, ConvertMMX, NO_ALPHA },
+      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16RGB555, ConvertMMX, "ConvertMMXpII32_16RGB555", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x00007C00,0x000003E0,0x0000001F,
-      0, ConvertX86p32_16RGB555, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_16RGB555, ConvertX86, "ConvertX86p32_16RGB555", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000001F,0x000003E0,0x00007C00,
-      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16BGR555, ConvertMMX, NO_ALPHA },
+      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_16BGR555, ConvertMMX, "ConvertMMXpII32_16BGR555", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000001F,0x000003E0,0x00007C00,
-      0, ConvertX86p32_16BGR555, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_16BGR555, ConvertX86, "ConvertX86p32_16BGR555", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 3, 0x00FF0000,0x0000FF00,0x000000FF,
-      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_24RGB888, ConvertMMX, NO_ALPHA },
+      BLIT_FEATURE_HAS_MMX, ConvertMMXpII32_24RGB888, ConvertMMX, "ConvertMMXpII32_24RGB888", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 3, 0x00FF0000,0x0000FF00,0x000000FF,
-      0, ConvertX86p32_24RGB888, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_24RGB888, ConvertX86, "ConvertX86p32_24RGB888", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 3, 0x000000FF,0x0000FF00,0x00FF0000,
-      0, ConvertX86p32_24BGR888, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_24BGR888, ConvertX86, "ConvertX86p32_24BGR888", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 4, 0x000000FF,0x0000FF00,0x00FF0000,
-      0, ConvertX86p32_32BGR888, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_32BGR888, ConvertX86, "ConvertX86p32_32BGR888", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 4, 0xFF000000,0x00FF0000,0x0000FF00,
-      0, ConvertX86p32_32RGBA888, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_32RGBA888, ConvertX86, "ConvertX86p32_32RGBA888", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 4, 0x0000FF00,0x00FF0000,0xFF000000,
-      0, ConvertX86p32_32BGRA888, ConvertX86, NO_ALPHA },
+      0, ConvertX86p32_32BGRA888, ConvertX86, "ConvertX86p32_32BGRA888", NO_ALPHA },
 #else
 #if SDL_ALTIVEC_BLITTERS
     /* has-altivec | dont-use-prefetch */
     { 0x00000000,0x00000000,0x00000000, 4, 0x00000000,0x00000000,0x00000000,
-      BLIT_FEATURE_HAS_ALTIVEC | BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH, NULL, ConvertAltivec32to32_noprefetch, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      BLIT_FEATURE_HAS_ALTIVEC | BLIT_FEATURE_ALTIVEC_DONT_USE_PREFETCH, NULL, ConvertAltivec32to32_noprefetch, "ConvertAltivec32to32_noprefetch", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     /* has-altivec */
     { 0x00000000,0x00000000,0x00000000, 4, 0x00000000,0x00000000,0x00000000,
-      BLIT_FEATURE_HAS_ALTIVEC, NULL, ConvertAltivec32to32_prefetch, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+      BLIT_FEATURE_HAS_ALTIVEC, NULL, ConvertAltivec32to32_prefetch, "ConvertAltivec32to32_prefetch", NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     /* has-altivec */
     { 0x00000000,0x00000000,0x00000000, 2, 0x0000F800,0x000007E0,0x0000001F,
-      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB888_RGB565Altivec, NO_ALPHA },
+      BLIT_FEATURE_HAS_ALTIVEC, NULL, Blit_RGB888_RGB565Altivec, "Blit_RGB888_RGB565Altivec", NO_ALPHA },
 #endif
 #if SDL_ARM_SIMD_BLITTERS
     { 0x000000FF,0x0000FF00,0x00FF0000, 4, 0x00FF0000,0x0000FF00,0x000000FF,
-      BLIT_FEATURE_HAS_ARM_SIMD, NULL, Blit_BGR888_RGB888ARMSIMD, NO_ALPHA | COPY_ALPHA },
+      BLIT_FEATURE_HAS_ARM_SIMD, NULL, Blit_BGR888_RGB888ARMSIMD, "Blit_BGR888_RGB888ARMSIMD", NO_ALPHA | COPY_ALPHA },
 #endif
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000F800,0x000007E0,0x0000001F,
-      0, NULL, Blit_RGB888_RGB565, NO_ALPHA },
+      0, NULL, Blit_RGB888_RGB565, "Blit_RGB888_RGB565", NO_ALPHA },
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x00007C00,0x000003E0,0x0000001F,
-      0, NULL, Blit_RGB888_RGB555, NO_ALPHA },
+      0, NULL, Blit_RGB888_RGB555, "Blit_RGB888_RGB555", NO_ALPHA },
 #endif
     /* 4->3 with same rgb triplet */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 3, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__same_rgb, NO_ALPHA | SET_ALPHA},
+     0, NULL, Blit_3or4_to_3or4__same_rgb, "Blit_3or4_to_3or4__same_rgb", NO_ALPHA | SET_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 3, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__same_rgb, NO_ALPHA | SET_ALPHA},
+     0, NULL, Blit_3or4_to_3or4__same_rgb, "Blit_3or4_to_3or4__same_rgb", NO_ALPHA | SET_ALPHA},
     /* 4->3 with inversed rgb triplet */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 3, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb, NO_ALPHA | SET_ALPHA},
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb", NO_ALPHA | SET_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 3, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb, NO_ALPHA | SET_ALPHA},
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb", NO_ALPHA | SET_ALPHA},
     /* 4->4 with inversed rgb triplet, and COPY_ALPHA to switch ABGR8888 <-> ARGB8888 */
     {0x000000FF, 0x0000FF00, 0x00FF0000, 4, 0x00FF0000, 0x0000FF00, 0x000000FF,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb,
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA | COPY_ALPHA},
     {0x00FF0000, 0x0000FF00, 0x000000FF, 4, 0x000000FF, 0x0000FF00, 0x00FF0000,
-     0, NULL, Blit_3or4_to_3or4__inversed_rgb,
+     0, NULL, Blit_3or4_to_3or4__inversed_rgb, "Blit_3or4_to_3or4__inversed_rgb",
 #if HAVE_FAST_WRITE_INT8
         NO_ALPHA |
 #endif
         SET_ALPHA | COPY_ALPHA},
 	/* Default for 32-bit RGB source, used if no other blitter matches */
-	{ 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, 0 }
+	{ 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, "BlitNtoN", 0 }
 };
 static const struct blit_table *normal_blit[] = {
 	normal_blit_1, normal_blit_2, normal_blit_3, normal_blit_4
@@ -3238,20 +3240,20 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 
 	    if(srcfmt->BytesPerPixel == 2
 	       && surface->map->identity)
-		return Blit2to2Key;
+		return SDL_BLIT_SELECT(surface, Blit2to2Key);
 	    else if(dstfmt->BytesPerPixel == 1)
-		return BlitNto1Key;
+		return SDL_BLIT_SELECT(surface, BlitNto1Key);
 	    else {
 #if SDL_ALTIVEC_BLITTERS
         if((srcfmt->BytesPerPixel == 4) && (dstfmt->BytesPerPixel == 4) && SDL_HasAltiVec()) {
-            return Blit32to32KeyAltivec;
+            return SDL_BLIT_SELECT(surface, Blit32to32KeyAltivec);
         } else
 #endif
 
 		if(srcfmt->Amask && dstfmt->Amask)
-		    return BlitNtoNKeyCopyAlpha;
+		    return SDL_BLIT_SELECT(surface, BlitNtoNKeyCopyAlpha);
 		else
-		    return BlitNtoNKey;
+		    return SDL_BLIT_SELECT(surface, BlitNtoNKey);
 	    }
 	}
 
@@ -3263,17 +3265,18 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 		     (srcfmt->Gmask == 0x0000FF00) &&
 		     (srcfmt->Bmask == 0x000000FF) ) {
 			if ( surface->map->table ) {
-				blitfun = Blit_RGB888_index8_map;
+				blitfun = SDL_BLIT_SELECT(surface, Blit_RGB888_index8_map);
 			} else {
 #if SDL_HERMES_BLITTERS
 				sdata->aux_data = ConvertX86p32_8RGB332;
-				blitfun = ConvertX86;
+				blitfun = SDL_BLIT_NAMED(surface, ConvertX86,
+				                         "ConvertX86p32_8RGB332");
 #else
-				blitfun = Blit_RGB888_index8;
+				blitfun = SDL_BLIT_SELECT(surface, Blit_RGB888_index8);
 #endif
 			}
 		} else {
-			blitfun = BlitNto1;
+			blitfun = SDL_BLIT_SELECT(surface, BlitNto1);
 		}
 	} else {
 		/* Now the meat, choose the blitter we want */
@@ -3294,7 +3297,8 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 				break;
 		}
 		sdata->aux_data = table[which].aux_data;
-		blitfun = table[which].blitfunc;
+		blitfun = SDL_BLIT_NAMED(surface, table[which].blitfunc,
+		                         table[which].name);
 
 		if(blitfun == BlitNtoN) {  /* default C fallback catch-all. Slow! */
 			if ( srcfmt->BytesPerPixel == 4 && dstfmt->BytesPerPixel == 4 &&
@@ -3304,16 +3308,16 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 				if( a_need == COPY_ALPHA ) {
 				    if( srcfmt->Amask == dstfmt->Amask ) {
 				    /* Fastpath C fallback: 32bit RGBA<->RGBA blit with matching RGBA */
-					blitfun = Blit4to4CopyAlpha;
+					blitfun = SDL_BLIT_SELECT(surface, Blit4to4CopyAlpha);
 				    } else {
-					blitfun = BlitNtoNCopyAlpha;
+					blitfun = SDL_BLIT_SELECT(surface, BlitNtoNCopyAlpha);
 				    }
 				} else {
 				    /* Fastpath C fallback: 32bit RGB<->RGBA blit with matching RGB */
-				    blitfun = Blit4to4MaskAlpha;
+				    blitfun = SDL_BLIT_SELECT(surface, Blit4to4MaskAlpha);
 				}
 			} else if ( a_need == COPY_ALPHA ) {
-			    blitfun = BlitNtoNCopyAlpha;
+			    blitfun = SDL_BLIT_SELECT(surface, BlitNtoNCopyAlpha);
 			}
 		}
 	}
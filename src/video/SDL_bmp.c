@@ -30,11 +30,13 @@
    and save, and since PNG is so complex that it would bloat the library,
    BMP is a good alternative. 
 
-   This code currently supports Win32 DIBs in uncompressed 8 and 24 bpp.
+   This code currently supports Win32 DIBs in uncompressed 1, 4, 8, 16,
+   24 and 32 bpp, and RLE compressed 4 and 8 bpp.
 */
 
 #include "SDL_video.h"
 #include "SDL_endian.h"
+#include "SDL_pixels_c.h"
 
 /* Compression encodings for BMP files */
 #ifndef BI_RGB
@@ -45,20 +47,284 @@
 #endif
 
 
-SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
+/* Reverse the rows of a bottom-up image read in one go */
+static void FlipRows(SDL_Surface *surface)
+{
+	Uint8 *top, *bottom;
+	Uint8 row[1024];
+	int pitch, len, ofs;
+
+	pitch = surface->pitch;
+	top = (Uint8 *)surface->pixels;
+	bottom = top + (surface->h-1)*pitch;
+	while ( top < bottom ) {
+		for ( ofs = 0; ofs < pitch; ofs += len ) {
+			len = pitch - ofs;
+			if ( len > sizeof(row) ) {
+				len = sizeof(row);
+			}
+			SDL_memcpy(row, top+ofs, len);
+			SDL_memcpy(top+ofs, bottom+ofs, len);
+			SDL_memcpy(bottom+ofs, row, len);
+		}
+		top += pitch;
+		bottom -= pitch;
+	}
+}
+
+/* Decode RLE8 or RLE4 data straight into an 8-bit bottom-up surface.
+   The compressed data is read in one go, or used in place when the
+   source is memory backed.
+ */
+static int ReadRLEPixels(SDL_Surface *surface, SDL_RWops *src, Uint32 size, int isRle8)
+{
+	const Uint8 *data, *here, *stop;
+	Uint8 *freeable = NULL;
+	Uint8 *bits, *top;
+	int x, memsize, pos;
+	Uint8 count, code, pixel;
+
+	data = (const Uint8 *)SDL_RWGetMemory(src, &memsize);
+	if ( data ) {
+		pos = SDL_RWtell(src);
+		if ( (size == 0) || (size > (Uint32)(memsize-pos)) ) {
+			size = (memsize-pos);
+		}
+		data += pos;
+		SDL_RWseek(src, size, RW_SEEK_CUR);
+	} else {
+		if ( size == 0 ) {
+			/* No image size, the data runs to the end of the file */
+			pos = SDL_RWtell(src);
+			memsize = SDL_RWseek(src, 0, RW_SEEK_END);
+			if ( (pos < 0) || (memsize < pos) ||
+			     (SDL_RWseek(src, pos, RW_SEEK_SET) < 0) ) {
+				SDL_Error(SDL_EFSEEK);
+				return(-1);
+			}
+			size = (memsize-pos);
+		}
+		freeable = (Uint8 *)SDL_malloc(size ? size : 1);
+		if ( freeable == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		size = SDL_RWread(src, freeable, 1, size);
+		if ( (int)size < 0 ) {
+			size = 0;
+		}
+		data = freeable;
+	}
+	here = data;
+	stop = data + size;
+
+	/* Pixels not covered by the data are left as color 0 */
+	SDL_memset(surface->pixels, 0, surface->h*surface->pitch);
+	top = (Uint8 *)surface->pixels;
+	bits = top + (surface->h-1)*surface->pitch;
+	x = 0;
+
+#define RLE_PIXEL(p) \
+	do { if ( x < surface->w ) bits[x] = (p); ++x; } while (0)
+
+	while ( here+2 <= stop ) {
+		count = *here++;
+		code = *here++;
+		if ( count ) {
+			/* Encoded mode, a run of one or two alternating colors */
+			if ( bits < top ) {
+				continue;
+			}
+			if ( isRle8 ) {
+				if ( x < surface->w ) {
+					int len = surface->w - x;
+					if ( len > count ) {
+						len = count;
+					}
+					SDL_memset(bits+x, code, len);
+				}
+				x += count;
+			} else {
+				while ( count ) {
+					RLE_PIXEL(code >> 4);
+					if ( !--count ) break;
+					RLE_PIXEL(code & 0x0F);
+					--count;
+				}
+			}
+			continue;
+		}
+		switch (code) {
+			case 0:		/* End of line */
+				x = 0;
+				bits -= surface->pitch;
+				break;
+			case 1:		/* End of bitmap */
+				here = stop;
+				break;
+			case 2:		/* Delta */
+				if ( here+2 > stop ) {
+					here = stop;
+					break;
+				}
+				x += *here++;
+				bits -= (*here++) * surface->pitch;
+				break;
+			default:	/* Absolute mode, padded to 16 bits */
+				count = code;
+				if ( isRle8 ) {
+					if ( here+count > stop ) {
+						count = (Uint8)(stop-here);
+					}
+					for ( ; count; --count ) {
+						pixel = *here++;
+						if ( bits >= top ) {
+							RLE_PIXEL(pixel);
+						}
+					}
+					if ( here < stop ) {
+						here += (code & 1);
+					}
+				} else {
+					while ( count && (here < stop) ) {
+						pixel = *here++;
+						if ( bits >= top ) {
+							RLE_PIXEL(pixel >> 4);
+						}
+						if ( !--count ) break;
+						if ( bits >= top ) {
+							RLE_PIXEL(pixel & 0x0F);
+						}
+						--count;
+					}
+					if ( here < stop ) {
+						here += (((code+1)>>1) & 1);
+					}
+				}
+				break;
+		}
+	}
+#undef RLE_PIXEL
+
+	if ( freeable ) {
+		SDL_free(freeable);
+	}
+	return(0);
+}
+
+/* Decode uncompressed 8, 24 or 32 bpp rows straight into a 16 or 32 bpp
+   truecolor surface, giving the same pixels as SDL_ConvertSurface().
+   1 and 4 bpp rows are expanded on the fly, 'srcfmt' describes the
+   little endian 24 and 32 bpp pixels.
+ */
+static int ReadConvertedPixels(SDL_Surface *surface, SDL_RWops *src,
+			int bitCount, int expand, SDL_bool topDown,
+			const SDL_PixelFormat *srcfmt,
+			const SDL_Color *colors, int ncolors)
+{
+	SDL_PixelFormat *fmt = surface->format;
+	Uint32 map[256];
+	Uint32 pixel, value;
+	Uint8 *row, *bits, *p;
+	int bmpPitch, x, y;
+	int status = 0;
+
+#define MAP_RGB(r, g, b) \
+	((((Uint32)(r) >> fmt->Rloss) << fmt->Rshift) | \
+	 (((Uint32)(g) >> fmt->Gloss) << fmt->Gshift) | \
+	 (((Uint32)(b) >> fmt->Bloss) << fmt->Bshift) | fmt->Amask)
+
+	if ( bitCount == 8 ) {
+		for ( x = 0; x < ncolors; ++x ) {
+			map[x] = MAP_RGB(colors[x].r, colors[x].g, colors[x].b);
+		}
+	}
+	bmpPitch = ((surface->w * (expand ? expand : bitCount) + 31) / 32) * 4;
+	row = (Uint8 *)SDL_malloc(bmpPitch);
+	if ( row == NULL ) {
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	for ( y = 0; y < surface->h; ++y ) {
+		if ( SDL_RWread(src, row, bmpPitch, 1) != 1 ) {
+			SDL_Error(SDL_EFREAD);
+			status = -1;
+			break;
+		}
+		bits = (Uint8 *)surface->pixels +
+			(topDown ? y : (surface->h-1-y)) * surface->pitch;
+		p = row;
+		for ( x = 0; x < surface->w; ++x ) {
+			switch (bitCount) {
+				case 8:
+					if ( expand ) {
+						value = row[(x*expand)/8];
+						value >>= 8-expand-((x*expand)%8);
+						value &= (1<<expand)-1;
+					} else {
+						value = *p++;
+					}
+					if ( value >= (Uint32)ncolors ) {
+						SDL_SetError(
+			"A BMP image contains a pixel with a color out of the palette");
+						status = -1;
+						goto done;
+					}
+					pixel = map[value];
+					break;
+				case 24:
+					value = p[0] | (p[1] << 8) | ((Uint32)p[2] << 16);
+					p += 3;
+					pixel = MAP_RGB(
+					  ((value & srcfmt->Rmask) >> srcfmt->Rshift) << srcfmt->Rloss,
+					  ((value & srcfmt->Gmask) >> srcfmt->Gshift) << srcfmt->Gloss,
+					  ((value & srcfmt->Bmask) >> srcfmt->Bshift) << srcfmt->Bloss);
+					break;
+				default:
+					value = p[0] | (p[1] << 8) |
+					        ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+					p += 4;
+					pixel = MAP_RGB(
+					  ((value & srcfmt->Rmask) >> srcfmt->Rshift) << srcfmt->Rloss,
+					  ((value & srcfmt->Gmask) >> srcfmt->Gshift) << srcfmt->Gloss,
+					  ((value & srcfmt->Bmask) >> srcfmt->Bshift) << srcfmt->Bloss);
+					break;
+			}
+			if ( fmt->BytesPerPixel == 2 ) {
+				((Uint16 *)bits)[x] = (Uint16)pixel;
+			} else {
+				((Uint32 *)bits)[x] = pixel;
+			}
+		}
+	}
+done:
+#undef MAP_RGB
+	SDL_free(row);
+	return(status);
+}
+
+/* Load a BMP image, decoding it straight into 'fmt' when it is given and
+   the image is an uncompressed 1, 4, 8, 24 or 32 bpp one.  Other images
+   are returned in their own format.
+ */
+static SDL_Surface *LoadBMP(SDL_RWops *src, int freesrc,
+					const SDL_PixelFormat *fmt)
 {
 	SDL_bool was_error;
 	long fp_offset = 0;
 	int bmpPitch;
-	int i, pad;
+	int i;
 	SDL_Surface *surface;
 	Uint32 Rmask;
 	Uint32 Gmask;
 	Uint32 Bmask;
 	SDL_Palette *palette;
+	SDL_Color colors[256];
+	SDL_PixelFormat *srcfmt;
 	Uint8 *bits;
 	Uint8 *top, *end;
 	SDL_bool topDown;
+	SDL_bool direct;
 	int ExpandBMP;
 
 	/* The Win32 BMP file header (14 bytes) */
@@ -83,6 +349,7 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 
 	/* Make sure we are passed a valid data source */
 	surface = NULL;
+	srcfmt = NULL;
 	was_error = SDL_FALSE;
 	if ( src == NULL ) {
 		was_error = SDL_TRUE;
@@ -182,7 +449,7 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 			break;
 	}
 
-	/* We don't support any BMP compression right now */
+	/* Read the masks, RLE compression is decoded with the pixels */
 	Rmask = Gmask = Bmask = 0;
 	switch (biCompression) {
 		case BI_RGB:
@@ -219,24 +486,70 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 			switch (biBitCount) {
 				case 15:
 				case 16:
-				case 32:
-					Rmask = SDL_ReadLE32(src);
-					Gmask = SDL_ReadLE32(src);
-					Bmask = SDL_ReadLE32(src);
+				case 32: {
+					Uint32 masks[3];
+					if ( SDL_ReadLE32Array(src, masks, 3) != 3 ) {
+						SDL_Error(SDL_EFREAD);
+						was_error = SDL_TRUE;
+						goto done;
+					}
+					Rmask = masks[0];
+					Gmask = masks[1];
+					Bmask = masks[2];
 					break;
+				}
 				default:
 					break;
 			}
 			break;
+		case BI_RLE8:
+		case BI_RLE4:
+			if ( (biBitCount != 8) || topDown ||
+			     (ExpandBMP != ((biCompression == BI_RLE4) ? 4 : 0)) ) {
+				SDL_SetError("Invalid RLE compressed BMP file");
+				was_error = SDL_TRUE;
+				goto done;
+			}
+			break;
 		default:
 			SDL_SetError("Compressed BMP files not supported");
 			was_error = SDL_TRUE;
 			goto done;
 	}
 
+	/* Uncompressed 8, 24 and 32 bpp pixels with up to 8 bits per channel
+	   can be converted to the requested format as they are read. */
+	direct = (fmt != NULL) &&
+		((biCompression == BI_RGB) || (biCompression == BI_BITFIELDS)) &&
+		((biBitCount == 8) || (biBitCount == 24) || (biBitCount == 32));
+	if ( direct && (biBitCount != 8) ) {
+		if ( biBitCount == 24 ) {
+			/* The pixels are read byte by byte, BGR ordered */
+			Rmask = 0x00FF0000;
+			Gmask = 0x0000FF00;
+			Bmask = 0x000000FF;
+		}
+		srcfmt = SDL_AllocFormat(biBitCount, Rmask, Gmask, Bmask, 0);
+		if ( srcfmt == NULL ) {
+			was_error = SDL_TRUE;
+			goto done;
+		}
+		if ( (srcfmt->Rloss > 8) || (srcfmt->Gloss > 8) ||
+		     (srcfmt->Bloss > 8) ) {
+			/* Channels wider than 8 bits, converted the usual way */
+			direct = SDL_FALSE;
+		}
+	}
+
 	/* Create a compatible surface, note that the colors are RGB ordered */
-	surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
-			biWidth, biHeight, biBitCount, Rmask, Gmask, Bmask, 0);
+	if ( direct ) {
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+				biWidth, biHeight, fmt->BitsPerPixel,
+				fmt->Rmask, fmt->Gmask, fmt->Bmask, fmt->Amask);
+	} else {
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+				biWidth, biHeight, biBitCount, Rmask, Gmask, Bmask, 0);
+	}
 	if ( surface == NULL ) {
 		was_error = SDL_TRUE;
 		goto done;
@@ -244,30 +557,41 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 
 	/* Load the palette, if any */
 	palette = (surface->format)->palette;
-	if ( palette ) {
+	if ( biBitCount == 8 ) {
 		if ( biClrUsed == 0 ) {
-			biClrUsed = 1 << biBitCount;
+			/* A full color table for the depth in the file */
+			biClrUsed = 1 << (ExpandBMP ? ExpandBMP : biBitCount);
 		} else if ( biClrUsed > (1 << biBitCount) ) {
 			SDL_SetError("BMP file has an invalid number of colors");
 			was_error = SDL_TRUE;
 			goto done;
 		}
-		if ( biSize == 12 ) {
-			for ( i = 0; i < (int)biClrUsed; ++i ) {
-				SDL_RWread(src, &palette->colors[i].b, 1, 1);
-				SDL_RWread(src, &palette->colors[i].g, 1, 1);
-				SDL_RWread(src, &palette->colors[i].r, 1, 1);
-				palette->colors[i].unused = 0;
-			}	
-		} else {
+		{
+			/* Read the whole color table at once, BGR or BGRX */
+			Uint8 table[256*4];
+			int entry = (biSize == 12) ? 3 : 4;
+			int count;
+
+			/* A short color table is tolerated, as it always
+			   was, the missing colors are black. */
+			count = SDL_RWread(src, table, entry, biClrUsed);
+			if ( count < 0 ) {
+				count = 0;
+			}
+			SDL_memset(&table[count*entry], 0,
+					(biClrUsed-count)*entry);
 			for ( i = 0; i < (int)biClrUsed; ++i ) {
-				SDL_RWread(src, &palette->colors[i].b, 1, 1);
-				SDL_RWread(src, &palette->colors[i].g, 1, 1);
-				SDL_RWread(src, &palette->colors[i].r, 1, 1);
-				SDL_RWread(src, &palette->colors[i].unused, 1, 1);
-			}	
+				colors[i].b = table[i*entry+0];
+				colors[i].g = table[i*entry+1];
+				colors[i].r = table[i*entry+2];
+				colors[i].unused = (entry == 4) ? table[i*entry+3] : 0;
+			}
+		}
+		if ( palette ) {
+			SDL_memcpy(palette->colors, colors,
+					biClrUsed*sizeof(*colors));
+			palette->ncolors = biClrUsed;
 		}
-		palette->ncolors = biClrUsed;
 	}
 
 	/* Read the surface pixels.  Note that the bmp image is upside down */
@@ -278,71 +602,34 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 	}
 	top = (Uint8 *)surface->pixels;
 	end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
-	switch (ExpandBMP) {
-		case 1:
-			bmpPitch = (biWidth + 7) >> 3;
-			pad  = (((bmpPitch)%4) ? (4-((bmpPitch)%4)) : 0);
-			break;
-		case 4:
-			bmpPitch = (biWidth + 1) >> 1;
-			pad  = (((bmpPitch)%4) ? (4-((bmpPitch)%4)) : 0);
-			break;
-		default:
-			pad  = ((surface->pitch%4) ?
-					(4-(surface->pitch%4)) : 0);
-			break;
-	}
-	if ( topDown ) {
-		bits = top;
-	} else {
-		bits = end - surface->pitch;
-	}
-	while ( bits >= top && bits < end ) {
-		switch (ExpandBMP) {
-			case 1:
-			case 4: {
-			Uint8 pixel = 0;
-			int   shift = (8-ExpandBMP);
-			for ( i=0; i<surface->w; ++i ) {
-				if ( i%(8/ExpandBMP) == 0 ) {
-					if ( !SDL_RWread(src, &pixel, 1, 1) ) {
-						SDL_SetError(
-					"Error reading from BMP");
-						was_error = SDL_TRUE;
-						goto done;
-					}
-				}
-				*(bits+i) = (pixel>>shift);
-				pixel <<= ExpandBMP;
-				if ( bits[i] >= biClrUsed ) {
-					SDL_SetError(
-						"A BMP image contains a pixel with a color out of the palette");
-					was_error = SDL_TRUE;
-					goto done;
-				}
-			} }
-			break;
-
-			default:
-			if ( SDL_RWread(src, bits, 1, surface->pitch)
-							 != surface->pitch ) {
-				SDL_Error(SDL_EFREAD);
-				was_error = SDL_TRUE;
-				goto done;
-			}
-			if ( 8 == biBitCount && palette && biClrUsed < (1 << biBitCount ) ) {
-				for ( i=0; i<surface->w; ++i ) {
-					if ( bits[i] >= biClrUsed ) {
-						SDL_SetError(
-							"A BMP image contains a pixel with a color out of the palette");
-						was_error = SDL_TRUE;
-						goto done;
-					}
-				}
-			}
+	if ( (biCompression == BI_RLE8) || (biCompression == BI_RLE4) ) {
+		if ( ReadRLEPixels(surface, src, biSizeImage,
+				(biCompression == BI_RLE8)) < 0 ) {
+			was_error = SDL_TRUE;
+			goto done;
+		}
+	} else if ( direct ) {
+		if ( ReadConvertedPixels(surface, src, biBitCount, ExpandBMP,
+				topDown, srcfmt, colors, biClrUsed) < 0 ) {
+			was_error = SDL_TRUE;
+			goto done;
+		}
+	} else if ( !ExpandBMP ) {
+		/* The BMP rows are padded to 4 bytes, just like the surface
+		   pitch, so the whole image can be read at once. */
+		if ( SDL_RWread(src, top, surface->pitch, surface->h)
+							 != surface->h ) {
+			SDL_Error(SDL_EFREAD);
+			was_error = SDL_TRUE;
+			goto done;
+		}
+		if ( !topDown ) {
+			FlipRows(surface);
+		}
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-			/* Byte-swap the pixels if needed. Note that the 24bpp
-			   case has already been taken care of above. */
+		/* Byte-swap the pixels if needed. Note that the 24bpp
+		   case has already been taken care of above. */
+		for ( bits = top; bits < end; bits += surface->pitch ) {
 			switch(biBitCount) {
 				case 15:
 				case 16: {
@@ -359,23 +646,67 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 					break;
 				}
 			}
-#endif
-			break;
 		}
-		/* Skip padding bytes, ugh */
-		if ( pad ) {
-			Uint8 padbyte;
-			for ( i=0; i<pad; ++i ) {
-				SDL_RWread(src, &padbyte, 1, 1);
-			}
+#endif
+	} else {
+		/* Expand 1 and 4 bit rows, reading each row at once */
+		Uint8 *row;
+
+		bmpPitch = ((biWidth * ExpandBMP + 31) / 32) * 4;
+		row = (Uint8 *)SDL_malloc(bmpPitch);
+		if ( row == NULL ) {
+			SDL_OutOfMemory();
+			was_error = SDL_TRUE;
+			goto done;
 		}
 		if ( topDown ) {
-			bits += surface->pitch;
+			bits = top;
 		} else {
-			bits -= surface->pitch;
+			bits = end - surface->pitch;
+		}
+		while ( bits >= top && bits < end ) {
+			Uint8 pixel = 0;
+			int   shift = (8-ExpandBMP);
+
+			if ( SDL_RWread(src, row, bmpPitch, 1) != 1 ) {
+				SDL_SetError("Error reading from BMP");
+				SDL_free(row);
+				was_error = SDL_TRUE;
+				goto done;
+			}
+			for ( i=0; i<surface->w; ++i ) {
+				if ( i%(8/ExpandBMP) == 0 ) {
+					pixel = row[i/(8/ExpandBMP)];
+				}
+				*(bits+i) = (pixel>>shift);
+				pixel <<= ExpandBMP;
+			}
+			if ( topDown ) {
+				bits += surface->pitch;
+			} else {
+				bits -= surface->pitch;
+			}
+		}
+		SDL_free(row);
+	}
+
+	/* Make sure all the pixels are in the palette */
+	if ( palette && biClrUsed < (1U << biBitCount) ) {
+		for ( bits = top; bits < end; bits += surface->pitch ) {
+			for ( i=0; i<surface->w; ++i ) {
+				if ( bits[i] >= biClrUsed ) {
+					SDL_SetError(
+						"A BMP image contains a pixel with a color out of the palette");
+					was_error = SDL_TRUE;
+					goto done;
+				}
+			}
 		}
 	}
 done:
+	if ( srcfmt ) {
+		SDL_FreeFormat(srcfmt);
+	}
 	if ( was_error ) {
 		if ( src ) {
 			SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -391,6 +722,71 @@ done:
 	return(surface);
 }
 
+SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
+{
+	return(LoadBMP(src, freesrc, NULL));
+}
+
+SDL_Surface * SDL_LoadBMPFormat_RW (SDL_RWops *src, int freesrc,
+				const SDL_PixelFormat *fmt, Uint32 flags)
+{
+	SDL_Surface *video;
+	SDL_Surface *surface;
+	SDL_Surface *converted;
+	const SDL_PixelFormat *direct;
+
+	video = NULL;
+	if ( fmt == NULL ) {
+		video = SDL_GetVideoSurface();
+		if ( video == NULL ) {
+			SDL_SetError("No video mode has been set");
+			if ( freesrc && src ) {
+				SDL_RWclose(src);
+			}
+			return(NULL);
+		}
+		/* SDL_DisplayFormat() makes a software surface unless
+		   hardware blits are accelerated */
+		if ( !((video->flags & SDL_HWSURFACE) &&
+		       SDL_GetVideoInfo()->blit_hw) ) {
+			fmt = video->format;
+			flags = SDL_SWSURFACE;
+		}
+	}
+
+	/* Rows are only decoded into 16 and 32 bpp software surfaces */
+	direct = NULL;
+	if ( fmt && !fmt->palette &&
+	     ((fmt->BytesPerPixel == 2) || (fmt->BytesPerPixel == 4)) &&
+	     ((flags & ~SDL_SWSURFACE) == 0) ) {
+		direct = fmt;
+	}
+	surface = LoadBMP(src, freesrc, direct);
+	if ( surface == NULL ) {
+		return(NULL);
+	}
+	if ( fmt == NULL ) {
+		converted = SDL_DisplayFormat(surface);
+		SDL_FreeSurface(surface);
+		return(converted);
+	}
+
+	/* Truecolor pixels that are already in the requested format are
+	   returned as loaded, without a second copy of the image. */
+	if ( !surface->format->palette && !fmt->palette &&
+	     (surface->format->BitsPerPixel == fmt->BitsPerPixel) &&
+	     (surface->format->Rmask == fmt->Rmask) &&
+	     (surface->format->Gmask == fmt->Gmask) &&
+	     (surface->format->Bmask == fmt->Bmask) &&
+	     (surface->format->Amask == fmt->Amask) &&
+	     ((flags & ~SDL_SWSURFACE) == 0) ) {
+		return(surface);
+	}
+	converted = SDL_ConvertSurface(surface, (SDL_PixelFormat *)fmt, flags);
+	SDL_FreeSurface(surface);
+	return(converted);
+}
+
 int SDL_SaveBMP_RW (SDL_Surface *saveme, SDL_RWops *dst, int freedst)
 {
 	long fp_offset;
@@ -40,6 +40,12 @@ SDL_Cursor *SDL_cursor = NULL;
 static SDL_Cursor *SDL_defcursor = NULL;
 SDL_mutex *SDL_cursorlock = NULL;
 
+/* Set when save[0] must be converted from save[1] before it is used */
+static int SDL_cursorsave_stale = 0;
+
+/* Bumped on video mode changes, to drop the converted colour cursors */
+static int SDL_cursorgeneration = 0;
+
 /* Public functions */
 void SDL_CursorQuit(void)
 {
@@ -140,6 +146,7 @@ SDL_Cursor * SDL_CreateCursor (Uint8 *data, Uint8 *mask,
 	cursor->save[0] = (Uint8 *)SDL_malloc(savelen*2);
 	cursor->save[1] = cursor->save[0] + savelen;
 	cursor->wm_cursor = NULL;
+	cursor->color = NULL;
 	if ( ! cursor->data || ! cursor->save[0] ) {
 		SDL_FreeCursor(cursor);
 		SDL_OutOfMemory();
@@ -161,6 +168,128 @@ SDL_Cursor * SDL_CreateCursor (Uint8 *data, Uint8 *mask,
 	return(cursor);
 }
 
+SDL_Cursor * SDL_CreateColorCursor (SDL_Surface *surface, int hot_x, int hot_y)
+{
+	SDL_PixelFormat *format;
+	SDL_Cursor *cursor;
+	int w, h, savelen;
+
+	if ( surface == NULL ) {
+		SDL_SetError("Passed a NULL cursor surface");
+		return(NULL);
+	}
+	w = surface->w;
+	h = surface->h;
+
+	/* Sanity check the hot spot */
+	if ( (hot_x < 0) || (hot_y < 0) || (hot_x >= w) || (hot_y >= h) ) {
+		SDL_SetError("Cursor hot spot doesn't lie within cursor");
+		return(NULL);
+	}
+
+	/* Allocate memory for the cursor */
+	cursor = (SDL_Cursor *)SDL_malloc(sizeof *cursor);
+	if ( cursor == NULL ) {
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	SDL_memset(cursor, 0, sizeof *cursor);
+	savelen = (w*4)*h;
+	cursor->area.w = w;
+	cursor->area.h = h;
+	cursor->hot_x = hot_x;
+	cursor->hot_y = hot_y;
+	cursor->save[0] = (Uint8 *)SDL_malloc(savelen*2);
+	cursor->color = (SDL_ColorCursor *)SDL_malloc(sizeof *cursor->color);
+	if ( ! cursor->save[0] || ! cursor->color ) {
+		SDL_FreeCursor(cursor);
+		SDL_OutOfMemory();
+		return(NULL);
+	}
+	cursor->save[1] = cursor->save[0] + savelen;
+	SDL_memset(cursor->save[0], 0, savelen*2);
+	SDL_memset(cursor->color, 0, sizeof *cursor->color);
+	cursor->color->generation = SDL_cursorgeneration;
+
+	/* Keep our own ARGB8888 copy of the image */
+	format = SDL_AllocFormat(32, 0x00ff0000, 0x0000ff00, 0x000000ff,
+								0xff000000);
+	if ( format == NULL ) {
+		SDL_FreeCursor(cursor);
+		return(NULL);
+	}
+	cursor->color->image = SDL_ConvertSurface(surface, format,
+							SDL_SWSURFACE);
+	SDL_FreeFormat(format);
+	if ( cursor->color->image == NULL ) {
+		SDL_FreeCursor(cursor);
+		return(NULL);
+	}
+	return(cursor);
+}
+
+/* Convert a colour cursor image for blending onto a screen surface.
+   This picks the same alpha formats as SDL_DisplayFormatAlpha(), which
+   have fast blitters, and RLE encodes the result.
+ */
+static SDL_Surface *SDL_ConvertCursorColor(SDL_Surface *image,
+						SDL_PixelFormat *vf)
+{
+	SDL_PixelFormat *format;
+	SDL_Surface *converted;
+	Uint32 amask = 0xff000000;
+	Uint32 rmask = 0x00ff0000;
+	Uint32 gmask = 0x0000ff00;
+	Uint32 bmask = 0x000000ff;
+
+	switch(vf->BytesPerPixel) {
+	    case 2:
+		if ( (vf->Rmask == 0x1f) &&
+		     (vf->Bmask == 0xf800 || vf->Bmask == 0x7c00)) {
+			rmask = 0xff;
+			bmask = 0xff0000;
+		}
+		break;
+
+	    case 3:
+	    case 4:
+		if ( (vf->Rmask == 0xff) && (vf->Bmask == 0xff0000) ) {
+			rmask = 0xff;
+			bmask = 0xff0000;
+		} else if ( vf->Rmask == 0xFF00 && (vf->Bmask == 0xFF000000) ) {
+			amask = 0x000000FF;
+			rmask = 0x0000FF00;
+			gmask = 0x00FF0000;
+			bmask = 0xFF000000;
+		}
+		break;
+	}
+	format = SDL_AllocFormat(32, rmask, gmask, bmask, amask);
+	if ( format == NULL ) {
+		return(NULL);
+	}
+	converted = SDL_ConvertSurface(image, format, SDL_SWSURFACE);
+	SDL_FreeFormat(format);
+	if ( converted ) {
+		SDL_SetAlpha(converted, SDL_SRCALPHA|SDL_RLEACCEL,
+						SDL_ALPHA_OPAQUE);
+	}
+	return(converted);
+}
+
+static void SDL_FlushCursorColor(SDL_ColorCursor *color)
+{
+	int i;
+
+	for ( i=0; i<2; ++i ) {
+		if ( color->screen[i] ) {
+			SDL_FreeSurface(color->screen[i]);
+			color->screen[i] = NULL;
+		}
+	}
+	color->generation = SDL_cursorgeneration;
+}
+
 /* SDL_SetCursor(NULL) can be used to force the cursor redraw,
    if this is desired for any reason.  This is used when setting
    the video mode and when the SDL window gains the mouse focus.
@@ -252,6 +381,13 @@ void SDL_FreeCursor (SDL_Cursor *cursor)
 			if ( cursor->save[0] ) {
 				SDL_free(cursor->save[0]);
 			}
+			if ( cursor->color ) {
+				SDL_FlushCursorColor(cursor->color);
+				if ( cursor->color->image ) {
+					SDL_FreeSurface(cursor->color->image);
+				}
+				SDL_free(cursor->color);
+			}
 			if ( video && cursor->wm_cursor ) {
 				if ( video->FreeWMCursor ) {
 					video->FreeWMCursor(this, cursor->wm_cursor);
@@ -558,6 +694,46 @@ static void SDL_DrawCursorSlow(SDL_Surface *screen, SDL_Rect *area)
 	}
 }
 
+/* Alpha blend a colour cursor over the screen, using the copy of the image
+   converted for it.  The blit map and RLE encoding of the copy are kept
+   between frames, so this is a single software blit.
+ */
+static void SDL_DrawCursorColor(SDL_Surface *screen, SDL_Rect *area)
+{
+	SDL_ColorCursor *color = SDL_cursor->color;
+	SDL_Surface *image;
+	SDL_Rect srcrect, dstrect;
+	int which;
+
+	if ( color->generation != SDL_cursorgeneration ) {
+		SDL_FlushCursorColor(color);
+	}
+	which = (screen == SDL_VideoSurface) ? 0 : 1;
+	if ( color->screen[which] == NULL ) {
+		color->screen[which] = SDL_ConvertCursorColor(color->image,
+							screen->format);
+		if ( color->screen[which] == NULL ) {
+			return;
+		}
+	}
+	image = color->screen[which];
+
+	/* The screen is locked, so don't let SDL_LowerBlit() pick a
+	   hardware blit */
+	if ( (image->map->dst != screen) ||
+	     (screen->format_version != image->map->format_version) ) {
+		if ( SDL_MapSurface(image, screen) < 0 ) {
+			return;
+		}
+	}
+	srcrect.x = area->x - SDL_cursor->area.x;
+	srcrect.y = area->y - SDL_cursor->area.y;
+	srcrect.w = area->w;
+	srcrect.h = area->h;
+	dstrect = *area;
+	image->map->sw_blit(image, &srcrect, screen, &dstrect);
+}
+
 /* This handles the ugly work of converting the saved cursor background from
    the pixel format of the shadow surface to that of the video surface.
    This is only necessary when blitting from a shadow surface of a different
@@ -611,6 +787,7 @@ void SDL_DrawCursorNoLock(SDL_Surface *screen)
 	  if ( (screen == SDL_VideoSurface) ||
 	          FORMAT_EQUAL(screen->format, SDL_VideoSurface->format) ) {
 		dst = SDL_cursor->save[0];
+		SDL_cursorsave_stale = 0;
 	  } else {
 		dst = SDL_cursor->save[1];
 	  }
@@ -628,6 +805,10 @@ void SDL_DrawCursorNoLock(SDL_Surface *screen)
 	}
 
 	/* Draw the mouse cursor */
+	if ( SDL_cursor->color ) {
+		SDL_DrawCursorColor(screen, &area);
+		return;
+	}
 	area.x -= SDL_cursor->area.x;
 	area.y -= SDL_cursor->area.y;
 	if ( (area.x == 0) && (area.w == SDL_cursor->area.w) ) {
@@ -687,6 +868,11 @@ void SDL_EraseCursorNoLock(SDL_Surface *screen)
 	  screenbpp = screen->format->BytesPerPixel;
 	  if ( (screen == SDL_VideoSurface) ||
 	          FORMAT_EQUAL(screen->format, SDL_VideoSurface->format) ) {
+		if ( SDL_cursorsave_stale ) {
+			SDL_ConvertCursorSave(SDL_ShadowSurface,
+							area.w, area.h);
+			SDL_cursorsave_stale = 0;
+		}
 		src = SDL_cursor->save[0];
 	  } else {
 		src = SDL_cursor->save[1];
@@ -703,9 +889,12 @@ void SDL_EraseCursorNoLock(SDL_Surface *screen)
 		  dst += screen->pitch;
 	  }
 
-	  /* Perform pixel conversion on cursor background */
+	  /* The background for the video surface is now in save[1], in the
+	     format of the shadow surface.  It's converted to save[0] when the
+	     cursor is erased from the video surface, rather than on every
+	     shadow update. */
 	  if ( src > SDL_cursor->save[1] ) {
-		SDL_ConvertCursorSave(screen, area.w, area.h);
+		SDL_cursorsave_stale = 1;
 	  }
 	}
 }
@@ -753,4 +942,6 @@ void SDL_ResetCursor(void)
 		SDL_cursor->area.y = 0;
 		SDL_memset(SDL_cursor->save[0], 0, savelen);
 	}
+	SDL_cursorsave_stale = 0;
+	++SDL_cursorgeneration;
 }
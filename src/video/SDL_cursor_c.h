@@ -63,6 +63,16 @@ extern void SDL_UnlockCursor(void);
 extern SDL_Cursor *SDL_cursor;
 extern void SDL_MouseRect(SDL_Rect *area);
 
+/* The image of a full colour cursor, with copies converted for drawing on
+   the video surface [0] and on the shadow surface [1].  The copies are
+   made when first drawn, and dropped on video mode changes.
+ */
+struct SDL_ColorCursor {
+	SDL_Surface *image;
+	SDL_Surface *screen[2];
+	int generation;
+};
+
 /* State definitions for the SDL cursor */
 #define CURSOR_VISIBLE	0x01
 #define CURSOR_USINGSW	0x10
@@ -441,6 +441,37 @@ int SDL_LowerBlit (SDL_Surface *src, SDL_Rect *srcrect,
 	return(do_blit(src, srcrect, dst, dstrect));
 }
 
+/*
+ * Return the name of the low level blit function used to blit between
+ * two surfaces, setting up the blit as SDL_LowerBlit() would.
+ */
+const char *SDL_GetBlitName (SDL_Surface *src, SDL_Surface *dst)
+{
+	/* Make sure the surfaces aren't NULL */
+	if ( ! src || ! dst ) {
+		SDL_SetError("SDL_GetBlitName: passed a NULL surface");
+		return(NULL);
+	}
+
+	/* Check to make sure the blit mapping is valid */
+	if ( (src->map->dst != dst) ||
+             (src->map->dst->format_version != src->map->format_version) ) {
+		if ( SDL_MapSurface(src, dst) < 0 ) {
+			return(NULL);
+		}
+	}
+
+	if ( (src->flags & SDL_HWACCEL) == SDL_HWACCEL ) {
+		return("hardware");
+	}
+	if ( src->map->sw_blit == SDL_RLEBlit ) {
+		return("SDL_RLEBlit");
+	}
+	if ( src->map->sw_blit == SDL_RLEAlphaBlit ) {
+		return("SDL_RLEAlphaBlit");
+	}
+	return(src->map->sw_data->name);
+}
 
 int SDL_UpperBlit (SDL_Surface *src, SDL_Rect *srcrect,
 		   SDL_Surface *dst, SDL_Rect *dstrect)
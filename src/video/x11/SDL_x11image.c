@@ -42,38 +42,143 @@ static int shm_errhandler(Display *d, XErrorEvent *e)
 		return(X_handler(d,e));
 }
 
-static void try_mitshm(_THIS, SDL_Surface *screen)
+static int attach_mitshm(_THIS, XShmSegmentInfo *info, int size)
 {
-	/* Dynamic X11 may not have SHM entry points on this box. */
-	if ((use_mitshm) && (!SDL_X11_HAVE_SHM))
-		use_mitshm = 0;
-
-	if(!use_mitshm)
-		return;
-	shminfo.shmid = shmget(IPC_PRIVATE, screen->h*screen->pitch,
-			       IPC_CREAT | 0777);
-	if ( shminfo.shmid >= 0 ) {
-		shminfo.shmaddr = (char *)shmat(shminfo.shmid, 0, 0);
-		shminfo.readOnly = False;
-		if ( shminfo.shmaddr != (char *)-1 ) {
+	info->shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0777);
+	if ( info->shmid >= 0 ) {
+		info->shmaddr = (char *)shmat(info->shmid, 0, 0);
+		info->readOnly = False;
+		if ( info->shmaddr != (char *)-1 ) {
 			shm_error = False;
 			X_handler = XSetErrorHandler(shm_errhandler);
-			XShmAttach(SDL_Display, &shminfo);
+			XShmAttach(SDL_Display, info);
 			XSync(SDL_Display, False);
 			XSetErrorHandler(X_handler);
 			if ( shm_error )
-				shmdt(shminfo.shmaddr);
+				shmdt(info->shmaddr);
 		} else {
 			shm_error = True;
 		}
-		shmctl(shminfo.shmid, IPC_RMID, NULL);
+		shmctl(info->shmid, IPC_RMID, NULL);
 	} else {
 		shm_error = True;
 	}
-	if ( shm_error )
+	return(shm_error ? -1 : 0);
+}
+
+static void detach_mitshm(_THIS, XShmSegmentInfo *info)
+{
+	XShmDetach(SDL_Display, info);
+	XSync(SDL_Display, False);
+	shmdt(info->shmaddr);
+}
+
+/* The screen is drawn straight into one of two shared memory images, or
+   as many as SDL_VIDEO_X11_SHMIMAGES asks for.  When it is updated, the
+   application moves on to an image the X server isn't reading, so it can
+   draw the next frame while the previous one is still being displayed.
+ */
+static void try_mitshm(_THIS, SDL_Surface *screen)
+{
+	const char *env;
+	int i;
+
+	/* Dynamic X11 may not have SHM entry points on this box. */
+	if ((use_mitshm) && (!SDL_X11_HAVE_SHM))
+		use_mitshm = 0;
+
+	num_shmimages = 0;
+	if(!use_mitshm)
+		return;
+
+	env = SDL_getenv("SDL_VIDEO_X11_SHMIMAGES");
+	if ( env ) {
+		i = SDL_atoi(env);
+	} else {
+		i = 2;
+	}
+	if ( i < 1 ) {
+		i = 1;
+	} else if ( i > SDL_X11_MAX_SHMIMAGES ) {
+		i = SDL_X11_MAX_SHMIMAGES;
+	}
+	while ( num_shmimages < i ) {
+		XShmSegmentInfo *info = &shmimages[num_shmimages].shminfo;
+
+		if ( attach_mitshm(this, info, screen->h*screen->pitch) < 0 ) {
+			break;
+		}
+		shmimages[num_shmimages].image = XShmCreateImage(GFX_Display,
+					SDL_Visual, this->hidden->depth, ZPixmap,
+					info->shmaddr, info, screen->w, screen->h);
+		if ( shmimages[num_shmimages].image == NULL ) {
+			detach_mitshm(this, info);
+			break;
+		}
+		shmimages[num_shmimages].busy = 0;
+		shmimages[num_shmimages].num_dirty = 0;
+		++num_shmimages;
+	}
+	if ( num_shmimages == 0 ) {
 		use_mitshm = 0;
-	if ( use_mitshm )
-		screen->pixels = shminfo.shmaddr;
+		return;
+	}
+	current_shmimage = 0;
+	shm_completion = XShmGetEventBase(GFX_Display) + ShmCompletion;
+}
+
+/* Mark an image as free when the X server is done reading it */
+static void X11_ShmCompleted(_THIS, XEvent *event)
+{
+	XShmCompletionEvent *completion = (XShmCompletionEvent *)event;
+	int i;
+
+	for ( i = 0; i < num_shmimages; ++i ) {
+		if ( shmimages[i].shminfo.shmseg == completion->shmseg ) {
+			shmimages[i].busy = 0;
+		}
+	}
+}
+
+/* Get an image the X server isn't reading, waiting for one if needed */
+static int X11_GetShmImage(_THIS)
+{
+	XEvent event;
+	int i;
+
+	while ( XCheckTypedEvent(GFX_Display, shm_completion, &event) ) {
+		X11_ShmCompleted(this, &event);
+	}
+	for ( ; ; ) {
+		for ( i = 0; i < num_shmimages; ++i ) {
+			if ( ! shmimages[i].busy ) {
+				return(i);
+			}
+		}
+		/* Nothing else is read from the graphics display */
+		XNextEvent(GFX_Display, &event);
+		if ( event.type == shm_completion ) {
+			X11_ShmCompleted(this, &event);
+		}
+	}
+}
+
+static void X11_DestroyShmImages(_THIS)
+{
+	XEvent event;
+	int i;
+
+	/* Let the X server finish reading before the images go away */
+	XSync(GFX_Display, False);
+	while ( XCheckTypedEvent(GFX_Display, shm_completion, &event) ) {
+		/* Nothing to do, all the images are being freed */;
+	}
+	for ( i = 0; i < num_shmimages; ++i ) {
+		XDestroyImage(shmimages[i].image);
+		detach_mitshm(this, &shmimages[i].shminfo);
+		shmimages[i].image = NULL;
+	}
+	num_shmimages = 0;
 }
 #endif /* ! NO_SHARED_MEMORY */
 
@@ -85,44 +190,36 @@ int X11_SetupImage(_THIS, SDL_Surface *screen)
 {
 #ifndef NO_SHARED_MEMORY
 	try_mitshm(this, screen);
-	if(use_mitshm) {
-		SDL_Ximage = XShmCreateImage(SDL_Display, SDL_Visual,
-					     this->hidden->depth, ZPixmap,
-					     shminfo.shmaddr, &shminfo, 
-					     screen->w, screen->h);
-		if(!SDL_Ximage) {
-			XShmDetach(SDL_Display, &shminfo);
-			XSync(SDL_Display, False);
-			shmdt(shminfo.shmaddr);
-			screen->pixels = NULL;
-			goto error;
-		}
+	if ( use_mitshm ) {
+		SDL_Ximage = shmimages[0].image;
+		screen->pixels = shmimages[0].shminfo.shmaddr;
+		screen->pitch = SDL_Ximage->bytes_per_line;
 		this->UpdateRects = X11_MITSHMUpdate;
+		return(0);
 	}
-	if(!use_mitshm)
 #endif /* not NO_SHARED_MEMORY */
-	{
-		screen->pixels = SDL_malloc(screen->h*screen->pitch);
-		if ( screen->pixels == NULL ) {
-			SDL_OutOfMemory();
-			return -1;
-		}
-		SDL_Ximage = XCreateImage(SDL_Display, SDL_Visual,
-					  this->hidden->depth, ZPixmap, 0,
-					  (char *)screen->pixels, 
-					  screen->w, screen->h,
-					  32, 0);
-		if ( SDL_Ximage == NULL )
-			goto error;
-		/* XPutImage will convert byte sex automatically */
-		SDL_Ximage->byte_order = (SDL_BYTEORDER == SDL_BIG_ENDIAN)
-			                 ? MSBFirst : LSBFirst;
-		this->UpdateRects = X11_NormalUpdate;
+	screen->pixels = SDL_malloc(screen->h*screen->pitch);
+	if ( screen->pixels == NULL ) {
+		SDL_OutOfMemory();
+		return -1;
 	}
+	SDL_Ximage = XCreateImage(SDL_Display, SDL_Visual,
+				  this->hidden->depth, ZPixmap, 0,
+				  (char *)screen->pixels, 
+				  screen->w, screen->h,
+				  32, 0);
+	if ( SDL_Ximage == NULL )
+		goto error;
+	/* XPutImage will convert byte sex automatically */
+	SDL_Ximage->byte_order = (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+		                 ? MSBFirst : LSBFirst;
+	this->UpdateRects = X11_NormalUpdate;
 	screen->pitch = SDL_Ximage->bytes_per_line;
 	return(0);
 
 error:
+	SDL_free(screen->pixels);
+	screen->pixels = NULL;
 	SDL_SetError("Couldn't create XImage");
 	return 1;
 }
@@ -130,13 +227,13 @@ error:
 void X11_DestroyImage(_THIS, SDL_Surface *screen)
 {
 	if ( SDL_Ximage ) {
-		XDestroyImage(SDL_Ximage);
 #ifndef NO_SHARED_MEMORY
-		if ( use_mitshm ) {
-			XShmDetach(SDL_Display, &shminfo);
-			XSync(SDL_Display, False);
-			shmdt(shminfo.shmaddr);
-		}
+		/* Shared memory images are freed together */
+		if ( num_shmimages == 0 )
+#endif /* ! NO_SHARED_MEMORY */
+			XDestroyImage(SDL_Ximage);
+#ifndef NO_SHARED_MEMORY
+		X11_DestroyShmImages(this);
 #endif /* ! NO_SHARED_MEMORY */
 		SDL_Ximage = NULL;
 	}
@@ -250,25 +347,108 @@ static void X11_NormalUpdate(_THIS, int numrects, SDL_Rect *rects)
 	}
 }
 
+#ifndef NO_SHARED_MEMORY
+/* Note that an image missed the rectangles of an update */
+static void X11_AddShmDirty(_THIS, int which, int numrects, SDL_Rect *rects)
+{
+	SDL_Rect *dirty = shmimages[which].dirty;
+	int i, x1, y1, x2, y2;
+
+	for ( i = 0; i < numrects; ++i ) {
+		if ( rects[i].w == 0 || rects[i].h == 0 ) {
+			continue;
+		}
+		if ( shmimages[which].num_dirty < SDL_X11_MAX_SHMDIRTY ) {
+			dirty[shmimages[which].num_dirty++] = rects[i];
+			continue;
+		}
+		/* Out of room, the last rectangle grows to cover this one */
+		dirty += SDL_X11_MAX_SHMDIRTY-1;
+		x1 = SDL_min(dirty->x, rects[i].x);
+		y1 = SDL_min(dirty->y, rects[i].y);
+		x2 = SDL_max(dirty->x+dirty->w, rects[i].x+rects[i].w);
+		y2 = SDL_max(dirty->y+dirty->h, rects[i].y+rects[i].h);
+		dirty->x = x1;
+		dirty->y = y1;
+		dirty->w = x2 - x1;
+		dirty->h = y2 - y1;
+		dirty = shmimages[which].dirty;
+	}
+}
+
+/* Bring an image up to date with the one the application drew into */
+static void X11_CatchUpShmImage(_THIS, int which, XImage *from)
+{
+	SDL_Surface *screen = this->screen;
+	XImage *image = shmimages[which].image;
+	SDL_Rect *dirty = shmimages[which].dirty;
+	Uint8 *src, *dst;
+	int i, row, len, bpp;
+
+	bpp = screen->format->BytesPerPixel;
+	for ( i = 0; i < shmimages[which].num_dirty; ++i ) {
+		len = dirty[i].w * bpp;
+		src = (Uint8 *)from->data + dirty[i].y * from->bytes_per_line +
+				dirty[i].x * bpp;
+		dst = (Uint8 *)image->data + dirty[i].y * image->bytes_per_line +
+				dirty[i].x * bpp;
+		for ( row = dirty[i].h; row > 0; --row ) {
+			SDL_memcpy(dst, src, len);
+			src += from->bytes_per_line;
+			dst += image->bytes_per_line;
+		}
+	}
+	shmimages[which].num_dirty = 0;
+}
+#endif /* ! NO_SHARED_MEMORY */
+
 static void X11_MITSHMUpdate(_THIS, int numrects, SDL_Rect *rects)
 {
 #ifndef NO_SHARED_MEMORY
-	int i;
+	XImage *image;
+	int i, last, which;
+
+	/* Find the last rectangle, which asks for the completion event */
+	for ( last = numrects-1; last >= 0; --last ) {
+		if ( rects[last].w != 0 && rects[last].h != 0 ) {
+			break;
+		}
+	}
+	if ( last < 0 ) {
+		return;
+	}
 
-	for ( i=0; i<numrects; ++i ) {
+	/* Send the image the application drew into, the X server tells us
+	   when it's done reading, so we never sync.
+	 */
+	which = current_shmimage;
+	image = shmimages[which].image;
+	for ( i=0; i<=last; ++i ) {
 		if ( rects[i].w == 0 || rects[i].h == 0 ) { /* Clipped? */
 			continue;
 		}
-		XShmPutImage(GFX_Display, SDL_Window, SDL_GC, SDL_Ximage,
+		XShmPutImage(GFX_Display, SDL_Window, SDL_GC, image,
 				rects[i].x, rects[i].y,
 				rects[i].x, rects[i].y, rects[i].w, rects[i].h,
-									False);
+								(i == last));
 	}
-	if ( SDL_VideoSurface->flags & SDL_ASYNCBLIT ) {
-		XFlush(GFX_Display);
-		blit_queued = 1;
-	} else {
-		XSync(GFX_Display, False);
+	shmimages[which].busy = 1;
+	XFlush(GFX_Display);
+	for ( i = 0; i < num_shmimages; ++i ) {
+		if ( i != which ) {
+			X11_AddShmDirty(this, i, last+1, rects);
+		}
+	}
+
+	/* The application draws on in a free image, which only has to catch
+	   up on the rectangles updated since it was last drawn into.  With a
+	   single image, this waits until the X server is done with it.
+	 */
+	current_shmimage = X11_GetShmImage(this);
+	if ( current_shmimage != which ) {
+		X11_CatchUpShmImage(this, current_shmimage, image);
+		SDL_Ximage = shmimages[current_shmimage].image;
+		this->screen->pixels = SDL_Ximage->data;
 	}
 #endif /* ! NO_SHARED_MEMORY */
 }
@@ -300,6 +480,7 @@ void X11_RefreshDisplay(_THIS)
 		SDL_PrivateExpose();
 		return;
 	}
+	/* The image the application draws into is always up to date */
 #ifndef NO_SHARED_MEMORY
 	if ( this->UpdateRects == X11_MITSHMUpdate ) {
 		XShmPutImage(SDL_Display, SDL_Window, SDL_GC, SDL_Ximage,
@@ -742,8 +742,10 @@ static void X11_DestroyWindow(_THIS, SDL_Surface *screen)
 			X11_LeaveFullScreen(this);
 		}
 
-		/* Destroy the output window */
+		/* Destroy the output window, after the X server is
+		   done with screen updates sent through GFX_Display */
 		if ( SDL_Window ) {
+			XSync(GFX_Display, False);
 			XDestroyWindow(SDL_Display, SDL_Window);
 		}
 
@@ -49,6 +49,12 @@
 
 #include "SDL_x11dyn.h"
 
+/* The most shared memory images the screen is displayed through */
+#define SDL_X11_MAX_SHMIMAGES	3
+
+/* The most rectangles an image remembers it is behind on */
+#define SDL_X11_MAX_SHMDIRTY	16
+
 /* Hidden "this" pointer for the video functions */
 #define _THIS	SDL_VideoDevice *this
 
@@ -74,7 +80,16 @@ struct SDL_PrivateVideoData {
 #ifndef NO_SHARED_MEMORY
     /* MIT shared memory extension information */
     int use_mitshm;
-    XShmSegmentInfo shminfo;
+    struct {
+        XImage *image;
+        XShmSegmentInfo shminfo;
+        int busy;		/* Flag: the X server may still be reading it */
+        SDL_Rect dirty[SDL_X11_MAX_SHMDIRTY];	/* Updated in the others */
+        int num_dirty;
+    } shmimages[SDL_X11_MAX_SHMIMAGES];
+    int num_shmimages;
+    int current_shmimage;	/* The image the application draws into */
+    int shm_completion;		/* The ShmCompletion event type */
 #endif
 
     /* The variables used for displaying graphics */
@@ -173,7 +188,10 @@ struct SDL_PrivateVideoData {
 #define SDL_windowid		(this->hidden->SDL_windowid)
 #define using_dga		(this->hidden->using_dga)
 #define use_mitshm		(this->hidden->use_mitshm)
-#define shminfo			(this->hidden->shminfo)
+#define shmimages		(this->hidden->shmimages)
+#define num_shmimages		(this->hidden->num_shmimages)
+#define current_shmimage	(this->hidden->current_shmimage)
+#define shm_completion		(this->hidden->shm_completion)
 #define SDL_Ximage		(this->hidden->Ximage)
 #define SDL_GC			(this->hidden->gc)
 #define window_w		(this->hidden->window_w)
@@ -0,0 +1,116 @@
+
+/* Test the asynchronous loading of bitmaps, sounds and data */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_asyncload.h"
+
+#define NUM_LOADS	8
+
+static int completed = 0;
+
+static void SDLCALL Completed(SDL_AsyncLoad *load, void *userdata)
+{
+	printf("%s completed with status %d\n",
+			(const char *)userdata, SDL_GetAsyncStatus(load));
+	++completed;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_AsyncRequest request;
+	SDL_AsyncLoad *loads[NUM_LOADS];
+	SDL_Surface *surface;
+	SDL_AudioSpec spec;
+	Uint8 *audio_buf;
+	Uint32 audio_len;
+	SDL_Event event;
+	void *data;
+	int i, size, events;
+
+	/* Load the SDL library */
+	if ( SDL_Init(SDL_INIT_VIDEO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n",SDL_GetError());
+		return(1);
+	}
+
+	/* Queue bitmaps with increasing priority */
+	SDL_memset(&request, 0, sizeof(request));
+	request.callback = Completed;
+	for ( i = 0; i < NUM_LOADS; ++i ) {
+		request.file = (i % 2) ? "sample.bmp" : "icon.bmp";
+		request.userdata = (void *)request.file;
+		request.priority = i;
+		loads[i] = SDL_LoadBMPAsync(&request);
+		if ( loads[i] == NULL ) {
+			fprintf(stderr, "Couldn't queue load: %s\n", SDL_GetError());
+			SDL_Quit();
+			return(1);
+		}
+	}
+	if ( SDL_CancelAsync(loads[0]) == 0 ) {
+		printf("Canceled the lowest priority load\n");
+	}
+	for ( i = 0; i < NUM_LOADS; ++i ) {
+		if ( SDL_WaitAsync(loads[i]) == SDL_ASYNC_DONE ) {
+			surface = SDL_GetAsyncSurface(loads[i]);
+			printf("Loaded %dx%d bitmap\n", surface->w, surface->h);
+			SDL_FreeSurface(surface);
+		}
+		SDL_FreeAsync(loads[i]);
+	}
+	printf("%d loads completed\n", completed);
+
+	/* Load a sound, converted, with a completion event */
+	SDL_memset(&request, 0, sizeof(request));
+	request.file = "sample.wav";
+	request.event = SDL_USEREVENT;
+	SDL_memset(&spec, 0, sizeof(spec));
+	spec.format = AUDIO_S16SYS;
+	spec.channels = 2;
+	spec.freq = 44100;
+	request.spec = &spec;
+	loads[0] = SDL_LoadWAVAsync(&request);
+
+	/* And a missing file, which should fail */
+	request.file = "nonexistent.dat";
+	request.event = SDL_USEREVENT;
+	loads[1] = SDL_LoadFileAsync(&request);
+
+	for ( events = 0; events < 2; ) {
+		if ( !SDL_PollEvent(&event) ) {
+			SDL_Delay(10);
+			continue;
+		}
+		if ( event.type != SDL_USEREVENT ) {
+			continue;
+		}
+		++events;
+		if ( event.user.data1 == loads[0] ) {
+			if ( SDL_GetAsyncWAV(loads[0], &spec, &audio_buf, &audio_len) ) {
+				printf("Loaded %u bytes of audio at %d Hz\n",
+						audio_len, spec.freq);
+				SDL_FreeWAV(audio_buf);
+			} else {
+				printf("Couldn't load sample.wav: %s\n",
+						SDL_GetAsyncError(loads[0]));
+			}
+		} else {
+			data = SDL_GetAsyncData(loads[1], &size);
+			if ( data ) {
+				printf("Unexpectedly loaded %d bytes\n", size);
+				SDL_free(data);
+			} else {
+				printf("Expected failure: %s\n",
+						SDL_GetAsyncError(loads[1]));
+			}
+		}
+	}
+	SDL_FreeAsync(loads[0]);
+	SDL_FreeAsync(loads[1]);
+
+	SDL_Quit();
+	return(0);
+}
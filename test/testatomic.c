@@ -0,0 +1,87 @@
+
+/* Test the atomic operations and spinlocks */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_atomic.h"
+
+#define NUM_THREADS	4
+#define NUM_ITERATIONS	100000
+
+static SDL_atomic_t counter;
+static SDL_SpinLock lock;
+static int locked_counter;
+
+static int SDLCALL Adder(void *data)
+{
+	int i;
+
+	for ( i = 0; i < NUM_ITERATIONS; ++i ) {
+		SDL_AtomicIncRef(&counter);
+
+		SDL_AtomicLock(&lock);
+		++locked_counter;
+		SDL_AtomicUnlock(&lock);
+	}
+	return(0);
+}
+
+static int check(const char *what, int ok)
+{
+	printf("%s: %s\n", what, ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Thread *threads[NUM_THREADS];
+	SDL_atomic_t a;
+	void *ptr;
+	int i, failed;
+
+	failed = 0;
+
+	/* Basic operations from a single thread */
+	SDL_AtomicStore(&a, 5);
+	failed += check("AtomicGet", SDL_AtomicGet(&a) == 5);
+	failed += check("AtomicSet", SDL_AtomicSet(&a, 10) == 5 &&
+					SDL_AtomicGet(&a) == 10);
+	failed += check("AtomicAdd", SDL_AtomicAdd(&a, 10) == 10 &&
+					SDL_AtomicGet(&a) == 20);
+	failed += check("AtomicCAS", SDL_AtomicCAS(&a, 20, 1) &&
+					!SDL_AtomicCAS(&a, 20, 2) &&
+					SDL_AtomicGet(&a) == 1);
+	failed += check("AtomicDecRef", SDL_AtomicDecRef(&a) &&
+					SDL_AtomicGet(&a) == 0);
+	ptr = NULL;
+	failed += check("AtomicCASPtr", SDL_AtomicCASPtr(&ptr, NULL, &a) &&
+					!SDL_AtomicCASPtr(&ptr, NULL, &ptr) &&
+					SDL_AtomicGetPtr(&ptr) == &a);
+	failed += check("AtomicSetPtr", SDL_AtomicSetPtr(&ptr, NULL) == &a &&
+					SDL_AtomicGetPtr(&ptr) == NULL);
+	failed += check("AtomicTryLock", SDL_AtomicTryLock(&lock) &&
+					!SDL_AtomicTryLock(&lock));
+	SDL_AtomicUnlock(&lock);
+
+	/* Contention between several threads */
+	SDL_AtomicStore(&counter, 0);
+	for ( i = 0; i < NUM_THREADS; ++i ) {
+		threads[i] = SDL_CreateThread(Adder, NULL);
+		if ( threads[i] == NULL ) {
+			fprintf(stderr, "Couldn't create thread: %s\n",
+							SDL_GetError());
+			return(1);
+		}
+	}
+	for ( i = 0; i < NUM_THREADS; ++i ) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+	failed += check("Threaded AtomicAdd",
+		SDL_AtomicGet(&counter) == NUM_THREADS*NUM_ITERATIONS);
+	failed += check("Threaded AtomicLock",
+		locked_counter == NUM_THREADS*NUM_ITERATIONS);
+
+	return(failed ? 1 : 0);
+}
@@ -0,0 +1,93 @@
+
+/* Record a few seconds of audio, and play it back
+
+   Usage: testaudiocapture [device]
+
+   With SDL_AUDIODRIVER=disk, the audio is read from the 'device' file,
+   or the file named by SDL_DISKAUDIOFILEIN.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_audio.h"
+
+#define RECORD_SECONDS	3
+
+static Uint8 *sound;
+static Uint32 soundlen;
+static Uint32 soundpos;
+
+static void SDLCALL record(void *unused, Uint8 *stream, int len)
+{
+	if ( (Uint32)len > (soundlen - soundpos) ) {
+		len = soundlen - soundpos;
+	}
+	SDL_memcpy(sound + soundpos, stream, len);
+	soundpos += len;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_AudioSpec spec;
+	SDL_AudioDeviceID dev;
+	Uint32 recorded;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	SDL_memset(&spec, 0, sizeof(spec));
+	spec.freq = 22050;
+	spec.format = AUDIO_S16SYS;
+	spec.channels = 1;
+	spec.samples = 1024;
+	spec.callback = record;
+	soundlen = spec.freq * 2 * RECORD_SECONDS;
+	sound = (Uint8 *)SDL_malloc(soundlen);
+	if ( sound == NULL ) {
+		fprintf(stderr, "Out of memory\n");
+		SDL_Quit();
+		return(1);
+	}
+
+	/* The captured audio is converted to the format asked for */
+	dev = SDL_OpenAudioCaptureDevice(argc > 1 ? argv[1] : NULL, &spec, NULL);
+	if ( dev == 0 ) {
+		fprintf(stderr, "Couldn't open capture device: %s\n",
+							SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+	printf("Recording for %d seconds...\n", RECORD_SECONDS);
+	SDL_PauseAudioDevice(dev, 0);
+	while ( (soundpos < soundlen) &&
+		(SDL_GetAudioDeviceStatus(dev) == SDL_AUDIO_PLAYING) ) {
+		SDL_Delay(100);
+	}
+	SDL_CloseAudioDevice(dev);
+	recorded = soundpos;
+	printf("Recorded %u bytes\n", (unsigned int)recorded);
+
+	/* Play it back through the default output, queueing it all at once */
+	spec.callback = NULL;
+	dev = SDL_OpenAudioDevice(NULL, &spec, NULL);
+	if ( (dev == 0) || (SDL_QueueAudio(dev, sound, recorded) < 0) ) {
+		fprintf(stderr, "Couldn't play audio: %s\n", SDL_GetError());
+		SDL_free(sound);
+		SDL_Quit();
+		return(1);
+	}
+	printf("Playing back...\n");
+	SDL_PauseAudioDevice(dev, 0);
+	while ( SDL_GetQueuedAudioSize(dev) > 0 ) {
+		SDL_Delay(100);
+	}
+	SDL_CloseAudioDevice(dev);
+
+	SDL_free(sound);
+	SDL_Quit();
+	return(0);
+}
@@ -255,6 +255,8 @@ static int setup_test(int argc, char **argv)
             screenSurface = 1;
         else if (strcmp(arg, "--dumpfile") == 0)
             dumpfile = argv[++i];
+        else if (strcmp(arg, "--cpumask") == 0)
+            SDL_SetCPUFeatureMask(atoi_hex(argv[++i]));
         /* !!! FIXME: set colorkey. */
         else if (0)  /* !!! FIXME: we handle some commandlines elsewhere now */
         {
@@ -371,6 +373,7 @@ static void test_blit_speed(void)
     int isScreen = (SDL_GetVideoSurface() == dest);
     SDL_Event event;
 
+    printf("Blitting with %s\n", SDL_GetBlitName(src, dest));
     printf("Testing blit speed for %d seconds...\n", testSeconds);
 
     now = SDL_GetTicks();
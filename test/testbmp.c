@@ -0,0 +1,248 @@
+/* Test loading palettized and RLE compressed BMP files */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define BMP_WIDTH	13
+#define BMP_HEIGHT	7
+
+/* Compression types in the BMP header */
+#define BI_RGB		0
+#define BI_RLE8		1
+#define BI_RLE4		2
+
+static Uint8 *PutLE16(Uint8 *p, Uint16 value)
+{
+	*p++ = (Uint8)(value & 0xFF);
+	*p++ = (Uint8)(value >> 8);
+	return(p);
+}
+
+static Uint8 *PutLE32(Uint8 *p, Uint32 value)
+{
+	p = PutLE16(p, (Uint16)(value & 0xFFFF));
+	p = PutLE16(p, (Uint16)(value >> 16));
+	return(p);
+}
+
+/* Build a bottom-up BMP file with biClrUsed left at 0, so the loader has
+   to work out the size of the color table.  Only 'ncolors' entries of it
+   are written, fewer than the depth allows makes a short color table.
+ */
+static Uint8 *MakeBMP(int bpp, int compression, int ncolors,
+			const Uint8 *indices, int *size)
+{
+	Uint8 *bmp, *p, *bits;
+	int x, y, pitch, offset;
+
+	pitch = ((BMP_WIDTH * bpp + 31) / 32) * 4;
+	offset = 14 + 40 + ncolors * 4;
+	/* The RLE data is at most two bytes a pixel, plus the row ends */
+	*size = offset + (BMP_WIDTH * 2 + 2) * BMP_HEIGHT + 2;
+	bmp = (Uint8 *)SDL_malloc(*size);
+	if ( bmp == NULL ) {
+		return(NULL);
+	}
+
+	/* The color table */
+	p = bmp + 14 + 40;
+	for ( x = 0; x < ncolors; ++x ) {
+		*p++ = (Uint8)(x * 16);
+		*p++ = (Uint8)(255 - x);
+		*p++ = (Uint8)(x * 7);
+		*p++ = 0;
+	}
+
+	/* The pixels, bottom row first */
+	bits = p;
+	for ( y = BMP_HEIGHT-1; y >= 0; --y ) {
+		const Uint8 *row = &indices[y * BMP_WIDTH];
+
+		switch (compression) {
+		    case BI_RLE8:
+			/* Runs of one pixel each */
+			for ( x = 0; x < BMP_WIDTH; ++x ) {
+				*p++ = 1;
+				*p++ = row[x];
+			}
+			*p++ = 0;
+			*p++ = 0;
+			break;
+		    case BI_RLE4:
+			/* Runs of one pixel each, in the high nybble */
+			for ( x = 0; x < BMP_WIDTH; ++x ) {
+				*p++ = 1;
+				*p++ = (Uint8)(row[x] << 4);
+			}
+			*p++ = 0;
+			*p++ = 0;
+			break;
+		    default:
+			SDL_memset(p, 0, pitch);
+			for ( x = 0; x < BMP_WIDTH; ++x ) {
+				int bit = x * bpp;
+				p[bit / 8] |= row[x] << (8 - bpp - (bit % 8));
+			}
+			p += pitch;
+			break;
+		}
+	}
+	if ( compression != BI_RGB ) {
+		/* End of bitmap */
+		*p++ = 0;
+		*p++ = 1;
+	}
+	*size = (int)(p - bmp);
+
+	/* The headers */
+	p = bmp;
+	*p++ = 'B';
+	*p++ = 'M';
+	p = PutLE32(p, *size);
+	p = PutLE32(p, 0);
+	p = PutLE32(p, offset);
+	p = PutLE32(p, 40);
+	p = PutLE32(p, BMP_WIDTH);
+	p = PutLE32(p, BMP_HEIGHT);
+	p = PutLE16(p, 1);
+	p = PutLE16(p, bpp);
+	p = PutLE32(p, compression);
+	p = PutLE32(p, (Uint32)(*size - (bits - bmp)));
+	p = PutLE32(p, 0);
+	p = PutLE32(p, 0);
+	p = PutLE32(p, 0);
+	p = PutLE32(p, 0);
+	return(bmp);
+}
+
+/* Load the file as it is and in a 16 and 32 bpp format, and check that
+   every pixel has the color it was written with.
+ */
+static int TestBMP(const char *name, int bpp, int compression, int ncolors)
+{
+	static const Uint32 masks[2][4] = {
+		{ 0xF800, 0x07E0, 0x001F, 0 },
+		{ 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 }
+	};
+	Uint8 indices[BMP_WIDTH * BMP_HEIGHT];
+	Uint8 *bmp;
+	SDL_Surface *surface, *format, *converted;
+	int size, x, y, i, status;
+
+	for ( i = 0; i < BMP_WIDTH * BMP_HEIGHT; ++i ) {
+		indices[i] = (Uint8)(rand() % ncolors);
+	}
+	bmp = MakeBMP(bpp, compression, ncolors, indices, &size);
+	if ( bmp == NULL ) {
+		fprintf(stderr, "Out of memory\n");
+		return(-1);
+	}
+	status = -1;
+	format = NULL;
+	converted = NULL;
+
+	surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bmp, size), 1);
+	if ( surface == NULL ) {
+		fprintf(stderr, "Couldn't load %s: %s\n", name, SDL_GetError());
+		goto done;
+	}
+	if ( (surface->w != BMP_WIDTH) || (surface->h != BMP_HEIGHT) ||
+	     (surface->format->BitsPerPixel != 8) ||
+	     (surface->format->palette->ncolors < ncolors) ) {
+		fprintf(stderr, "The %s surface is %dx%d %d bpp, %d colors\n",
+			name, surface->w, surface->h,
+			surface->format->BitsPerPixel,
+			surface->format->palette->ncolors);
+		goto done;
+	}
+	for ( y = 0; y < BMP_HEIGHT; ++y ) {
+		const Uint8 *row = (Uint8 *)surface->pixels + y*surface->pitch;
+		for ( x = 0; x < BMP_WIDTH; ++x ) {
+			SDL_Color *color;
+
+			color = &surface->format->palette->colors[row[x]];
+			if ( (row[x] != indices[y * BMP_WIDTH + x]) ||
+			     (color->r != (Uint8)(row[x] * 7)) ||
+			     (color->g != (Uint8)(255 - row[x])) ||
+			     (color->b != (Uint8)(row[x] * 16)) ) {
+				fprintf(stderr, "%s pixel %d,%d is wrong\n",
+								name, x, y);
+				goto done;
+			}
+		}
+	}
+
+	for ( i = 0; i < 2; ++i ) {
+		format = SDL_CreateRGBSurface(SDL_SWSURFACE, 1, 1, 16 + i*16,
+			masks[i][0], masks[i][1], masks[i][2], masks[i][3]);
+		converted = SDL_LoadBMPFormat_RW(SDL_RWFromConstMem(bmp, size),
+						1, format->format, SDL_SWSURFACE);
+		if ( converted == NULL ) {
+			fprintf(stderr, "Couldn't load %s in %d bpp: %s\n",
+				name, format->format->BitsPerPixel,
+				SDL_GetError());
+			goto done;
+		}
+		for ( y = 0; y < BMP_HEIGHT; ++y ) {
+			for ( x = 0; x < BMP_WIDTH; ++x ) {
+				Uint8 *pixel = (Uint8 *)converted->pixels +
+						y*converted->pitch +
+						x*(2 + i*2);
+				Uint8 index = indices[y * BMP_WIDTH + x];
+				Uint32 value, want;
+
+				want = SDL_MapRGB(format->format,
+						(Uint8)(index * 7),
+						(Uint8)(255 - index),
+						(Uint8)(index * 16));
+				if ( i == 0 ) {
+					value = *(Uint16 *)pixel;
+				} else {
+					value = *(Uint32 *)pixel;
+				}
+				if ( value != want ) {
+					fprintf(stderr,
+				"%s pixel %d,%d is wrong in %d bpp\n",
+						name, x, y,
+						format->format->BitsPerPixel);
+					goto done;
+				}
+			}
+		}
+		SDL_FreeSurface(converted);
+		SDL_FreeSurface(format);
+		converted = NULL;
+		format = NULL;
+	}
+	printf("Loaded %s\n", name);
+	status = 0;
+
+done:
+	if ( converted ) {
+		SDL_FreeSurface(converted);
+	}
+	if ( format ) {
+		SDL_FreeSurface(format);
+	}
+	if ( surface ) {
+		SDL_FreeSurface(surface);
+	}
+	SDL_free(bmp);
+	return(status);
+}
+
+int main(int argc, char *argv[])
+{
+	srand(1);
+	if ( (TestBMP("1 bpp", 1, BI_RGB, 2) < 0) ||
+	     (TestBMP("4 bpp", 4, BI_RGB, 16) < 0) ||
+	     (TestBMP("8 bpp", 8, BI_RGB, 256) < 0) ||
+	     (TestBMP("8 bpp, short color table", 8, BI_RGB, 16) < 0) ||
+	     (TestBMP("RLE4", 4, BI_RLE4, 16) < 0) ||
+	     (TestBMP("RLE8", 8, BI_RLE8, 256) < 0) ) {
+		return(1);
+	}
+	return(0);
+}
@@ -138,12 +138,37 @@ static SDL_Cursor *create_arrow_cursor()
   return SDL_CreateCursor(data, mask, 32, 32, hot_x, hot_y);
 }
 
+/* a full colour cursor: a ball fading out towards its edge */
+static SDL_Cursor *create_color_cursor()
+{
+	SDL_Surface *surface;
+	SDL_Cursor *cursor;
+	int x, y;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, 32, 32, 32,
+			0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+	if (surface == NULL) {
+		return NULL;
+	}
+	for (y = 0; y < 32; ++y) {
+		Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y*surface->pitch);
+		for (x = 0; x < 32; ++x) {
+			int d2 = (x-16)*(x-16) + (y-16)*(y-16);
+			Uint32 a = d2 < 256 ? 255 - d2 : 0;
+			row[x] = (a << 24) | ((x*8) << 16) | ((y*8) << 8) | 0xc0;
+		}
+	}
+	cursor = SDL_CreateColorCursor(surface, 16, 16);
+	SDL_FreeSurface(surface);
+	return cursor;
+}
+
 
 int main(int argc, char *argv[])
 {
 	SDL_Surface *screen;
 	SDL_bool quit = SDL_FALSE;
-	SDL_Cursor *cursor[3];
+	SDL_Cursor *cursor[4];
 	int current;
 
 	/* Load the SDL library */
@@ -182,6 +207,13 @@ int main(int argc, char *argv[])
 		return(1);
 	}
 
+	cursor[3] = create_color_cursor();
+	if (cursor[3]==NULL) {
+		fprintf(stderr, "Couldn't initialize colour cursor: %s\n",SDL_GetError());
+		SDL_Quit();
+		return(1);
+	}
+
 	current = 0;
 	SDL_SetCursor(cursor[current]);
 
@@ -190,7 +222,7 @@ int main(int argc, char *argv[])
 		while (SDL_PollEvent(&event)) {
 			switch(event.type) {
 				case SDL_MOUSEBUTTONDOWN:
-					current = (current + 1)%3;
+					current = (current + 1)%4;
 					SDL_SetCursor(cursor[current]);
 					break;
 				case SDL_KEYDOWN:
@@ -210,6 +242,7 @@ int main(int argc, char *argv[])
 	SDL_FreeCursor(cursor[0]);
 	SDL_FreeCursor(cursor[1]);
 	SDL_FreeCursor(cursor[2]);
+	SDL_FreeCursor(cursor[3]);
 
 	SDL_Quit();
 	return(0);
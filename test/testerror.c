@@ -9,6 +9,7 @@
 #include "SDL_thread.h"
 
 static int alive = 0;
+static SDL_TLSID tls;
 
 /* Call this instead of exit(), so we can clean up SDL: atexit() is evil. */
 static void quit(int rc)
@@ -17,8 +18,16 @@ static void quit(int rc)
 	exit(rc);
 }
 
+static void SDLCALL TLSDestructor(void *value)
+{
+	printf("Thread '%s' local storage freed\n", (char *)value);
+}
+
 int SDLCALL ThreadFunc(void *data)
 {
+	/* Set the child thread local storage */
+	SDL_TLSSet(tls, data, TLSDestructor);
+
 	/* Set the child thread error string */
 	SDL_SetError("Thread %s (%d) had a problem: %s",
 			(char *)data, SDL_ThreadID(), "nevermind");
@@ -27,6 +36,7 @@ int SDLCALL ThreadFunc(void *data)
 		SDL_Delay(1*1000);
 	}
 	printf("Child thread error string: %s\n", SDL_GetError());
+	printf("Child thread local storage: %s\n", (char *)SDL_TLSGet(tls));
 	return(0);
 }
 
@@ -40,8 +50,10 @@ int main(int argc, char *argv[])
 		return(1);
 	}
 
-	/* Set the error value for the main thread */
+	/* Set the error value and local storage for the main thread */
 	SDL_SetError("No worries");
+	tls = SDL_TLSCreate();
+	SDL_TLSSet(tls, "main", NULL);
 
 	alive = 1;
 	thread = SDL_CreateThread(ThreadFunc, "#1");
@@ -55,6 +67,7 @@ int main(int argc, char *argv[])
 	SDL_WaitThread(thread, NULL);
 
 	printf("Main thread error string: %s\n", SDL_GetError());
+	printf("Main thread local storage: %s\n", (char *)SDL_TLSGet(tls));
 
 	SDL_Quit();
 	return(0);
@@ -177,6 +177,59 @@ int main(int argc, char *argv[])
 														RWOP_ERR_QUIT(rwops);
 	rwops->close(rwops);
 	printf("test5 OK\n");
+
+/* test6 : memory mapped read only access */
+	rwops = SDL_RWFromMappedFile(FBASENAME2); /* this file doesn't exist that call must fail */
+	if (rwops)											RWOP_ERR_QUIT(rwops);
+	rwops = SDL_RWFromMappedFile(FBASENAME1);
+	if (!rwops)											RWOP_ERR_QUIT(rwops);
+	if (-1 != rwops->write(rwops,"1234567890",10,1) )	RWOP_ERR_QUIT(rwops);
+	if (20+27+7!=rwops->seek(rwops,0L,RW_SEEK_END))	RWOP_ERR_QUIT(rwops);
+	if (0!=rwops->seek(rwops,0L,RW_SEEK_SET))			RWOP_ERR_QUIT(rwops);
+	if (3!=rwops->read(rwops,test_buf,10,3))			RWOP_ERR_QUIT(rwops);
+	if (SDL_memcmp(test_buf,"123456789012345678901234567123",30))
+														RWOP_ERR_QUIT(rwops);
+	{
+		const char *mem;
+		int size;
+
+		mem = (const char *)SDL_RWGetMemory(rwops,&size);
+		if (mem) {
+			if (size != 20+27+7)						RWOP_ERR_QUIT(rwops);
+			if (SDL_memcmp(mem+20,"1234567123",10))		RWOP_ERR_QUIT(rwops);
+		}
+	}
+	rwops->close(rwops);
+	printf("test6 OK\n");
+
+/* test7 : buffered reading, with and without read-ahead */
+	{
+		int readahead;
+		Uint32 values[2];
+
+		for (readahead = 0; readahead < 2; ++readahead) {
+			rwops = SDL_RWFromFile(FBASENAME1,"rb");
+			if (!rwops)										RWOP_ERR_QUIT(rwops);
+			rwops = SDL_RWFromBuffered(rwops,1,8,readahead);
+			if (!rwops)										RWOP_ERR_QUIT(rwops);
+			if (3!=rwops->read(rwops,test_buf,10,3))		RWOP_ERR_QUIT(rwops);
+			if (SDL_memcmp(test_buf,"123456789012345678901234567123",30))
+														RWOP_ERR_QUIT(rwops);
+			if (5!=rwops->seek(rwops,5L,RW_SEEK_SET))		RWOP_ERR_QUIT(rwops);
+			if (1!=rwops->read(rwops,test_buf,5,1))			RWOP_ERR_QUIT(rwops);
+			if (SDL_memcmp(test_buf,"67890",5))				RWOP_ERR_QUIT(rwops);
+			if (12!=rwops->seek(rwops,2,RW_SEEK_CUR))		RWOP_ERR_QUIT(rwops);
+			if (2!=SDL_ReadLE32Array(rwops,values,2))		RWOP_ERR_QUIT(rwops);
+			if (values[0] != 0x36353433)					RWOP_ERR_QUIT(rwops);
+			if (values[1] != 0x30393837)					RWOP_ERR_QUIT(rwops);
+			if (20+27!=rwops->seek(rwops,-7,RW_SEEK_END))	RWOP_ERR_QUIT(rwops);
+			if (7!=rwops->read(rwops,test_buf,1,10))		RWOP_ERR_QUIT(rwops);
+			if (SDL_memcmp(test_buf,"1234567",7))			RWOP_ERR_QUIT(rwops);
+			if (0!=rwops->read(rwops,test_buf,1,1))			RWOP_ERR_QUIT(rwops);
+			rwops->close(rwops);
+		}
+	}
+	printf("test7 OK\n");
 	cleanup();
 	return 0; /* all ok */
 }
@@ -21,6 +21,15 @@ int SDLCALL ThreadFunc(void *data)
 {
 	printf("Started thread %s: My thread id is %u\n",
 				(char *)data, SDL_ThreadID());
+	if ( SDL_SetThreadName((char *)data) < 0 ) {
+		printf("Couldn't name thread: %s\n", SDL_GetError());
+	}
+	if ( SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW) < 0 ) {
+		printf("Couldn't lower priority: %s\n", SDL_GetError());
+	}
+	if ( SDL_SetThreadAffinity(0x1) < 0 ) {
+		printf("Couldn't run on the first CPU: %s\n", SDL_GetError());
+	}
 	while ( alive ) {
 		printf("Thread '%s' is alive!\n", (char *)data);
 		SDL_Delay(1*1000);
@@ -0,0 +1,131 @@
+
+/* Test the job pool: dependencies, nested waits and parallel loops */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_jobs.h"
+
+#define NUM_JOBS	1000
+#define RANGE_SIZE	100000
+
+static SDL_atomic_t count;
+static int order[3];
+static SDL_atomic_t position;
+static SDL_JobPool *pool;
+static unsigned char visited[RANGE_SIZE];
+
+static void SDLCALL CountJob(void *data)
+{
+	SDL_AtomicIncRef(&count);
+}
+
+static void SDLCALL OrderJob(void *data)
+{
+	order[SDL_AtomicAdd(&position, 1)] = (int)(size_t)data;
+}
+
+static void SDLCALL NestedJob(void *data)
+{
+	SDL_Job *jobs[10];
+	int i;
+
+	/* Waiting from inside a job must not deadlock the pool */
+	for ( i = 0; i < 10; ++i ) {
+		jobs[i] = SDL_CreateJob(pool, CountJob, NULL, NULL, 0);
+	}
+	for ( i = 0; i < 10; ++i ) {
+		SDL_WaitJob(jobs[i]);
+		SDL_ReleaseJob(jobs[i]);
+	}
+}
+
+static void SDLCALL VisitRange(void *data, int start, int end)
+{
+	int i;
+
+	for ( i = start; i < end; ++i ) {
+		++visited[i];
+	}
+}
+
+static int check(const char *what, int ok)
+{
+	printf("%s: %s\n", what, ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Job *jobs[NUM_JOBS];
+	SDL_Job *first, *second, *third;
+	int i, ok, failed;
+
+	failed = 0;
+
+	pool = SDL_CreateJobPool(4);
+	if ( pool == NULL ) {
+		fprintf(stderr, "Couldn't create job pool: %s\n",
+						SDL_GetError());
+		return(1);
+	}
+
+	/* Lots of independent jobs */
+	SDL_AtomicStore(&count, 0);
+	for ( i = 0; i < NUM_JOBS; ++i ) {
+		jobs[i] = SDL_CreateJob(pool, CountJob, NULL, NULL, 0);
+	}
+	for ( i = 0; i < NUM_JOBS; ++i ) {
+		SDL_WaitJob(jobs[i]);
+		SDL_ReleaseJob(jobs[i]);
+	}
+	failed += check("Independent jobs", SDL_AtomicGet(&count) == NUM_JOBS);
+
+	/* A chain of dependencies, created in reverse */
+	SDL_AtomicStore(&position, 0);
+	first = SDL_CreateJob(pool, OrderJob, (void *)1, NULL, 0);
+	second = SDL_CreateJob(pool, OrderJob, (void *)2, &first, 1);
+	third = SDL_CreateJob(pool, OrderJob, (void *)3, &second, 1);
+	SDL_WaitJob(third);
+	failed += check("Dependencies", SDL_IsJobDone(first) &&
+					SDL_IsJobDone(second) &&
+					order[0] == 1 && order[1] == 2 &&
+					order[2] == 3);
+	SDL_ReleaseJob(first);
+	SDL_ReleaseJob(second);
+	SDL_ReleaseJob(third);
+
+	/* Jobs waiting for other jobs */
+	SDL_AtomicStore(&count, 0);
+	for ( i = 0; i < 100; ++i ) {
+		jobs[i] = SDL_CreateJob(pool, NestedJob, NULL, NULL, 0);
+	}
+	for ( i = 0; i < 100; ++i ) {
+		SDL_WaitJob(jobs[i]);
+		SDL_ReleaseJob(jobs[i]);
+	}
+	failed += check("Nested waits", SDL_AtomicGet(&count) == 100*10);
+
+	/* Every index of the range is visited exactly once */
+	SDL_ParallelFor(pool, 0, RANGE_SIZE, 0, VisitRange, NULL);
+	SDL_ParallelFor(NULL, 0, RANGE_SIZE, 7, VisitRange, NULL);
+	ok = 1;
+	for ( i = 0; i < RANGE_SIZE; ++i ) {
+		if ( visited[i] != 2 ) {
+			ok = 0;
+		}
+	}
+	failed += check("Parallel for", ok);
+
+	/* Jobs left running are waited for */
+	SDL_AtomicStore(&count, 0);
+	for ( i = 0; i < NUM_JOBS; ++i ) {
+		SDL_ReleaseJob(SDL_CreateJob(pool, CountJob, NULL, NULL, 0));
+	}
+	SDL_DestroyJobPool(pool);
+	failed += check("Destroy pool", SDL_AtomicGet(&count) == NUM_JOBS);
+
+	SDL_Quit();
+	return(failed ? 1 : 0);
+}
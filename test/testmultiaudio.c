@@ -0,0 +1,136 @@
+
+/* Play a different tone on two audio devices at the same time
+
+   Usage: testmultiaudio [device] [device]
+
+   The device names depend on the audio driver, for example ALSA PCM
+   names, or output files with SDL_AUDIODRIVER=disk.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SDL.h"
+#include "SDL_audio.h"
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+#define NUM_DEVICES	2
+
+struct {
+	SDL_AudioDeviceID id;
+	SDL_AudioSpec spec;
+	double pitch;
+	double phase;
+	Uint32 frames;
+} devices[NUM_DEVICES];
+
+static void SDLCALL fill_tone(void *userdata, Uint8 *stream, int len)
+{
+	int dev = (int)(size_t)userdata;
+	Sint16 *samples = (Sint16 *)stream;
+	int i, c, channels;
+	double step;
+
+	channels = devices[dev].spec.channels;
+	step = (2.0 * M_PI * devices[dev].pitch) / devices[dev].spec.freq;
+	len /= 2 * channels;
+	for ( i = 0; i < len; ++i ) {
+		Sint16 sample = (Sint16)(sin(devices[dev].phase) * 8000.0);
+		for ( c = 0; c < channels; ++c ) {
+			*samples++ = sample;
+		}
+		devices[dev].phase += step;
+	}
+	devices[dev].frames += len;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_AudioSpec desired;
+	int i, failed;
+
+	if ( SDL_Init(SDL_INIT_AUDIO) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	for ( i = 0; i < NUM_DEVICES; ++i ) {
+		const char *name = (i+1 < argc) ? argv[i+1] : NULL;
+
+		devices[i].pitch = 440.0 * (i+1);
+		SDL_memset(&desired, 0, sizeof(desired));
+		desired.freq = 22050;
+		desired.format = AUDIO_S16SYS;
+		desired.channels = 2;
+		desired.samples = 1024;
+		desired.callback = fill_tone;
+		desired.userdata = (void *)(size_t)i;
+		devices[i].id = SDL_OpenAudioDevice(name, &desired, NULL);
+		if ( devices[i].id == 0 ) {
+			fprintf(stderr, "Couldn't open audio device %s: %s\n",
+					name ? name : "(default)", SDL_GetError());
+			SDL_Quit();
+			return(1);
+		}
+		devices[i].spec = desired;
+		printf("Opened device %d (%s) playing %g Hz\n", (int)devices[i].id,
+				name ? name : "default", devices[i].pitch);
+	}
+
+	for ( i = 0; i < NUM_DEVICES; ++i ) {
+		SDL_PauseAudioDevice(devices[i].id, 0);
+	}
+	SDL_Delay(2000);
+
+	failed = 0;
+	for ( i = 0; i < NUM_DEVICES; ++i ) {
+		SDL_audiostatus status = SDL_GetAudioDeviceStatus(devices[i].id);
+		SDL_AudioPosition pos;
+		SDL_AudioStats stats;
+		Uint32 frames;
+		int b;
+
+		SDL_LockAudioDevice(devices[i].id);
+		frames = devices[i].frames;
+		SDL_UnlockAudioDevice(devices[i].id);
+		printf("Device %d: %s, %u frames, %u ms played\n",
+			(int)devices[i].id,
+			(status == SDL_AUDIO_PLAYING) ? "playing" : "not playing",
+			(unsigned int)frames,
+			(unsigned int)SDL_GetAudioDeviceTicks(devices[i].id));
+		if ( (status != SDL_AUDIO_PLAYING) || (frames == 0) ) {
+			failed = 1;
+		}
+
+		/* Show the timing the audio thread kept for the device */
+		if ( (SDL_GetAudioDevicePosition(devices[i].id, &pos) < 0) ||
+		     (SDL_GetAudioDeviceStats(devices[i].id, &stats) < 0) ) {
+			fprintf(stderr, "Couldn't get device stats: %s\n",
+							SDL_GetError());
+			failed = 1;
+		} else {
+			printf("  playing frame %u, %u frames of latency\n",
+				(unsigned int)pos.position,
+				(unsigned int)pos.latency);
+			printf("  %u buffers, %u late, %u underruns, callback max %u us of %u us\n",
+				(unsigned int)stats.buffers,
+				(unsigned int)stats.late,
+				(unsigned int)stats.underruns,
+				(unsigned int)stats.callback_max_us,
+				(unsigned int)stats.budget_us);
+			printf("  callback time histogram:");
+			for ( b = 0; b < SDL_AUDIO_STATS_BUCKETS; ++b ) {
+				printf(" %u", (unsigned int)stats.histogram[b]);
+			}
+			printf("\n");
+		}
+		SDL_CloseAudioDevice(devices[i].id);
+	}
+
+	SDL_Quit();
+	return(failed);
+}
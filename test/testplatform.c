@@ -136,6 +136,17 @@ int TestCPUInfo(SDL_bool verbose)
 		printf("SSE %s\n", SDL_HasSSE() ? "detected" : "not detected");
 		printf("SSE2 %s\n", SDL_HasSSE2() ? "detected" : "not detected");
 		printf("AltiVec %s\n", SDL_HasAltiVec() ? "detected" : "not detected");
+		printf("SSE3 %s\n", SDL_HasSSE3() ? "detected" : "not detected");
+		printf("SSSE3 %s\n", SDL_HasSSSE3() ? "detected" : "not detected");
+		printf("SSE4.1 %s\n", SDL_HasSSE41() ? "detected" : "not detected");
+		printf("SSE4.2 %s\n", SDL_HasSSE42() ? "detected" : "not detected");
+		printf("AVX %s\n", SDL_HasAVX() ? "detected" : "not detected");
+		printf("AVX2 %s\n", SDL_HasAVX2() ? "detected" : "not detected");
+		printf("FMA %s\n", SDL_HasFMA() ? "detected" : "not detected");
+		printf("AVX-512F %s\n", SDL_HasAVX512F() ? "detected" : "not detected");
+		printf("CPU count: %d\n", SDL_GetCPUCount());
+		printf("Cache line size: %d bytes\n", SDL_GetCPUCacheLineSize());
+		printf("System RAM: %d MB\n", SDL_GetSystemRAM());
 	}
 	return(0);
 }
@@ -0,0 +1,164 @@
+
+/* Test the reader-writer locks, and the try and timed mutex locks */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+
+#define NUM_READERS	4
+#define NUM_ITERATIONS	10000
+
+static SDL_rwlock *rwlock;
+static SDL_mutex *mutex;
+static int shared[2];
+static int torn_reads;
+
+static int SDLCALL Reader(void *data)
+{
+	int i;
+
+	for ( i = 0; i < NUM_ITERATIONS; ++i ) {
+		SDL_LockRWLockForReading(rwlock);
+		if ( shared[0] != shared[1] ) {
+			++torn_reads;
+		}
+		SDL_UnlockRWLock(rwlock);
+	}
+	return(0);
+}
+
+static int SDLCALL Writer(void *data)
+{
+	int i;
+
+	for ( i = 0; i < NUM_ITERATIONS; ++i ) {
+		SDL_LockRWLockForWriting(rwlock);
+		++shared[0];
+		SDL_Delay(0);
+		++shared[1];
+		SDL_UnlockRWLock(rwlock);
+	}
+	return(0);
+}
+
+static int SDLCALL TryLocker(void *data)
+{
+	int *results = (int *)data;
+
+	results[0] = SDL_TryLockMutex(mutex);
+	if ( results[0] == 0 ) {
+		SDL_mutexV(mutex);
+	}
+	results[1] = SDL_LockMutexTimeout(mutex, 50);
+	if ( results[1] == 0 ) {
+		SDL_mutexV(mutex);
+	}
+	results[2] = SDL_TryLockRWLockForReading(rwlock);
+	if ( results[2] == 0 ) {
+		SDL_UnlockRWLock(rwlock);
+	}
+	results[3] = SDL_TryLockRWLockForWriting(rwlock);
+	if ( results[3] == 0 ) {
+		SDL_UnlockRWLock(rwlock);
+	}
+	return(0);
+}
+
+static int check(const char *what, int ok)
+{
+	printf("%s: %s\n", what, ok ? "passed" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	SDL_Thread *threads[NUM_READERS+1];
+	SDL_cond *cond;
+	int results[4];
+	Uint32 start, elapsed;
+	int i, failed;
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	rwlock = SDL_CreateRWLock();
+	mutex = SDL_CreateMutex();
+	cond = SDL_CreateCond();
+	if ( !rwlock || !mutex || !cond ) {
+		fprintf(stderr, "Couldn't create locks: %s\n", SDL_GetError());
+		return(1);
+	}
+
+	failed = 0;
+
+	/* Several readers at once, but readers exclude writers */
+	failed += check("Shared read locks",
+			SDL_TryLockRWLockForReading(rwlock) == 0 &&
+			SDL_TryLockRWLockForReading(rwlock) == 0 &&
+			SDL_TryLockRWLockForWriting(rwlock) == SDL_MUTEX_TIMEDOUT);
+	SDL_UnlockRWLock(rwlock);
+	SDL_UnlockRWLock(rwlock);
+	failed += check("Exclusive write lock",
+			SDL_TryLockRWLockForWriting(rwlock) == 0 &&
+			SDL_TryLockRWLockForReading(rwlock) == SDL_MUTEX_TIMEDOUT);
+	SDL_UnlockRWLock(rwlock);
+
+	/* Readers never see a half done write */
+	for ( i = 0; i < NUM_READERS; ++i ) {
+		threads[i] = SDL_CreateThread(Reader, NULL);
+	}
+	threads[i] = SDL_CreateThread(Writer, NULL);
+	for ( i = 0; i <= NUM_READERS; ++i ) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+	failed += check("Concurrent readers and writer",
+			torn_reads == 0 && shared[0] == NUM_ITERATIONS);
+
+	/* Locks held by this thread can't be taken by another */
+	SDL_mutexP(mutex);
+	SDL_LockRWLockForWriting(rwlock);
+	start = SDL_GetTicks();
+	SDL_WaitThread(SDL_CreateThread(TryLocker, results), NULL);
+	elapsed = SDL_GetTicks() - start;
+	failed += check("Try lock held mutex",
+			results[0] == SDL_MUTEX_TIMEDOUT);
+	failed += check("Timed lock held mutex",
+			results[1] == SDL_MUTEX_TIMEDOUT && elapsed >= 40);
+	failed += check("Try lock held rwlock",
+			results[2] == SDL_MUTEX_TIMEDOUT &&
+			results[3] == SDL_MUTEX_TIMEDOUT);
+	SDL_UnlockRWLock(rwlock);
+
+	/* Mutexes are recursive, so these succeed from the owning thread */
+	failed += check("Recursive try lock",
+			SDL_TryLockMutex(mutex) == 0 &&
+			SDL_LockMutexTimeout(mutex, 10) == 0);
+	SDL_mutexV(mutex);
+	SDL_mutexV(mutex);
+	SDL_mutexV(mutex);
+
+	/* Free locks are taken right away */
+	SDL_WaitThread(SDL_CreateThread(TryLocker, results), NULL);
+	failed += check("Try lock free locks",
+			results[0] == 0 && results[1] == 0 &&
+			results[2] == 0 && results[3] == 0);
+
+	/* Condition variable timeouts */
+	SDL_mutexP(mutex);
+	start = SDL_GetTicks();
+	i = SDL_CondWaitTimeout(cond, mutex, 100);
+	elapsed = SDL_GetTicks() - start;
+	SDL_mutexV(mutex);
+	failed += check("Condition timeout",
+			i == SDL_MUTEX_TIMEDOUT && elapsed >= 90 && elapsed < 1000);
+
+	SDL_DestroyCond(cond);
+	SDL_DestroyMutex(mutex);
+	SDL_DestroyRWLock(rwlock);
+	SDL_Quit();
+	return(failed ? 1 : 0);
+}
@@ -0,0 +1,206 @@
+/* Test the streaming WAVE decoder against the whole file loader */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define CHUNK_SIZE	1000
+
+/* Encodings of the generated ADPCM files */
+#define MS_ADPCM_CODE	0x0002
+#define IMA_ADPCM_CODE	0x0011
+
+/* Number of blocks in the generated ADPCM files */
+#define ADPCM_BLOCKS	40
+
+static Uint8 *PutLE16(Uint8 *p, Uint16 value)
+{
+	*p++ = (Uint8)(value & 0xFF);
+	*p++ = (Uint8)(value >> 8);
+	return(p);
+}
+
+static Uint8 *PutLE32(Uint8 *p, Uint32 value)
+{
+	p = PutLE16(p, (Uint16)(value & 0xFFFF));
+	p = PutLE16(p, (Uint16)(value >> 16));
+	return(p);
+}
+
+/* Build an ADPCM WAVE file from random samples, with a partial block at
+   the end that both loaders should ignore.
+ */
+static Uint8 *MakeADPCM(int encoding, int channels, int *size)
+{
+	static const Sint16 coeffs[7][2] = {
+		{ 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 },
+		{ 240, 0 }, { 460, -208 }, { 392, -232 }
+	};
+	Uint8 *wav, *p, *block;
+	int blockalign, blockframes, fmtlen, datalen;
+	int i, c;
+
+	blockalign = 256 * channels;
+	if ( encoding == MS_ADPCM_CODE ) {
+		blockframes = (blockalign - 7*channels) * 2 / channels + 2;
+		fmtlen = 18 + 4 + 7*4;
+	} else {
+		blockframes = (blockalign - 4*channels) * 2 / channels + 1;
+		fmtlen = 18 + 2;
+	}
+	datalen = ADPCM_BLOCKS * blockalign + blockalign/2;
+	*size = 12 + 8 + fmtlen + 8 + datalen;
+	wav = (Uint8 *)SDL_malloc(*size);
+	if ( wav == NULL ) {
+		return(NULL);
+	}
+
+	p = wav;
+	SDL_memcpy(p, "RIFF", 4);
+	p = PutLE32(p+4, *size - 8);
+	SDL_memcpy(p, "WAVEfmt ", 8);
+	p = PutLE32(p+8, fmtlen);
+	p = PutLE16(p, encoding);
+	p = PutLE16(p, channels);
+	p = PutLE32(p, 22050);
+	p = PutLE32(p, 22050 * blockalign / blockframes);
+	p = PutLE16(p, blockalign);
+	p = PutLE16(p, 4);
+	p = PutLE16(p, fmtlen - 18);
+	p = PutLE16(p, blockframes);
+	if ( encoding == MS_ADPCM_CODE ) {
+		p = PutLE16(p, 7);
+		for ( i = 0; i < 7; ++i ) {
+			p = PutLE16(p, coeffs[i][0]);
+			p = PutLE16(p, coeffs[i][1]);
+		}
+	}
+	SDL_memcpy(p, "data", 4);
+	p = PutLE32(p+4, datalen);
+
+	/* Random samples behind a valid header in every block */
+	for ( i = 0; i < datalen; ++i ) {
+		p[i] = (Uint8)rand();
+	}
+	for ( block = p; block+blockalign <= p+datalen; block += blockalign ) {
+		for ( c = 0; c < channels; ++c ) {
+			if ( encoding == MS_ADPCM_CODE ) {
+				block[c] = rand() % 7;
+			} else {
+				block[c*4+2] = rand() % 89;
+				block[c*4+3] = 0;
+			}
+		}
+	}
+	return(wav);
+}
+
+/* Stream and seek through a WAVE file, comparing with SDL_LoadWAV_RW() */
+static int TestWAV(const char *name, SDL_RWops *src, SDL_RWops *streamsrc)
+{
+	SDL_AudioSpec wave, spec;
+	Uint8 *audio_buf, *buf;
+	Uint32 audio_len, frames, frame, total;
+	SDL_WAVStream *stream;
+	int framesize, len, i;
+
+	if ( SDL_LoadWAV_RW(src, 1, &wave, &audio_buf, &audio_len) == NULL ) {
+		fprintf(stderr, "Couldn't load %s: %s\n", name, SDL_GetError());
+		if ( streamsrc ) {
+			SDL_RWclose(streamsrc);
+		}
+		return(-1);
+	}
+	stream = SDL_OpenWAVStream_RW(streamsrc, 1, &spec, &frames);
+	if ( stream == NULL ) {
+		fprintf(stderr, "Couldn't open %s: %s\n", name, SDL_GetError());
+		return(-1);
+	}
+	if ( (spec.format != wave.format) || (spec.channels != wave.channels) ||
+	     (spec.freq != wave.freq) ) {
+		fprintf(stderr, "The %s stream has a different audio format\n",
+									name);
+		return(-1);
+	}
+	framesize = ((spec.format & 0xFF)/8)*spec.channels;
+	printf("Streaming %u frames of %d Hz %s audio\n", frames, spec.freq, name);
+	if ( frames*framesize != audio_len ) {
+		fprintf(stderr, "Expected %u bytes, the stream has %u\n",
+					audio_len, frames*framesize);
+		return(-1);
+	}
+
+	/* Read the whole stream in odd sized pieces */
+	buf = (Uint8 *)SDL_malloc(audio_len);
+	total = 0;
+	while ( (len = SDL_ReadWAVStream(stream, buf+total, CHUNK_SIZE)) > 0 ) {
+		total += len;
+	}
+	if ( (len < 0) || (total != audio_len) ||
+	     (SDL_memcmp(buf, audio_buf, audio_len) != 0) ) {
+		fprintf(stderr, "Streamed %s data doesn't match: %s\n",
+						name, SDL_GetError());
+		return(-1);
+	}
+	printf("Streamed data matches\n");
+
+	/* Seek around and check the data at each position */
+	for ( i = 0; i < 100; ++i ) {
+		frame = rand() % frames;
+		if ( SDL_SeekWAVStream(stream, frame) < 0 ) {
+			fprintf(stderr, "Couldn't seek: %s\n", SDL_GetError());
+			return(-1);
+		}
+		len = SDL_ReadWAVStream(stream, buf, 64*framesize);
+		if ( (len <= 0) ||
+		     (SDL_memcmp(buf, audio_buf+frame*framesize, len) != 0) ||
+		     (SDL_TellWAVStream(stream) != frame+len/framesize) ) {
+			fprintf(stderr, "%s data at frame %u doesn't match\n",
+								name, frame);
+			return(-1);
+		}
+	}
+	printf("Seeking works\n");
+
+	SDL_free(buf);
+	SDL_CloseWAVStream(stream);
+	SDL_FreeWAV(audio_buf);
+	return(0);
+}
+
+/* Check a generated ADPCM file, kept in memory */
+static int TestADPCM(const char *name, int encoding, int channels)
+{
+	Uint8 *wav;
+	int size, status;
+
+	wav = MakeADPCM(encoding, channels, &size);
+	if ( wav == NULL ) {
+		fprintf(stderr, "Out of memory\n");
+		return(-1);
+	}
+	status = TestWAV(name, SDL_RWFromConstMem(wav, size),
+				SDL_RWFromConstMem(wav, size));
+	SDL_free(wav);
+	return(status);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *file;
+
+	srand(1);
+	file = (argc > 1) ? argv[1] : "sample.wav";
+	if ( TestWAV(file, SDL_RWFromFile(file, "rb"),
+				SDL_RWFromFile(file, "rb")) < 0 ) {
+		return(1);
+	}
+	if ( (TestADPCM("mono MS ADPCM", MS_ADPCM_CODE, 1) < 0) ||
+	     (TestADPCM("stereo MS ADPCM", MS_ADPCM_CODE, 2) < 0) ||
+	     (TestADPCM("mono IMA ADPCM", IMA_ADPCM_CODE, 1) < 0) ||
+	     (TestADPCM("stereo IMA ADPCM", IMA_ADPCM_CODE, 2) < 0) ) {
+		return(1);
+	}
+	return(0);
+}